@@ -3,54 +3,140 @@
 #include <Wire.h>
 
 #include "AppModes.h"
+#include "Boot.h"
+#include "Connectivity.h"
 #include "Config.h"
+#include "EnvLog.h"
 #include "Globals.h"
 #include "Graphics.h"
 #include "Hardware.h"
 #include "InputManager.h"
+#include "Profiler.h"
+#include "Scheduler.h"
+#include "SensorTask.h"
+#include "SettingsStore.h"
 #include "StateManager.h"
+#include "TimeService.h"
 #include "Types.h"
 
+void checkAlarmRinging() {
+    static bool wasRinging = false;
+    if (ui.alarmRinging && !wasRinging) {
+        Modes::Alarm.setRinging(true);
+        State.switchMode(Modes::Alarm);
+    }
+    wasRinging = ui.alarmRinging;
+}
+
+namespace {
+int bootTask = -1;
+
+// Replays the flash log. Runs after the first frame so the clock shows up
+// first; the graph and values fill in when it is done.
+void bootHistory() {
+    if (Log.begin())
+        restoreHistory();
+    Boot.mark(BOOT_HISTORY);
+    if (ui.currentMode == MODE_CLOCK) {
+        drawHistoryGraph();
+        drawEnvDynamic();
+    }
+}
+
+// Watches the stages that finish on their own and reports once all have.
+void bootPoll() {
+    if (!Boot.done(BOOT_WIFI)) {
+        if (Network.online()) {
+            Boot.mark(BOOT_WIFI);
+        } else if (Network.state() == NET_BACKOFF) {
+            // The first attempt timed out. Network keeps retrying and SNTP
+            // corrects the clock when it gets through.
+            if (!Time.valid())
+                setFallbackTime();
+            Boot.mark(BOOT_WIFI, false);
+        }
+    }
+    if (!Boot.done(BOOT_TIME) && Time.valid())
+        Boot.mark(BOOT_TIME, Network.synced());
+    if (!Boot.done(BOOT_SENSORS) && env.lastRead != 0)
+        Boot.mark(BOOT_SENSORS);
+    if (Boot.complete()) {
+        Boot.print(Serial);
+        Tasks.cancel(bootTask);
+    }
+}
+} // namespace
+
 void setup() {
     Serial.begin(115200);
-    delay(1000);
 
     initHardware();
-    loadSettings();
+    Store.load(settings);
 
     Wire.begin(Pins::I2C_SDA, Pins::I2C_SCL);
     SPI.begin(Pins::TFT_SCLK, -1, Pins::TFT_MOSI, Pins::TFT_CS);
     tft.init(Screen::HEIGHT, Screen::WIDTH);
     tft.setRotation(1);
     tft.invertDisplay(false);
-    UI::clear();
+    Boot.mark(BOOT_DISPLAY);
 
-    checkStartupWiFi();
+    // Everything slow runs in the background from here on
+    Sensors.begin();
+    Network.begin();
+
+    State.switchMode(Modes::Clock);
+    State.update();
+    Boot.mark(BOOT_FIRST_FRAME);
 
-    if (!aht.begin())
-        Serial.println("AHT21 not found");
-    if (!ens160.begin())
-        Serial.println("ENS160 begin FAIL");
-    else
-        ens160.setMode(ENS160_OPMODE_STD);
+    Tasks.after(0, bootHistory, "history");
+    bootTask = Tasks.every("boot", 100, bootPoll);
 
-    State.switchMode(new ClockMode());
+    // Registered before any slot is freed and never cancelled, so these
+    // keep this order within a tick (input before ui); see Scheduler.h.
+    Tasks.every("input", 0, [] {
+        PROFILE_SCOPE(PROF_INPUT);
+        Input.update();
+    });
+    Tasks.every("env", 100, [] {
+        PROFILE_SCOPE(PROF_ENV);
+        updateEnvSensors();
+    });
+    Time.subscribe(AlarmEngine::onTimeJump, TIME_JUMP);
+    Tasks.every("time", 20, [] {
+        PROFILE_SCOPE(PROF_TIME);
+        Time.update();
+        Alarms.check();
+    }, 100);
+    Tasks.every("alerts", 10, [] {
+        PROFILE_SCOPE(PROF_ALERTS);
+        updateAlertStateAndLED();
+    }, 50);
+    Tasks.every("buzzer", 5, [] {
+        PROFILE_SCOPE(PROF_BUZZER);
+        Buzzer.update();
+    }, 5);
+    // The Pomodoro timer runs on while other modes are shown
+    Tasks.every("pomodoro", 100, [] { Modes::Pomodoro.tick(); });
+    Tasks.every("settings", 250, [] { Store.update(); });
+    Tasks.every("net", 250, [] { Network.update(); });
+    Tasks.every("ui", 0, [] {
+        PROFILE_SCOPE(PROF_UI);
+        checkAlarmRinging();
+        State.update();
+    });
+    if (Debug::SCHED_STATS_MS > 0)
+        Tasks.every("stats", Debug::SCHED_STATS_MS,
+                    [] { Tasks.printStats(Serial); });
+#if CYBER_PROFILE
+    if (Debug::PROFILE_OVERLAY)
+        Tasks.every("overlay", 1000, [] { Prof.drawOverlay(); });
+    if (Debug::PROFILE_DUMP_MS > 0)
+        Tasks.every("profile", Debug::PROFILE_DUMP_MS,
+                    [] { Prof.printCsv(Serial); });
+#endif
 }
 
 void loop() {
-    Input.update();
-    checkAlarmTrigger();
-    updateAlertStateAndLED();
-
-    if (ui.alarmRinging) {
-        static bool wasRinging = false;
-        if (!wasRinging) {
-            State.switchMode(new AlarmMode(true));
-            wasRinging = true;
-        }
-        if (!ui.alarmRinging)
-            wasRinging = false;
-    }
-
-    State.update();
+    PROFILE_LOOP();
+    Tasks.tick();
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "AlarmEngine.h"
+#include "Globals.h"
+#include "SettingsStore.h"
+#include "TimeService.h"
+
+AlarmEngine Alarms;
+
+// hour:minute on the date in day. When DST ends that time can occur twice;
+// this is the first. When DST starts it may not occur at all, and mktime
+// moves it past the gap.
+static time_t localTimeOn(const struct tm &day, int hour, int minute) {
+    time_t first = 0;
+    for (int dst = 0; dst <= 1; dst++) {
+        struct tm t = day;
+        t.tm_hour = hour;
+        t.tm_min = minute;
+        t.tm_sec = 0;
+        t.tm_isdst = dst;
+        time_t when = mktime(&t);
+        // With the wrong DST flag mktime lands an hour off
+        struct tm check;
+        localtime_r(&when, &check);
+        if (check.tm_hour == hour && check.tm_min == minute &&
+            (first == 0 || when < first))
+            first = when;
+    }
+    if (first == 0) {
+        struct tm t = day;
+        t.tm_hour = hour;
+        t.tm_min = minute;
+        t.tm_sec = 0;
+        t.tm_isdst = -1;
+        first = mktime(&t);
+    }
+    return first;
+}
+
+time_t AlarmEngine::nextFireFor(const AlarmSpec &a, time_t from) {
+    struct tm base;
+    localtime_r(&from, &base);
+    // Today plus a week covers a weekly alarm whose time today has passed
+    for (int d = 0; d <= 7; d++) {
+        struct tm day = base;
+        day.tm_mday += d;
+        day.tm_hour = 12;
+        day.tm_min = 0;
+        day.tm_sec = 0;
+        day.tm_isdst = -1;
+        // Normalises the date and fills in tm_wday
+        mktime(&day);
+        if (a.days != 0 && !(a.days & (1 << day.tm_wday)))
+            continue;
+        // Once a day: if the first of a repeated time has passed, so has
+        // the day's alarm
+        time_t when = localTimeOn(day, a.hour, a.minute);
+        if (when > from)
+            return when;
+    }
+    return 0;
+}
+
+void AlarmEngine::onTimeJump(uint8_t events) { Alarms.stale = true; }
+
+bool AlarmEngine::anyEnabled() const {
+    for (int i = 0; i < ALARM_COUNT; i++)
+        if (settings.alarms[i].enabled)
+            return true;
+    return false;
+}
+
+void AlarmEngine::reschedule(time_t from) {
+    next = 0;
+    nextIndex = -1;
+    for (int i = 0; i < ALARM_COUNT; i++) {
+        if (!settings.alarms[i].enabled)
+            continue;
+        time_t t = nextFireFor(settings.alarms[i], from);
+        if (t != 0 && (next == 0 || t < next)) {
+            next = t;
+            nextIndex = i;
+        }
+    }
+    if (snoozeUntil != 0 && (next == 0 || snoozeUntil <= next)) {
+        next = snoozeUntil;
+        nextIndex = snoozeIndex;
+    }
+}
+
+void AlarmEngine::check() {
+    if (!Time.valid())
+        return;
+    time_t now = Time.epoch();
+    if (stale) {
+        bool stall =
+            lastSeen != 0 && now >= lastSeen && now - lastSeen <= CATCH_UP_S;
+        reschedule(stall ? lastSeen : now);
+        stale = false;
+    }
+    lastSeen = now;
+    if (next != 0 && now >= next)
+        fire(now);
+}
+
+void AlarmEngine::fire(time_t now) {
+    int idx = nextIndex;
+    if (snoozeUntil != 0 && next == snoozeUntil) {
+        snoozeUntil = 0;
+        snoozeIndex = -1;
+    } else if (settings.alarms[idx].days == 0) {
+        // One-shot
+        settings.alarms[idx].enabled = false;
+        Store.requestSave();
+    }
+    ringingIndex = idx;
+    ui.alarmRinging = true;
+    reschedule(now);
+}
+
+void AlarmEngine::snooze() {
+    if (!ringing())
+        return;
+    snoozeUntil = Time.epoch() + SNOOZE_S;
+    snoozeIndex = ringingIndex;
+    ringingIndex = -1;
+    ui.alarmRinging = false;
+    reschedule(Time.epoch());
+}
+
+void AlarmEngine::dismiss() {
+    ringingIndex = -1;
+    ui.alarmRinging = false;
+    snoozeUntil = 0;
+    snoozeIndex = -1;
+    reschedule(Time.epoch());
+}
@@ -0,0 +1,54 @@
+#ifndef ALARMENGINE_H
+#define ALARMENGINE_H
+
+#include "Types.h"
+#include <Arduino.h>
+#include <time.h>
+
+// Fires the alarms in settings.alarms. The next fire time of every enabled
+// alarm is worked out in advance, through mktime() so DST is accounted
+// for, and check() only compares the current epoch against the earliest.
+// Nothing depends on seeing a particular second, so a stalled loop rings
+// late instead of not at all.
+class AlarmEngine {
+  public:
+    static const uint32_t SNOOZE_S = 9 * 60;
+    // A forward jump up to this long is treated as a stall: alarms that
+    // fell inside it still ring. Longer jumps (NTP, time zone) skip them.
+    static const uint32_t CATCH_UP_S = 120;
+
+    // Call after editing alarms; the schedule is rebuilt on the next check.
+    void changed() { stale = true; }
+    // Time listener for TIME_JUMP.
+    static void onTimeJump(uint8_t events);
+    // Hot path, run from the time task.
+    void check();
+
+    void snooze();
+    void dismiss();
+
+    bool ringing() const { return ringingIndex >= 0; }
+    bool anyEnabled() const;
+    // 0 if nothing is scheduled
+    time_t nextFire() const { return next; }
+    int nextAlarm() const { return nextIndex; }
+
+    // Next time strictly after from that alarm a would ring, or 0.
+    static time_t nextFireFor(const AlarmSpec &a, time_t from);
+
+  private:
+    time_t next = 0;
+    int8_t nextIndex = -1;
+    int8_t ringingIndex = -1;
+    time_t snoozeUntil = 0;
+    int8_t snoozeIndex = -1;
+    time_t lastSeen = 0;
+    bool stale = true;
+
+    void reschedule(time_t from);
+    void fire(time_t now);
+};
+
+extern AlarmEngine Alarms;
+
+#endif
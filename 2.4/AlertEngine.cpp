@@ -0,0 +1,82 @@
+#include "AlertEngine.h"
+#include "Globals.h"
+
+AlertEngine Alerts;
+
+void AlertEngine::recordMinute(const int32_t *values, uint32_t nowMs) {
+    if (filled != 0 && nowMs - lastMinuteMs < 60000)
+        return;
+    lastMinuteMs = filled == 0 ? nowMs : lastMinuteMs + 60000;
+    // After a long gap the ring no longer describes the recent past
+    if (nowMs - lastMinuteMs >= 60000) {
+        filled = 0;
+        lastMinuteMs = nowMs;
+    }
+    head = head == RISE_WINDOW_MAX ? 0 : head + 1;
+    for (int c = 0; c < HIST_CHANNELS; c++)
+        minutes[c][head] = values[c];
+    if (filled <= RISE_WINDOW_MAX)
+        filled++;
+}
+
+bool AlertEngine::rise(int channel, int windowMin, int32_t now,
+                       int32_t &out) const {
+    if (windowMin < 1 || windowMin > RISE_WINDOW_MAX || windowMin >= filled)
+        return false;
+    int k = head - windowMin;
+    if (k < 0)
+        k += RISE_WINDOW_MAX + 1;
+    out = now - minutes[channel][k];
+    return true;
+}
+
+void AlertEngine::evaluate(int i, const AlertRuleSpec &r,
+                           const int32_t *values, uint32_t nowMs) {
+    RuleState &s = state[i];
+    int32_t v = values[r.channel];
+    if (r.kind == RULE_RISE && !rise(r.channel, r.windowMin, v, v)) {
+        s.pending = false; // not enough history to judge yet
+        return;
+    }
+    bool below = r.kind == RULE_BELOW;
+    if (s.active) {
+        if (below ? v > r.threshold + r.hysteresis
+                  : v < r.threshold - r.hysteresis)
+            s.active = false;
+        return;
+    }
+    if (!(below ? v < r.threshold : v > r.threshold)) {
+        s.pending = false;
+        return;
+    }
+    if (!s.pending) {
+        s.pending = true;
+        s.sinceMs = nowMs;
+    }
+    if (nowMs - s.sinceMs >= (uint32_t)r.holdS * 1000) {
+        s.active = true;
+        s.pending = false;
+    }
+}
+
+void AlertEngine::onSample(const int32_t *values, uint32_t nowMs) {
+    if (stale) {
+        for (int i = 0; i < ALERT_RULE_COUNT; i++)
+            state[i] = RuleState();
+        stale = false;
+    }
+    recordMinute(values, nowMs);
+
+    AlertLevel top = ALERT_NONE;
+    for (int i = 0; i < ALERT_RULE_COUNT; i++) {
+        const AlertRuleSpec &r = settings.alertRules[i];
+        if (!r.enabled || r.channel >= HIST_CHANNELS) {
+            state[i] = RuleState();
+            continue;
+        }
+        evaluate(i, r, values, nowMs);
+        if (state[i].active && r.level > top)
+            top = (AlertLevel)r.level;
+    }
+    current = top;
+}
@@ -0,0 +1,56 @@
+#ifndef ALERTENGINE_H
+#define ALERTENGINE_H
+
+#include "HistoryPyramid.h"
+#include "Types.h"
+#include <Arduino.h>
+
+// Evaluates settings.alertRules against each new sensor sample. Every rule
+// is a small state machine: its condition has to hold for holdS seconds
+// before the alert is raised, and it is only cleared once the value is back
+// past the hysteresis band, so a reading hovering at the threshold does not
+// flap. Rise rules compare the current value with the one recorded
+// windowMin minutes earlier, from a per-channel ring of one value a minute.
+class AlertEngine {
+  public:
+    // Longest rise window, in minutes
+    static const int RISE_WINDOW_MAX = 30;
+
+    // Once per new sample, in history units (see AlertRuleSpec).
+    void onSample(const int32_t *values, uint32_t nowMs);
+    // Call after editing the rules; their state is dropped on the next
+    // sample.
+    void changed() { stale = true; }
+
+    // Highest level among the raised rules
+    AlertLevel level() const { return current; }
+    bool active(int rule) const { return state[rule].active; }
+
+  private:
+    struct RuleState {
+        bool active = false;
+        bool pending = false;
+        uint32_t sinceMs = 0;
+    };
+
+    RuleState state[ALERT_RULE_COUNT];
+    AlertLevel current = ALERT_NONE;
+    bool stale = false;
+
+    // Minute values per channel; slot head is the newest
+    int32_t minutes[HIST_CHANNELS][RISE_WINDOW_MAX + 1];
+    uint8_t head = 0;
+    uint8_t filled = 0;
+    uint32_t lastMinuteMs = 0;
+
+    void recordMinute(const int32_t *values, uint32_t nowMs);
+    // Change over the last windowMin minutes; false until that much
+    // history exists.
+    bool rise(int channel, int windowMin, int32_t now, int32_t &out) const;
+    void evaluate(int i, const AlertRuleSpec &r, const int32_t *values,
+                  uint32_t nowMs);
+};
+
+extern AlertEngine Alerts;
+
+#endif
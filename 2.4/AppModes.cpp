@@ -1,80 +1,87 @@
 #include "AppModes.h"
+#include "Scheduler.h"
+
+namespace Modes {
+MenuMode Menu;
+ClockMode Clock;
+PomodoroMode Pomodoro;
+AlarmMode Alarm;
+DvdMode Dvd;
+SettingsMode Settings;
+SettingsEditMode SettingsEdit;
+WiFiMenuMode WiFiMenu;
+WiFiSetupMode WiFiSetup;
+} // namespace Modes
 
 // ================= CLOCK MODE =================
 void ClockMode::enter() {
     ui.currentMode = MODE_CLOCK;
     initClockStaticUI();
-    prevTimeStr = "";
-    // Force an update immediately so we don't show empty data
-    updateEnvSensors(true); 
-    drawClockTime(getTimeStr('H'), getTimeStr('M'), getTimeStr('S'));
+    prevEpoch = 0;
+    drawTime();
     drawEnvDynamic();
 }
 
-void ClockMode::loop() {
-    // OPTIMIZATION: Check for exit condition FIRST.
-    // If the button was pressed, skip all sensor reading and clock rendering.
-    // This removes the ~300ms latency caused by I2C communication.
-    if (Input.backPressed) {
-        State.switchMode(new MenuMode());
-        return; // Stop processing this loop immediately
-    }
+void ClockMode::drawTime() { drawClockTime(Time.hms()); }
 
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo)) {
-        int sec = timeinfo.tm_sec;
-        if (sec != prevSecond) {
-            prevSecond = sec;
-            drawClockTime(getTimeStr('H'), getTimeStr('M'), getTimeStr('S'));
-            
-            // Only read sensors if we are NOT exiting
-            if (sec % 5 == 0) {
-                updateEnvSensors(true);
-                drawEnvDynamic();
-            } else {
-                updateEnvSensors(false);
-            }
-        }
-    }
+void ClockMode::onInput(const InputEvent &ev) {
+    if (ev.is(EV_PRESS, BTN_BACK))
+        State.switchMode(Modes::Menu);
+}
+
+void ClockMode::loop() {
+    if (!Time.valid() || Time.epoch() == prevEpoch)
+        return;
+    prevEpoch = Time.epoch();
+    drawTime();
+    if (Time.local().tm_sec % 5 == 0)
+        drawEnvDynamic();
 }
 
 // ================= MENU MODE =================
 void MenuMode::enter() {
-    // No specific draw here, list handles it
+    ui.currentMode = MODE_MENU;
+    // Keep the cursor from the last visit; the list redraws in loop()
+    lastIndex = -1;
 }
 
 void MenuMode::loop() {
     if (index != lastIndex) {
-        drawGenericList(labels, ITEMS, index, lastIndex, lastIndex == -1);
+        drawGenericList(labels, ITEMS, index, lastIndex, lastIndex == -1,
+                        listTop);
         lastIndex = index;
     }
-    if (Input.encStep != 0) {
-        lastIndex = index;
-        index += Input.encStep;
-        if (index < 0)
-            index = ITEMS - 1;
-        if (index >= ITEMS)
-            index = 0;
-        drawGenericList(labels, ITEMS, index, lastIndex, false);
-    }
-    if (Input.encPressed) {
+}
+
+void MenuMode::onInput(const InputEvent &ev) {
+    if (ev.type == EV_ROTATE) {
+        index = ((index + ev.steps) % ITEMS + ITEMS) % ITEMS;
+    } else if (ev.is(EV_PRESS, BTN_ENC)) {
         if (index == 0)
-            State.switchMode(new ClockMode());
+            State.switchMode(Modes::Clock);
         else if (index == 1)
-            State.switchMode(new PomodoroMode());
-        else if (index == 2)
-            State.switchMode(new AlarmMode(false));
-        else if (index == 3)
-            State.switchMode(new DvdMode());
+            State.switchMode(Modes::Pomodoro);
+        else if (index == 2) {
+            Modes::Alarm.setRinging(false);
+            State.switchMode(Modes::Alarm);
+        } else if (index == 3)
+            State.switchMode(Modes::Dvd);
         else if (index == 4)
-            State.switchMode(new SettingsMode());
+            State.switchMode(Modes::Settings);
+    } else if (ev.is(EV_PRESS, BTN_BACK)) {
+        State.switchMode(Modes::Clock);
     }
-    if (Input.backPressed)
-        State.switchMode(new ClockMode());
 }
 
 // ================= POMODORO MODE =================
 void PomodoroMode::enter() {
+    ui.currentMode = MODE_POMODORO;
+    if (state == POMO_RUNNING || state == POMO_PAUSED) {
+        tick();
+        drawScreen(true);
+        phaseEnded = false;
+        return;
+    }
     state = POMO_SET_WORK;
     prevVal = -1;
     UI::drawHeader("Set Work");
@@ -88,21 +95,23 @@ void PomodoroMode::updateValue(int value) {
     int numY = 100;
     int numW = 100;
     int startX = (Screen::WIDTH - numW) / 2;
-    tft.fillRect(startX, numY, numW, 50, Colors::BG);
-    UI::textCentered(String(value), numY, 6, ST77XX_WHITE);
+    drawList.fillRect(startX, numY, numW, 50, Colors::BG);
+    TextBuf<6> s;
+    s.appendInt(value);
+    UI::textCentered(s.c_str(), numY, 6, ST77XX_WHITE);
 }
 
 void PomodoroMode::drawScreen(bool force) {
     if (force) {
         UI::clear();
         prevBarWidth = -1;
-        prevLabel = "";
-        prevTimeStr = "";
+        prevLabel = nullptr;
+        timeText.invalidate();
         char cycleBuf[20];
         sprintf(cycleBuf, "Cycle: %d/%d", currentCycle, settings.pomoCycles);
         UI::textCentered(cycleBuf, 190, 2, ST77XX_WHITE);
     }
-    String labelStr = "";
+    const char *labelStr;
     uint16_t labelColor = Colors::LIGHT;
     if (state == POMO_PAUSED) {
         labelStr = "Paused";
@@ -118,8 +127,9 @@ void PomodoroMode::drawScreen(bool force) {
         labelColor = Colors::BLUE;
     }
 
+    // Labels are string literals, so comparing pointers is enough.
     if (labelStr != prevLabel) {
-        tft.fillRect(0, 30, Screen::WIDTH, 20, Colors::BG);
+        drawList.fillRect(0, 30, Screen::WIDTH, 20, Colors::BG);
         UI::textCentered(labelStr, 30, 2, labelColor);
         prevLabel = labelStr;
     }
@@ -140,36 +150,28 @@ void PomodoroMode::drawScreen(bool force) {
     char buf[8];
     sprintf(buf, "%02d:%02d", (int)(remain / 60000UL),
             (int)((remain / 1000UL) % 60));
-    String timeStr = String(buf);
     uint16_t timeColor = (state == POMO_PAUSED) ? Colors::LIGHT : ST77XX_WHITE;
-    if (timeStr != prevTimeStr) {
-        UI::textCentered(timeStr, 90, 6, timeColor);
-        prevTimeStr = timeStr;
-    }
+    timeText.drawCentered(buf, 90, timeColor, Colors::BG);
 }
 
-void PomodoroMode::loop() {
+void PomodoroMode::onInput(const InputEvent &ev) {
+    if (ev.is(EV_PRESS, BTN_BACK)) {
+        // A running timer keeps going while we are away (see tick()); a
+        // paused one is abandoned.
+        if (state == POMO_PAUSED)
+            state = POMO_SET_WORK;
+        Store.requestSave();
+        State.switchMode(Modes::Menu);
+        return;
+    }
     if (state < POMO_READY) {
-        if (Input.encStep != 0) {
-            if (state == POMO_SET_WORK) {
-                settings.pomoWorkMin =
-                    constrain(settings.pomoWorkMin + Input.encStep, 1, 90);
-                updateValue(settings.pomoWorkMin);
-            } else if (state == POMO_SET_SHORT) {
-                settings.pomoShortMin =
-                    constrain(settings.pomoShortMin + Input.encStep, 1, 30);
-                updateValue(settings.pomoShortMin);
-            } else if (state == POMO_SET_LONG) {
-                settings.pomoLongMin =
-                    constrain(settings.pomoLongMin + Input.encStep, 1, 60);
-                updateValue(settings.pomoLongMin);
-            } else if (state == POMO_SET_CYCLES) {
-                settings.pomoCycles =
-                    constrain(settings.pomoCycles + Input.encStep, 1, 10);
-                updateValue(settings.pomoCycles);
-            }
-        }
-        if (Input.encPressed) {
+        if (ev.type == EV_ROTATE) {
+            static_assert(POMO_SET_CYCLES - POMO_SET_WORK ==
+                              SET_POMO_CYCLES - SET_POMO_WORK,
+                          "POMO_SET_* must follow the schema order");
+            SettingId id = (SettingId)(SET_POMO_WORK + state);
+            updateValue(Schema::adjust(settings, id, ev.accel));
+        } else if (ev.is(EV_PRESS, BTN_ENC)) {
             prevVal = -1;
             if (state == POMO_SET_WORK) {
                 state = POMO_SET_SHORT;
@@ -193,7 +195,7 @@ void PomodoroMode::loop() {
             }
         }
     } else if (state == POMO_RUNNING || state == POMO_PAUSED) {
-        if (Input.encPressed) {
+        if (ev.is(EV_PRESS, BTN_ENC)) {
             if (state == POMO_RUNNING) {
                 state = POMO_PAUSED;
                 pausedMillis = millis();
@@ -201,118 +203,196 @@ void PomodoroMode::loop() {
                 startMillis += (millis() - pausedMillis);
                 state = POMO_RUNNING;
             }
+        } else if (ev.is(EV_LONG_PRESS, BTN_ENC)) {
+            // Hold the knob to stop the timer and start over
+            state = POMO_SET_WORK;
+            enter();
         }
-        if (state == POMO_RUNNING) {
-            unsigned long elapsed = millis() - startMillis;
-            if (elapsed >= durationMs) {
-                setLedState(true);
-                playSystemTone(2000, 1500);
-                setLedState(false);
-                if (phase == PHASE_WORK) {
-                    if (currentCycle < settings.pomoCycles) {
-                        phase = PHASE_SHORT;
-                        durationMs = settings.pomoShortMin * 60UL * 1000UL;
-                    } else {
-                        phase = PHASE_LONG;
-                        durationMs = settings.pomoLongMin * 60UL * 1000UL;
-                    }
-                } else if (phase == PHASE_SHORT) {
-                    phase = PHASE_WORK;
-                    currentCycle++;
-                    durationMs = settings.pomoWorkMin * 60UL * 1000UL;
-                } else {
-                    phase = PHASE_WORK;
-                    currentCycle = 1;
-                    durationMs = settings.pomoWorkMin * 60UL * 1000UL;
-                }
-                startMillis = millis();
-                drawScreen(true);
-            } else
-                drawScreen(false);
-        } else
-            drawScreen(false);
     }
-    if (Input.backPressed) {
-        saveSettings();
-        State.switchMode(new MenuMode());
+}
+
+void PomodoroMode::nextPhase() {
+    if (phase == PHASE_WORK) {
+        if (currentCycle < settings.pomoCycles) {
+            phase = PHASE_SHORT;
+            durationMs = settings.pomoShortMin * 60UL * 1000UL;
+        } else {
+            phase = PHASE_LONG;
+            durationMs = settings.pomoLongMin * 60UL * 1000UL;
+        }
+    } else if (phase == PHASE_SHORT) {
+        phase = PHASE_WORK;
+        currentCycle++;
+        durationMs = settings.pomoWorkMin * 60UL * 1000UL;
+    } else {
+        phase = PHASE_WORK;
+        currentCycle = 1;
+        durationMs = settings.pomoWorkMin * 60UL * 1000UL;
     }
 }
 
+void PomodoroMode::tick() {
+    if (state != POMO_RUNNING || millis() - startMillis < durationMs)
+        return;
+    // Each phase starts where the last one was due to end, so a late tick
+    // does not stretch the cycle; a long stall may skip whole phases.
+    while (millis() - startMillis >= durationMs) {
+        startMillis += durationMs;
+        nextPhase();
+    }
+    flashLed(1500);
+    playSystemTone(2000, 1500, TONE_NOTIFY);
+    phaseEnded = true;
+}
+
+void PomodoroMode::loop() {
+    if (state != POMO_RUNNING && state != POMO_PAUSED)
+        return;
+    tick();
+    drawScreen(phaseEnded);
+    phaseEnded = false;
+}
+
 // ================= ALARM MODE =================
-AlarmMode::AlarmMode(bool isRinging) : ringing(isRinging) {}
+void AlarmMode::setRinging(bool on) { ringing = on; }
 
 void AlarmMode::enter() {
+    ui.currentMode = MODE_ALARM;
     if (ringing) {
         UI::clear(ST77XX_RED);
-        UI::text("ALARM!", 60, 100, 4, ST77XX_WHITE, ST77XX_RED);
+        UI::text("ALARM!", 60, 80, 4, ST77XX_WHITE, ST77XX_RED);
+        UI::text("Press: snooze", 60, 150, 2, ST77XX_WHITE, ST77XX_RED);
+        UI::text("Back:  stop", 60, 175, 2, ST77XX_WHITE, ST77XX_RED);
     } else {
         draw(true);
     }
 }
 
+namespace {
+struct DayPreset {
+    uint8_t days;
+    const char *name; // padded to the same width so each erases the last
+};
+const DayPreset DAY_PRESETS[] = {{0x7F, " Daily  "},
+                                 {0x3E, "Weekdays"},
+                                 {0x41, "Weekends"},
+                                 {0x00, "  Once  "}};
+const int DAY_PRESET_COUNT = sizeof(DAY_PRESETS) / sizeof(DAY_PRESETS[0]);
+
+int findDayPreset(uint8_t days) {
+    for (int i = 0; i < DAY_PRESET_COUNT; i++)
+        if (DAY_PRESETS[i].days == days)
+            return i;
+    return -1;
+}
+} // namespace
+
 void AlarmMode::draw(bool full) {
     if (full) {
         UI::clear();
-        UI::text("Status:", 50, 165, 3, ST77XX_WHITE);
-    }
-    char hBuf[3], mBuf[3];
-    sprintf(hBuf, "%02d", settings.alarmHour);
-    sprintf(mBuf, "%02d", settings.alarmMinute);
-    int16_t x1, y1;
-    uint16_t w, h;
-    tft.setTextSize(6);
-    tft.getTextBounds("88:88", 0, 0, &x1, &y1, &w, &h);
-    int x = (Screen::WIDTH - w) / 2;
-    tft.setCursor(x, 60);
-    tft.setTextColor(selectedField == 0 ? Colors::LIGHT : ST77XX_WHITE,
-                     Colors::BG);
-    tft.print(hBuf);
-    tft.setTextColor(ST77XX_WHITE, Colors::BG);
-    tft.print(":");
-    tft.setTextColor(selectedField == 1 ? Colors::LIGHT : ST77XX_WHITE,
-                     Colors::BG);
-    tft.print(mBuf);
-    uint16_t enColor =
-        selectedField == 2
-            ? Colors::LIGHT
-            : (settings.alarmEnabled ? Colors::GREEN : ST77XX_RED);
-    UI::text(settings.alarmEnabled ? "ON " : "OFF", 180, 165, 3, enColor);
+        UI::text("Status:", 50, 190, 3, ST77XX_WHITE);
+    }
+    DrawBatch batch(drawList);
+    const AlarmSpec &a = settings.alarms[alarmIndex];
+
+    char buf[24];
+    snprintf(buf, sizeof(buf), "< Alarm %d >", alarmIndex + 1);
+    UI::textCentered(buf, 12, 2,
+                     selectedField == 0 ? Colors::LIGHT : ST77XX_WHITE);
+
+    // Room for any uint8_t, though the fields never leave 0-23 and 0-59
+    char hBuf[4], mBuf[4];
+    snprintf(hBuf, sizeof(hBuf), "%02d", a.hour);
+    snprintf(mBuf, sizeof(mBuf), "%02d", a.minute);
+    int x = (Screen::WIDTH - DrawList::textWidth("88:88", 6)) / 2;
+    int charW = DrawList::textWidth(":", 6);
+    UI::text(hBuf, x, 45, 6,
+             selectedField == 1 ? Colors::LIGHT : ST77XX_WHITE);
+    UI::text(":", x + 2 * charW, 45, 6, ST77XX_WHITE);
+    UI::text(mBuf, x + 3 * charW, 45, 6,
+             selectedField == 2 ? Colors::LIGHT : ST77XX_WHITE);
+
+    // Monday first; bit 0 of days is Sunday
+    static const char LETTERS[] = "MTWTFSS";
+    uint16_t onColor =
+        selectedField == FIELD_PRESET ? Colors::LIGHT : Colors::GREEN;
+    int dayX = (Screen::WIDTH - 7 * 30) / 2 + 6;
+    for (int i = 0; i < 7; i++) {
+        int bit = (i + 1) % 7;
+        char letter[2] = {LETTERS[i], 0};
+        UI::text(letter, dayX + i * 30, 112, 3,
+                 (a.days & (1 << bit)) ? onColor : Colors::DARK);
+        // Underline the day being toggled
+        drawList.fillRect(dayX + i * 30, 138, 15, 2,
+                          selectedField == FIELD_MONDAY + i ? Colors::LIGHT
+                                                            : Colors::BG);
+    }
+    int preset = findDayPreset(a.days);
+    UI::textCentered(preset >= 0 ? DAY_PRESETS[preset].name : " Custom ",
+                     148, 2, Colors::LIGHT);
+
+    uint16_t enColor = selectedField == FIELD_ENABLED
+                           ? Colors::LIGHT
+                           : (a.enabled ? Colors::GREEN : ST77XX_RED);
+    UI::text(a.enabled ? "ON " : "OFF", 180, 190, 3, enColor);
 }
 
 void AlarmMode::loop() {
+    if (ringing && (!Buzzer.busy() || Buzzer.priority() < TONE_ALARM)) {
+        static const Note ring[] = {{2000, 400, 100}, {0, 600, 0}};
+        Buzzer.play(ring, 2, TONE_ALARM);
+    }
+}
+
+void AlarmMode::onInput(const InputEvent &ev) {
     if (ringing) {
-        if (millis() - lastBeep > 1000) {
-            lastBeep = millis();
-            playSystemTone(2000, 400);
-        }
-        if (Input.encPressed || Input.backPressed) {
+        if (ev.type == EV_PRESS) {
+            if (ev.button == BTN_ENC)
+                Alarms.snooze();
+            else
+                Alarms.dismiss();
             ringing = false;
-            ui.lastAlarmDayTriggered = -1;
             stopSystemTone();
             draw(true);
         }
         return;
     }
     bool changed = false;
-    if (Input.encStep != 0) {
-        if (selectedField == 0)
-            settings.alarmHour =
-                (settings.alarmHour + (Input.encStep > 0 ? 1 : 23)) % 24;
-        else if (selectedField == 1)
-            settings.alarmMinute =
-                (settings.alarmMinute + (Input.encStep > 0 ? 1 : 59)) % 60;
-        else if (selectedField == 2)
-            settings.alarmEnabled = !settings.alarmEnabled;
+    if (ev.type == EV_ROTATE) {
+        const SettingId *ids = Schema::ALARMS[alarmIndex];
+        if (selectedField == 0) {
+            alarmIndex = ((alarmIndex + ev.steps) % ALARM_COUNT + ALARM_COUNT) %
+                         ALARM_COUNT;
+        } else if (selectedField == FIELD_PRESET) {
+            int preset = findDayPreset(settings.alarms[alarmIndex].days);
+            preset = preset < 0 ? 0
+                                : ((preset + ev.steps) % DAY_PRESET_COUNT +
+                                   DAY_PRESET_COUNT) %
+                                      DAY_PRESET_COUNT;
+            Schema::set(settings, ids[Schema::ALARM_DAYS],
+                        DAY_PRESETS[preset].days);
+        } else if (selectedField >= FIELD_MONDAY &&
+                   selectedField < FIELD_ENABLED) {
+            // Any turn flips the day; bit 0 is Sunday
+            int bit = (selectedField - FIELD_MONDAY + 1) % 7;
+            Schema::set(settings, ids[Schema::ALARM_DAYS],
+                        settings.alarms[alarmIndex].days ^ (1 << bit));
+        } else {
+            Schema::AlarmField f = selectedField == 1   ? Schema::ALARM_HOUR
+                                   : selectedField == 2 ? Schema::ALARM_MINUTE
+                                                        : Schema::ALARM_ENABLED;
+            Schema::adjust(settings, ids[f], ev.accel);
+        }
+        if (selectedField != 0) {
+            Alarms.changed();
+            Store.requestSave();
+        }
         changed = true;
-        ui.lastAlarmDayTriggered = -1;
-    }
-    if (Input.encPressed) {
-        selectedField = (selectedField + 1) % 3;
+    } else if (ev.is(EV_PRESS, BTN_ENC)) {
+        selectedField = (selectedField + 1) % FIELD_COUNT;
         changed = true;
-    }
-    if (Input.backPressed) {
-        saveSettings();
-        State.switchMode(new MenuMode());
+    } else if (ev.is(EV_PRESS, BTN_BACK)) {
+        State.switchMode(Modes::Menu);
         return;
     }
     if (changed)
@@ -321,28 +401,41 @@ void AlarmMode::loop() {
 
 // ================= DVD MODE =================
 void DvdMode::enter() {
-    initDvd();
-    drawDvdLogo(x, y, dvdPalette[colorIndex]);
+    ui.currentMode = MODE_DVD;
+    UI::clear();
+    renderDvdLogo(sprite, dvdPalette[colorIndex]);
+    compositor.addWidget(logo);
+    present(DirtyRect());
 }
 
-void DvdMode::loop() {
-    if (Input.backPressed) {
-        State.switchMode(new MenuMode());
-        return;
-    }
-    if (Input.encStep != 0) {
-        int speed = abs(vx) + Input.encStep;
+// Repaints the old and new logo areas in one pass, so the logo is never
+// erased on the panel before it is drawn at its new place.
+void DvdMode::present(const DirtyRect &old) {
+    logo.moveTo(x, y);
+    compositor.markDirty(old);
+    compositor.markDirty(logo.bounds());
+    compositor.flush();
+}
+
+void DvdMode::onInput(const InputEvent &ev) {
+    if (ev.is(EV_PRESS, BTN_BACK)) {
+        State.switchMode(Modes::Menu);
+    } else if (ev.type == EV_ROTATE) {
+        int speed = abs(vx) + ev.steps;
         if (speed < 1)
             speed = 1;
         else if (speed > 8)
             speed = 8;
         vx = (vx >= 0 ? 1 : -1) * speed;
     }
+}
+
+void DvdMode::loop() {
     unsigned long now = millis();
     if (now - lastMs < 35)
         return;
     lastMs = now;
-    tft.fillRoundRect(x, y, w, h, 8, Colors::BG);
+    DirtyRect old = logo.bounds();
     x += vx;
     y += vy;
     bool hit = false;
@@ -366,59 +459,56 @@ void DvdMode::loop() {
     }
     if (hit) {
         colorIndex = (colorIndex + 1) % 6;
+        renderDvdLogo(sprite, dvdPalette[colorIndex]);
         playSystemTone(1500, 80);
     }
-    drawDvdLogo(x, y, dvdPalette[colorIndex]);
+    present(old);
 }
 
 // ================= SETTINGS MODE =================
-void SettingsMode::enter() { ui.currentMode = MODE_SETTINGS; }
+void SettingsMode::enter() {
+    ui.currentMode = MODE_SETTINGS;
+    lastIndex = -1;
+    for (int i = 0; i < Schema::MENU_COUNT; i++)
+        labels[i] = Schema::field(Schema::MENU[i]).label;
+    labels[ITEMS - 1] = "WiFi";
+}
 
 void SettingsMode::loop() {
     if (index != lastIndex) {
-        drawGenericList(labels, ITEMS, index, lastIndex, lastIndex == -1);
+        drawGenericList(labels, ITEMS, index, lastIndex, lastIndex == -1,
+                        listTop);
         lastIndex = index;
     }
-    if (Input.encStep != 0) {
-        lastIndex = index;
-        index += Input.encStep;
-        if (index < 0)
-            index = ITEMS - 1;
-        if (index >= ITEMS)
-            index = 0;
-        drawGenericList(labels, ITEMS, index, lastIndex, false);
-    }
-    if (Input.encPressed) {
-        if (index < 3)
-            State.switchMode(new SettingsEditMode(index));
-        else
-            State.switchMode(new WiFiMenuMode());
-    }
-    if (Input.backPressed) {
-        saveSettings();
-        State.switchMode(new MenuMode());
+}
+
+void SettingsMode::onInput(const InputEvent &ev) {
+    if (ev.type == EV_ROTATE) {
+        index = ((index + ev.steps) % ITEMS + ITEMS) % ITEMS;
+    } else if (ev.is(EV_PRESS, BTN_ENC)) {
+        if (index < Schema::MENU_COUNT) {
+            Modes::SettingsEdit.setField(Schema::MENU[index]);
+            State.switchMode(Modes::SettingsEdit);
+        } else
+            State.switchMode(Modes::WiFiMenu);
+    } else if (ev.is(EV_PRESS, BTN_BACK)) {
+        Store.requestSave();
+        State.switchMode(Modes::Menu);
     }
 }
 
 // ================= SETTINGS EDIT MODE =================
-SettingsEditMode::SettingsEditMode(int id) : editId(id) {
-    if (id == 0)
-        currentVal = settings.ledBrightness;
-    else if (id == 1)
-        currentVal = settings.speakerVol;
-    else
-        currentVal = settings.graphDuration;
+void SettingsEditMode::setField(SettingId id) {
+    field = id;
+    currentVal = Schema::get(settings, id);
 }
 
 void SettingsEditMode::enter() {
     ui.currentMode = MODE_SETTINGS_EDIT;
 
-    String title = (editId == 0)   ? "LED Brightness"
-                   : (editId == 1) ? "Speaker Volume"
-                                   : "Graph Range";
-    UI::drawHeader(title);
+    UI::drawHeader(Schema::field(field).label);
 
-    if (editId == 0)
+    if (field == SET_LED_BRIGHTNESS)
         setLedState(true);
 
     prevVal = -1;
@@ -431,89 +521,90 @@ void SettingsEditMode::enter() {
 void SettingsEditMode::drawValue() {
     int textY = 90;
 
-    if (editId == 2) {
-        String s;
+    switch (Schema::field(field).format) {
+    case FMT_DURATION: {
+        TextBuf<6> s;
         if (currentVal < 60)
-            s = String(currentVal) + "m";
+            s.appendInt(currentVal).append('m');
         else
-            s = String(currentVal / 60) + "h";
+            s.appendInt(currentVal / 60).append('h');
         while (s.length() < 6) {
             if (s.length() % 2 == 0)
-                s = s + " ";
+                s.append(' ');
             else
-                s = " " + s;
+                s.prepend(' ');
         }
-        UI::textCentered(s, textY, 5, ST77XX_WHITE, Colors::BG);
-    } else {
+        UI::textCentered(s.c_str(), textY, 5, ST77XX_WHITE, Colors::BG);
+        break;
+    }
+    case FMT_AUTO_FIXED:
+        // Same width for both so the shorter one erases the longer
+        UI::textCentered(currentVal ? " Auto" : "Fixed", textY, 5,
+                         ST77XX_WHITE, Colors::BG);
+        break;
+    case FMT_ON_OFF:
+        UI::textCentered(currentVal ? " On" : "Off", textY, 5, ST77XX_WHITE,
+                         Colors::BG);
+        break;
+    case FMT_PERCENT: {
         char buf[16];
         sprintf(buf, "%3d%%", currentVal);
-        UI::textCentered(String(buf), textY, 5, ST77XX_WHITE, Colors::BG);
+        UI::textCentered(buf, textY, 5, ST77XX_WHITE, Colors::BG);
 
         int barW = 260;
         int barH = 15;
         int barX = (Screen::WIDTH - barW) / 2;
         int barY = 160;
 
-        if (prevBarWidth == -1) {
-            tft.drawRect(barX - 1, barY - 1, barW + 2, barH + 2, ST77XX_WHITE);
-            tft.fillRect(barX, barY, barW, barH, Colors::DARK);
-        }
-
         UI::drawBar(barX, barY, barW, barH, currentVal, Colors::GREEN,
                     prevBarWidth);
+        break;
+    }
+    default: {
+        char buf[8];
+        sprintf(buf, "%3d", currentVal);
+        UI::textCentered(buf, textY, 5, ST77XX_WHITE, Colors::BG);
+        break;
+    }
     }
 }
 
-void SettingsEditMode::loop() {
-    bool valChanged = false;
+void SettingsEditMode::loop() {}
 
-    if (Input.encStep != 0) {
-        if (editId == 0) {
-            settings.ledBrightness =
-                constrain(settings.ledBrightness + (Input.encStep * 5), 0, 100);
-            currentVal = settings.ledBrightness;
+void SettingsEditMode::onInput(const InputEvent &ev) {
+    if (ev.type == EV_ROTATE) {
+        // Lists move one entry per detent; numbers follow the acceleration
+        int delta = Schema::field(field).choices ? ev.steps : ev.accel;
+        currentVal = Schema::adjust(settings, field, delta);
+        if (field == SET_LED_BRIGHTNESS)
             setLedState(true);
-            valChanged = true;
-        } else if (editId == 1) {
-            settings.speakerVol =
-                constrain(settings.speakerVol + (Input.encStep * 5), 0, 100);
+        else if (field == SET_SPEAKER_VOL)
             playSystemTone(2000, 20);
-            currentVal = settings.speakerVol;
-            valChanged = true;
-        } else {
-            int oldIdx = 0;
-            for (int i = 0; i < GRAPH_RANGES_COUNT; i++)
-                if (settings.graphDuration == GRAPH_RANGES_MIN[i]) {
-                    oldIdx = i;
-                    break;
-                }
-            int newIdx =
-                constrain(oldIdx + Input.encStep, 0, GRAPH_RANGES_COUNT - 1);
-            settings.graphDuration = GRAPH_RANGES_MIN[newIdx];
-            currentVal = settings.graphDuration;
-            valChanged = true;
+        if (currentVal != prevVal) {
+            drawValue();
+            prevVal = currentVal;
+            Store.requestSave();
         }
     }
 
-    if (valChanged) {
-        drawValue();
-        prevVal = currentVal;
-    }
+    if (ev.type == EV_PRESS)
+        State.switchMode(Modes::Settings);
+}
 
-    if (Input.encPressed || Input.backPressed) {
+void SettingsEditMode::exit() {
+    if (field == SET_LED_BRIGHTNESS)
         setLedState(false);
-        State.switchMode(new SettingsMode());
-    }
 }
 
 // ================= WIFI MODES (Condensed) =================
 void WiFiMenuMode::enter() {
+    ui.currentMode = MODE_WIFI_MENU;
+    lastIndex = -1;
     UI::drawHeader("Current Network");
-    String status =
-        (WiFi.status() == WL_CONNECTED) ? WiFi.SSID() : "Not Connected";
-    UI::textCentered(status, 70, 3,
-                     (WiFi.status() == WL_CONNECTED) ? Colors::GREEN
-                                                     : ST77XX_RED);
+    bool connected = WiFi.status() == WL_CONNECTED;
+    TextBuf<32> status(connected ? WiFi.SSID().c_str() : "Not Connected");
+    UI::textCentered(status.c_str(), 70, 3,
+                     connected ? Colors::GREEN : ST77XX_RED);
 }
 void WiFiMenuMode::loop() {
     if (index != lastIndex) {
@@ -531,101 +622,58 @@ void WiFiMenuMode::loop() {
         }
         lastIndex = index;
     }
-    if (Input.encStep != 0) {
-        index = (index + Input.encStep);
-        if (index < 0)
-            index = 1;
-        if (index > 1)
-            index = 0;
-    }
-    if (Input.encPressed) {
+}
+
+void WiFiMenuMode::onInput(const InputEvent &ev) {
+    if (ev.type == EV_ROTATE) {
+        index = ((index + ev.steps) % 2 + 2) % 2;
+    } else if (ev.is(EV_PRESS, BTN_ENC)) {
         if (index == 0)
-            State.switchMode(new WiFiSetupMode());
+            State.switchMode(Modes::WiFiSetup);
         else {
             UI::clear();
             UI::textCentered("Reset WiFi?", 90, 2, ST77XX_WHITE);
             wm.resetSettings();
-            delay(500);
-            ESP.restart();
+            Log.flush();
+            Store.flush();
+            Tasks.after(500, [] { ESP.restart(); }, "restart");
         }
+    } else if (ev.is(EV_PRESS, BTN_BACK)) {
+        State.switchMode(Modes::Settings);
     }
-    if (Input.backPressed)
-        State.switchMode(new SettingsMode());
 }
 
 void WiFiSetupMode::enter() {
+    ui.currentMode = MODE_WIFI_SETUP;
+    connectedMs = 0;
     UI::clear();
     UI::textCentered("WiFi Setup", 30, 3, ST77XX_WHITE);
     UI::text("Connect to: CyberClockSetup", 20, 70, 2, ST77XX_WHITE);
     UI::text("IP: 192.168.4.1", 20, 130, 2, ST77XX_WHITE);
+    Network.suspend();
     wm.setConfigPortalBlocking(false);
     wm.startConfigPortal("CyberClockSetup");
 }
+void WiFiSetupMode::exit() {
+    wm.stopConfigPortal();
+    Network.resume();
+}
+
+void WiFiSetupMode::onInput(const InputEvent &ev) {
+    if (ev.is(EV_PRESS, BTN_BACK))
+        State.switchMode(Modes::WiFiMenu);
+}
+
 void WiFiSetupMode::loop() {
     wm.process();
-    if (Input.backPressed) {
-        wm.stopConfigPortal();
-        State.switchMode(new WiFiMenuMode());
-    }
-    if (WiFi.status() == WL_CONNECTED) {
+    if (connectedMs == 0 && WiFi.status() == WL_CONNECTED) {
         UI::clear();
         UI::textCentered("Connected!", 100, 3, Colors::GREEN);
-        delay(1500);
-        wm.stopConfigPortal();
-        syncTime();
-        State.switchMode(new SettingsMode());
+        connectedMs = millis();
     }
-}
-
-void checkAlarmTrigger() {
-    if (!settings.alarmEnabled || ui.alarmRinging)
-        return;
-
-    struct tm timeinfo;
-    if (!getLocalTime(&timeinfo))
-        return;
-
-    if (timeinfo.tm_hour == settings.alarmHour &&
-        timeinfo.tm_min == settings.alarmMinute && timeinfo.tm_sec == 0) {
-
-        ui.alarmRinging = true;
-        ui.lastAlarmDayTriggered = timeinfo.tm_mday;
-
-        State.switchMode(new AlarmMode(true));
+    // Leave the confirmation up for a moment without stalling the loop.
+    // Network takes over (and starts SNTP) when this mode exits
+    if (connectedMs != 0 && millis() - connectedMs >= 1500) {
+        State.switchMode(Modes::Settings);
     }
 }
-
-void checkStartupWiFi() {
-    UI::clear();
-    UI::text("Checking WiFi...", 20, 100, 2, ST77XX_WHITE);
-
-    wm.setEnableConfigPortal(false);
-    bool connected = wm.autoConnect();
-
-    if (connected) {
-        UI::text("Connected!", 20, 130, 2, Colors::GREEN);
-        delay(100);
-        syncTime();
-
-        struct tm timeinfo;
-        int retries = 0;
-        while (!getLocalTime(&timeinfo) && retries < 5) {
-            delay(500);
-            retries++;
-        }
-    } else {
-        UI::text("Offline Mode", 20, 130, 2, ST77XX_RED);
-        delay(100);
-
-        struct tm tm;
-        tm.tm_year = 2024 - 1900;
-        tm.tm_mon = 0;
-        tm.tm_mday = 1;
-        tm.tm_hour = 12;
-        tm.tm_min = 0;
-        tm.tm_sec = 0;
-        time_t t = mktime(&tm);
-        struct timeval now = {.tv_sec = t, .tv_usec = 0};
-        settimeofday(&now, NULL);
-    }
-}
\ No newline at end of file
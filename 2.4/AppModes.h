@@ -1,11 +1,17 @@
 #ifndef APPMODES_H
 #define APPMODES_H
 
+#include "AlarmEngine.h"
+#include "Connectivity.h"
+#include "EnvLog.h"
 #include "Globals.h"
+#include "GlyphAtlas.h"
 #include "Graphics.h"
 #include "Hardware.h"
 #include "Mode.h"
+#include "SettingsStore.h"
 #include "StateManager.h"
+#include "TimeService.h"
 
 // --- Menu Mode ---
 class MenuMode : public Mode {
@@ -15,21 +21,25 @@ class MenuMode : public Mode {
     const char *labels[ITEMS] = {"Monitor", "Pomodoro", "Alarm", "DVD",
                                  "Settings"};
     int lastIndex = -1;
+    int listTop = 0;
 
   public:
     void enter() override;
     void loop() override;
+    void onInput(const InputEvent &ev) override;
 };
 
 // --- Clock Mode ---
 class ClockMode : public Mode {
   private:
-    int prevSecond = -1;
-    String prevTimeStr = "";
+    time_t prevEpoch = 0;
+
+    void drawTime();
 
   public:
     void enter() override;
     void loop() override;
+    void onInput(const InputEvent &ev) override;
 };
 
 // --- Pomodoro Mode ---
@@ -44,30 +54,44 @@ class PomodoroMode : public Mode {
     unsigned long durationMs = 0;
     int prevVal = -1;
     int prevBarWidth = -1;
-    String prevLabel = "";
-    String prevTimeStr = "";
+    const char *prevLabel = nullptr;
+    bool phaseEnded = false; // not yet shown on screen
+    BigText timeText;
 
     void drawScreen(bool force);
     void updateValue(int val);
+    void nextPhase();
 
   public:
+    // Ends phases on time, with their tone and flash, whichever mode is
+    // shown. The scheduler calls it; loop() does too.
+    void tick();
     void enter() override;
     void loop() override;
+    void onInput(const InputEvent &ev) override;
 };
 
 // --- Alarm Mode ---
 class AlarmMode : public Mode {
   private:
+    // Fields: 0=alarm, 1=hour, 2=minute, then the repeat preset, one
+    // toggle per weekday (Monday first) and on/off
+    static const int FIELD_PRESET = 3;
+    static const int FIELD_MONDAY = 4;
+    static const int FIELD_ENABLED = FIELD_MONDAY + 7;
+    static const int FIELD_COUNT = FIELD_ENABLED + 1;
+
     int selectedField = 0;
+    int alarmIndex = 0;
     bool ringing = false;
-    unsigned long lastBeep = 0;
 
     void draw(bool full);
 
   public:
-    AlarmMode(bool isRinging = false); // Constructor to handle trigger
+    void setRinging(bool on); // set before switching to show the alarm
     void enter() override;
     void loop() override;
+    void onInput(const InputEvent &ev) override;
 };
 
 // --- DVD Mode ---
@@ -77,39 +101,48 @@ class DvdMode : public Mode {
     int w = 80, h = 30;
     unsigned long lastMs = 0;
     int colorIndex = 0;
+    GFXcanvas16 sprite{80, 30};
+    SpriteWidget logo{sprite};
+
+    void present(const DirtyRect &old);
 
   public:
     void enter() override;
     void loop() override;
+    void onInput(const InputEvent &ev) override;
 };
 
 // --- Settings List Mode ---
 class SettingsMode : public Mode {
   private:
     int index = 0;
-    static const int ITEMS = 4;
-    const char *labels[ITEMS] = {"LED Brightness", "Speaker Volume",
-                                 "Graph Range", "WiFi"};
+    // The editable settings from the schema, then WiFi
+    static const int ITEMS = Schema::MENU_COUNT + 1;
+    const char *labels[ITEMS];
     int lastIndex = -1;
+    int listTop = 0;
 
   public:
     void enter() override;
     void loop() override;
+    void onInput(const InputEvent &ev) override;
 };
 
 // --- Settings Edit Mode ---
 class SettingsEditMode : public Mode {
   private:
-    int editId; // 0=LED, 1=Spk, 2=Graph
-    int currentVal;
+    SettingId field = SET_LED_BRIGHTNESS;
+    int currentVal = 0;
     int prevVal = -1;
     int prevBarWidth = -1;
     void drawValue();
 
   public:
-    SettingsEditMode(int id);
+    void setField(SettingId id); // set before switching
     void enter() override;
     void loop() override;
+    void onInput(const InputEvent &ev) override;
+    void exit() override;
 };
 
 // --- WiFi Menu Mode ---
@@ -122,19 +155,35 @@ class WiFiMenuMode : public Mode {
   public:
     void enter() override;
     void loop() override;
+    void onInput(const InputEvent &ev) override;
 };
 
 // --- WiFi Setup Mode ---
 class WiFiSetupMode : public Mode {
   private:
     bool inited = false;
+    unsigned long connectedMs = 0;
 
   public:
     void enter() override;
     void loop() override;
+    void onInput(const InputEvent &ev) override;
+    void exit() override;
 };
 
-void checkAlarmTrigger();
-void checkStartupWiFi();
+// One instance of every mode, allocated statically for the lifetime of the
+// program.
+namespace Modes {
+extern MenuMode Menu;
+extern ClockMode Clock;
+extern PomodoroMode Pomodoro;
+extern AlarmMode Alarm;
+extern DvdMode Dvd;
+extern SettingsMode Settings;
+extern SettingsEditMode SettingsEdit;
+extern WiFiMenuMode WiFiMenu;
+extern WiFiSetupMode WiFiSetup;
+} // namespace Modes
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,25 @@
+#include "Boot.h"
+
+BootTimeline Boot;
+
+static const char *const STAGE_NAMES[BOOT_STAGES] = {
+    "display", "first_frame", "history", "sensors", "wifi", "time"};
+
+void BootTimeline::mark(BootStage stage, bool ok) {
+    if (done(stage))
+        return;
+    at[stage] = millis();
+    doneMask |= 1 << stage;
+    if (!ok)
+        failedMask |= 1 << stage;
+    Serial.printf("boot: %s at %u ms%s\n", STAGE_NAMES[stage],
+                  (unsigned)at[stage], ok ? "" : " (fallback)");
+}
+
+void BootTimeline::print(Print &out) const {
+    out.println("boot_stage,ms,ok");
+    for (int i = 0; i < BOOT_STAGES; i++)
+        if (done((BootStage)i))
+            out.printf("%s,%u,%d\n", STAGE_NAMES[i], (unsigned)at[i],
+                       (failedMask & (1 << i)) ? 0 : 1);
+}
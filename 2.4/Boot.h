@@ -0,0 +1,35 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <Arduino.h>
+
+enum BootStage : uint8_t {
+    BOOT_DISPLAY = 0, // panel initialised
+    BOOT_FIRST_FRAME, // clock face on screen
+    BOOT_HISTORY,     // flash log replayed into the graph
+    BOOT_SENSORS,     // first live sample
+    BOOT_WIFI,        // connected, or gave up
+    BOOT_TIME,        // wall clock set
+    BOOT_STAGES
+};
+
+// When each boot stage finished, in milliseconds since reset. Everything
+// after the first frame completes in the background, in whatever order
+// the hardware allows.
+class BootTimeline {
+  public:
+    // The first call for a stage wins; ok = false records a fallback.
+    void mark(BootStage stage, bool ok = true);
+    bool done(BootStage stage) const { return doneMask & (1 << stage); }
+    bool complete() const { return doneMask == (1 << BOOT_STAGES) - 1; }
+    void print(Print &out) const;
+
+  private:
+    uint32_t at[BOOT_STAGES] = {};
+    uint8_t doneMask = 0;
+    uint8_t failedMask = 0;
+};
+
+extern BootTimeline Boot;
+
+#endif
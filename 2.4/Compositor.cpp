@@ -0,0 +1,119 @@
+#include "Compositor.h"
+#include "Config.h"
+
+namespace {
+uint16_t band[Screen::WIDTH * Compositor::BAND_H];
+}
+
+bool DirtyRect::touches(const DirtyRect &o) const {
+    return x <= o.x + o.w && o.x <= x + w && y <= o.y + o.h && o.y <= y + h;
+}
+
+void DirtyRect::unite(const DirtyRect &o) {
+    if (o.empty())
+        return;
+    if (empty()) {
+        *this = o;
+        return;
+    }
+    int16_t x2 = max(x + w, o.x + o.w);
+    int16_t y2 = max(y + h, o.y + o.h);
+    x = min(x, o.x);
+    y = min(y, o.y);
+    w = x2 - x;
+    h = y2 - y;
+}
+
+DirtyRect DirtyRect::intersect(const DirtyRect &o) const {
+    int16_t x1 = max(x, o.x);
+    int16_t y1 = max(y, o.y);
+    int16_t x2 = min(x + w, o.x + o.w);
+    int16_t y2 = min(y + h, o.y + o.h);
+    return DirtyRect(x1, y1, x2 - x1, y2 - y1);
+}
+
+DirtyRect SpriteWidget::bounds() const {
+    return DirtyRect(posX, posY, image.width(), image.height());
+}
+
+void SpriteWidget::render(uint16_t *buf, const DirtyRect &area) {
+    DirtyRect r = bounds().intersect(area);
+    const uint16_t *src = image.getBuffer();
+    if (r.empty() || src == nullptr)
+        return;
+    for (int16_t row = r.y; row < r.y + r.h; row++)
+        memcpy(buf + (row - area.y) * area.w + (r.x - area.x),
+               src + (row - posY) * image.width() + (r.x - posX),
+               r.w * sizeof(uint16_t));
+}
+
+Compositor::Compositor(Adafruit_ST7789 &display, uint16_t background)
+    : display(display), background(background) {}
+
+void Compositor::addWidget(Widget &w) {
+    for (int i = 0; i < widgetCount; i++)
+        if (widgets[i] == &w)
+            return;
+    if (widgetCount < MAX_WIDGETS)
+        widgets[widgetCount++] = &w;
+}
+
+void Compositor::clearWidgets() {
+    widgetCount = 0;
+    rectCount = 0;
+}
+
+void Compositor::add(DirtyRect r) {
+    // Merge with anything we touch; the grown rect may now touch others.
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (int i = 0; i < rectCount; i++) {
+            if (rects[i].touches(r)) {
+                r.unite(rects[i]);
+                rects[i] = rects[--rectCount];
+                merged = true;
+                break;
+            }
+        }
+    }
+    if (rectCount == MAX_RECTS) {
+        // Out of slots: fold into the last one rather than lose the region.
+        rects[rectCount - 1].unite(r);
+        return;
+    }
+    rects[rectCount++] = r;
+}
+
+void Compositor::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+    DirtyRect r =
+        DirtyRect(x, y, w, h).intersect(DirtyRect(0, 0, Screen::WIDTH,
+                                                  Screen::HEIGHT));
+    if (!r.empty())
+        add(r);
+}
+
+void Compositor::flush() {
+    lastBytes = 0;
+    if (rectCount == 0)
+        return;
+    display.startWrite();
+    for (int i = 0; i < rectCount; i++) {
+        const DirtyRect &r = rects[i];
+        for (int16_t y = r.y; y < r.y + r.h; y += BAND_H) {
+            DirtyRect area(r.x, y, r.w, min<int16_t>(BAND_H, r.y + r.h - y));
+            uint32_t px = (uint32_t)area.w * area.h;
+            for (uint32_t p = 0; p < px; p++)
+                band[p] = background;
+            for (int k = 0; k < widgetCount; k++)
+                if (!widgets[k]->bounds().intersect(area).empty())
+                    widgets[k]->render(band, area);
+            display.setAddrWindow(area.x, area.y, area.w, area.h);
+            display.writePixels(band, px);
+            lastBytes += px * sizeof(uint16_t);
+        }
+    }
+    display.endWrite();
+    totalBytes += lastBytes;
+    rectCount = 0;
+}
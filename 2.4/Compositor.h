@@ -0,0 +1,87 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <Adafruit_ST7789.h>
+#include <Arduino.h>
+
+struct DirtyRect {
+    int16_t x = 0, y = 0, w = 0, h = 0;
+
+    DirtyRect() {}
+    DirtyRect(int16_t x, int16_t y, int16_t w, int16_t h)
+        : x(x), y(y), w(w), h(h) {}
+
+    bool empty() const { return w <= 0 || h <= 0; }
+    bool touches(const DirtyRect &o) const;
+    void unite(const DirtyRect &o);
+    DirtyRect intersect(const DirtyRect &o) const;
+};
+
+// Something the compositor can paint. render() fills in the part of the
+// widget that falls inside area; buf holds area.w * area.h pixels, row by
+// row, already cleared to the background.
+class Widget {
+  public:
+    virtual ~Widget() {}
+    virtual DirtyRect bounds() const = 0;
+    virtual void render(uint16_t *buf, const DirtyRect &area) = 0;
+};
+
+// A pre-rendered bitmap shown at a movable position.
+class SpriteWidget : public Widget {
+  private:
+    GFXcanvas16 &image;
+    int16_t posX = 0;
+    int16_t posY = 0;
+
+  public:
+    explicit SpriteWidget(GFXcanvas16 &image) : image(image) {}
+    void moveTo(int16_t x, int16_t y) {
+        posX = x;
+        posY = y;
+    }
+    DirtyRect bounds() const override;
+    void render(uint16_t *buf, const DirtyRect &area) override;
+};
+
+// Retained-mode renderer for the parts of the screen that change often.
+// Modes register widgets and mark the regions that changed; flush()
+// rebuilds each region a BAND_H-row strip at a time in a small buffer and
+// streams it out, so nothing is erased on the panel before it is redrawn
+// and no full-size framebuffer is needed.
+class Compositor {
+  public:
+    static const int BAND_H = 16;
+    static const int MAX_WIDGETS = 4;
+
+  private:
+    static const int MAX_RECTS = 8;
+
+    Adafruit_ST7789 &display;
+    uint16_t background;
+    Widget *widgets[MAX_WIDGETS] = {};
+    int widgetCount = 0;
+    DirtyRect rects[MAX_RECTS];
+    int rectCount = 0;
+    uint32_t totalBytes = 0;
+    uint32_t lastBytes = 0;
+
+    void add(DirtyRect r);
+
+  public:
+    Compositor(Adafruit_ST7789 &display, uint16_t background);
+
+    // Widgets belong to the current mode; StateManager clears them on
+    // every switch.
+    void addWidget(Widget &w);
+    void clearWidgets();
+
+    void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+    void markDirty(const DirtyRect &r) { markDirty(r.x, r.y, r.w, r.h); }
+    void flush();
+
+    uint32_t bytesSent() const { return totalBytes; }
+    uint32_t lastFlushBytes() const { return lastBytes; }
+};
+
+#endif
@@ -9,6 +9,21 @@ const char *const NTP_SERVER = "pool.ntp.org";
 const char *const TIME_ZONE = "CET-1CEST,M3.5.0,M10.5.0/3";
 } // namespace Net
 
+// Set to 1 to compile in the profiler (Profiler.h). At 0 every profiling
+// hook compiles to nothing.
+#ifndef CYBER_PROFILE
+#define CYBER_PROFILE 0
+#endif
+
+namespace Debug {
+// Print scheduler task statistics over serial this often (0 = off).
+constexpr unsigned long SCHED_STATS_MS = 0;
+// With CYBER_PROFILE: dump profiler CSV over serial this often (0 = off)
+// and refresh the on-screen overlay once a second.
+constexpr unsigned long PROFILE_DUMP_MS = 10000;
+constexpr bool PROFILE_OVERLAY = true;
+} // namespace Debug
+
 namespace PWM {
 constexpr int CH_LED = 0;
 constexpr int CH_BUZZ = 1;
@@ -40,6 +55,11 @@ constexpr int CX = WIDTH / 2;
 constexpr int CY = HEIGHT / 2;
 } // namespace Screen
 
+namespace Graph {
+constexpr int RANGE_COUNT = 8;
+constexpr int RANGES_MIN[RANGE_COUNT] = {5, 15, 30, 60, 180, 360, 720, 1440};
+} // namespace Graph
+
 namespace Colors {
 constexpr uint16_t BG = ST77XX_BLACK;
 constexpr uint16_t GREEN = 0x07E0;
@@ -67,6 +87,14 @@ constexpr int LBL_TOP_Y = GRID_TOP + 4;
 constexpr int VAL_TOP_Y = GRID_TOP + 14;
 constexpr int LBL_BOT_Y = GRID_MID + 4;
 constexpr int VAL_BOT_Y = GRID_MID + 14;
+constexpr int GRAPH_X = 0;
+constexpr int GRAPH_Y = 145;
+constexpr int GRAPH_W = 320;
+constexpr int GRAPH_H = 90;
+// Menu lists: fixed-pitch rows, LIST_ROWS of them fit under the header
+constexpr int LIST_Y = 60; // centre of the first row
+constexpr int LIST_PITCH = 35;
+constexpr int LIST_ROWS = (Screen::HEIGHT - LIST_Y + LIST_PITCH / 2) / LIST_PITCH;
 } // namespace Layout
 
 #endif
\ No newline at end of file
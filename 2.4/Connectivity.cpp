@@ -0,0 +1,143 @@
+#include "Connectivity.h"
+#include "Hardware.h"
+#include <WiFi.h>
+#include <esp_sntp.h>
+#include <esp_timer.h>
+
+ConnectivityManager Network;
+
+const uint32_t ConnectivityManager::BACKOFF_MAX_MS;
+
+// Overrides the weak default in ESP-IDF's SNTP client, which would step or
+// slew the clock itself.
+extern "C" void sntp_sync_time(struct timeval *tv) {
+    Network.onSync(*tv);
+    sntp_set_sync_status(SNTP_SYNC_STATUS_COMPLETED);
+}
+
+void ConnectivityManager::begin() {
+    WiFi.mode(WIFI_STA);
+    // Retries are paced by update(), not by the driver
+    WiFi.setAutoReconnect(false);
+    connect();
+}
+
+void ConnectivityManager::enter(NetState s) {
+    current = s;
+    stateMs = millis();
+}
+
+void ConnectivityManager::connect() {
+    WiFi.begin(); // the network saved by WiFiManager
+    enter(NET_CONNECTING);
+}
+
+void ConnectivityManager::update() {
+    uint32_t now = millis();
+    bool linked = WiFi.status() == WL_CONNECTED;
+
+    switch (current) {
+    case NET_CONNECTING:
+        if (linked) {
+            backoffMs = BACKOFF_MIN_MS;
+            enter(NET_ONLINE);
+            startSntp();
+        } else if (now - stateMs >= CONNECT_TIMEOUT_MS) {
+            WiFi.disconnect();
+            enter(NET_BACKOFF);
+        }
+        break;
+    case NET_ONLINE:
+        // A dropped link gets one immediate retry before backing off
+        if (!linked)
+            connect();
+        break;
+    case NET_BACKOFF:
+        if (now - stateMs >= backoffMs) {
+            backoffMs = min(backoffMs * 2, BACKOFF_MAX_MS);
+            connect();
+        }
+        break;
+    case NET_SUSPENDED:
+        break;
+    }
+
+    if (now - lastCompensateMs >= DRIFT_PERIOD_MS) {
+        lastCompensateMs = now;
+        compensateDrift();
+    }
+}
+
+void ConnectivityManager::suspend() { enter(NET_SUSPENDED); }
+
+void ConnectivityManager::resume() {
+    if (current != NET_SUSPENDED)
+        return;
+    WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(false);
+    backoffMs = BACKOFF_MIN_MS;
+    if (WiFi.status() == WL_CONNECTED) {
+        enter(NET_ONLINE);
+        startSntp();
+    } else {
+        connect();
+    }
+}
+
+void ConnectivityManager::startSntp() {
+    if (!sntpStarted) {
+        sntp_set_sync_interval(SNTP_INTERVAL_MS);
+        syncTime();
+        sntpStarted = true;
+    } else {
+        // Back online: ask now rather than at the next interval
+        sntp_restart();
+    }
+}
+
+void ConnectivityManager::onSync(const struct timeval &server) {
+    struct timeval local;
+    gettimeofday(&local, NULL);
+    int64_t offsetUs = (int64_t)(server.tv_sec - local.tv_sec) * 1000000LL +
+                       (server.tv_usec - local.tv_usec);
+    int64_t monoUs = esp_timer_get_time();
+    const int64_t stepUs = STEP_LIMIT_MS * 1000LL;
+
+    if (offsetUs > stepUs || offsetUs < -stepUs) {
+        // First sync, or the fallback clock: jump, and measure drift from
+        // here on
+        settimeofday(&server, NULL);
+    } else {
+        struct timeval delta;
+        delta.tv_sec = offsetUs / 1000000;
+        delta.tv_usec = offsetUs % 1000000;
+        adjtime(&delta, NULL);
+        // Whatever the drift compensation did not catch since the last
+        // sync is the error in the estimate. Over less than ten minutes it
+        // is mostly network jitter.
+        int64_t elapsedUs = monoUs - lastSyncUs;
+        if (lastSyncUs != 0 && elapsedUs >= 600LL * 1000000) {
+            float residualPpm = offsetUs * 1e6f / elapsedUs;
+            float d = drift + residualPpm / 2; // damped
+            drift = constrain(d, (float)-DRIFT_MAX_PPM, (float)DRIFT_MAX_PPM);
+        }
+    }
+    lastSyncUs = monoUs;
+    syncCount = syncCount + 1;
+}
+
+void ConnectivityManager::compensateDrift() {
+    float d = drift;
+    if (d == 0 || !synced())
+        return;
+    // ppm times seconds is microseconds; adjtime() replaces any pending
+    // slew, so add what is still outstanding.
+    struct timeval pending;
+    adjtime(NULL, &pending);
+    int64_t us = (int64_t)pending.tv_sec * 1000000LL + pending.tv_usec +
+                 (int64_t)(d * (DRIFT_PERIOD_MS / 1000));
+    struct timeval delta;
+    delta.tv_sec = us / 1000000;
+    delta.tv_usec = us % 1000000;
+    adjtime(&delta, NULL);
+}
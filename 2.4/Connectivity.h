@@ -0,0 +1,70 @@
+#ifndef CONNECTIVITY_H
+#define CONNECTIVITY_H
+
+#include <Arduino.h>
+#include <sys/time.h>
+
+enum NetState : uint8_t {
+    NET_CONNECTING = 0,
+    NET_ONLINE,
+    NET_BACKOFF,   // waiting before the next attempt
+    NET_SUSPENDED, // WiFiSetupMode owns the radio
+};
+
+// Keeps the clock on the network without ever blocking the loop. A small
+// state machine joins the saved WiFi network, retries with exponential
+// backoff when that fails or the link drops, and keeps SNTP running while
+// online.
+//
+// Time corrections go through sntp_sync_time(), overridden in the .cpp:
+// small offsets are slewed with adjtime() instead of stepping the clock,
+// and the offset left after each sync refines an estimate of the RTC's
+// drift, which update() then slews out a little at a time between syncs.
+class ConnectivityManager {
+  public:
+    static const uint32_t CONNECT_TIMEOUT_MS = 15000;
+    static const uint32_t BACKOFF_MIN_MS = 5000;
+    static const uint32_t BACKOFF_MAX_MS = 10UL * 60 * 1000;
+    static const uint32_t SNTP_INTERVAL_MS = 60UL * 60 * 1000;
+    // Offsets larger than this are stepped rather than slewed
+    static const int32_t STEP_LIMIT_MS = 2000;
+    static const uint32_t DRIFT_PERIOD_MS = 60000;
+    static const int32_t DRIFT_MAX_PPM = 500;
+
+    void begin();
+    // Scheduler hook; cheap, never waits on the radio.
+    void update();
+    // Hands the radio to the setup portal and back.
+    void suspend();
+    void resume();
+
+    NetState state() const { return current; }
+    bool online() const { return current == NET_ONLINE; }
+    // Set once any time sync has been received
+    bool synced() const { return syncCount > 0; }
+    float driftPpm() const { return drift; }
+
+    // Called from the SNTP client (lwIP task) with the server's time.
+    void onSync(const struct timeval &server);
+
+  private:
+    NetState current = NET_SUSPENDED;
+    uint32_t stateMs = 0;
+    uint32_t backoffMs = BACKOFF_MIN_MS;
+    bool sntpStarted = false;
+    uint32_t lastCompensateMs = 0;
+
+    // Written by onSync on the lwIP task; single aligned words
+    volatile uint32_t syncCount = 0;
+    volatile float drift = 0;
+    int64_t lastSyncUs = 0;
+
+    void enter(NetState s);
+    void connect();
+    void startSntp();
+    void compensateDrift();
+};
+
+extern ConnectivityManager Network;
+
+#endif
@@ -0,0 +1,144 @@
+#include "DrawList.h"
+#include "Config.h"
+
+namespace {
+const int FONT_W = 6; // 5 px glyph + 1 px spacing
+const int FONT_H = 8;
+
+// Text is first drawn at size 1 into this bitmap, then scaled while it is
+// streamed out.
+const int CANVAS_W = DrawList::MAX_TEXT_CHARS * FONT_W;
+const int CANVAS_ROW_BYTES = (CANVAS_W + 7) / 8;
+GFXcanvas1 textCanvas(CANVAS_W, FONT_H);
+uint16_t line[Screen::WIDTH];
+} // namespace
+
+const int DrawList::MAX_TEXT_CHARS;
+
+DrawList::DrawList(Adafruit_ST7789 &display) : display(display) {}
+
+int16_t DrawList::textWidth(const char *str, uint8_t size) {
+    int len = min((int)strlen(str), MAX_TEXT_CHARS);
+    return len * FONT_W * size;
+}
+
+void DrawList::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color) {
+    if (w <= 0 || h <= 0)
+        return;
+    Cmd c = {CMD_FILL, 0, 0, 0, x, y, w, h, color, color};
+    push(c);
+    commit();
+}
+
+void DrawList::rect(int16_t x, int16_t y, int16_t w, int16_t h,
+                    uint16_t color) {
+    begin();
+    fillRect(x, y, w, 1, color);
+    fillRect(x, y + 1, 1, h - 2, color);
+    fillRect(x + w - 1, y + 1, 1, h - 2, color);
+    fillRect(x, y + h - 1, w, 1, color);
+    end();
+}
+
+void DrawList::text(const char *str, int16_t x, int16_t y, uint8_t size,
+                    uint16_t fg, uint16_t bg) {
+    int len = min((int)strlen(str), MAX_TEXT_CHARS);
+    if (len == 0)
+        return;
+    // Decide on the flush before reserving pool space: push() flushing
+    // afterwards would reset textUsed under this command's offset.
+    if (textUsed + len > TEXT_POOL || cmdCount == MAX_CMDS)
+        flush();
+    Cmd c = {CMD_TEXT, size, (uint8_t)len, (uint16_t)textUsed, x, y,
+             (int16_t)(len * FONT_W * size), (int16_t)(FONT_H * size), fg, bg};
+    memcpy(textPool + textUsed, str, len);
+    textUsed += len;
+    push(c);
+    commit();
+}
+
+void DrawList::push(const Cmd &c) {
+    if (c.type == CMD_FILL && cmdCount > 0) {
+        // Merge with the previous fill when together they form one rect
+        Cmd &p = cmds[cmdCount - 1];
+        if (p.type == CMD_FILL && p.fg == c.fg) {
+            if (p.x == c.x && p.w == c.w &&
+                (p.y + p.h == c.y || c.y + c.h == p.y)) {
+                p.y = min(p.y, c.y);
+                p.h += c.h;
+                return;
+            }
+            if (p.y == c.y && p.h == c.h &&
+                (p.x + p.w == c.x || c.x + c.w == p.x)) {
+                p.x = min(p.x, c.x);
+                p.w += c.w;
+                return;
+            }
+        }
+    }
+    if (cmdCount == MAX_CMDS)
+        flush();
+    cmds[cmdCount++] = c;
+}
+
+void DrawList::commit() {
+    if (depth == 0)
+        flush();
+}
+
+void DrawList::end() {
+    if (depth > 0 && --depth == 0)
+        flush();
+}
+
+void DrawList::flush() {
+    if (cmdCount == 0)
+        return;
+    uint32_t windows = 0;
+    display.startWrite();
+    for (int i = 0; i < cmdCount; i++) {
+        const Cmd &c = cmds[i];
+        if (c.type == CMD_FILL)
+            display.writeFillRect(c.x, c.y, c.w, c.h, c.fg);
+        else
+            sendText(c);
+        windows++;
+    }
+    display.endWrite();
+    cmdCount = 0;
+    textUsed = 0;
+    lastWindows = windows;
+    totalWindows += windows;
+}
+
+void DrawList::sendText(const Cmd &c) {
+    // Clip horizontally to the panel; rows are assumed to be on screen.
+    int16_t x0 = max<int16_t>(c.x, 0);
+    int16_t x1 = min<int16_t>(c.x + c.w, Screen::WIDTH);
+    if (x1 <= x0 || c.y < 0 || c.y + c.h > Screen::HEIGHT)
+        return;
+
+    char str[MAX_TEXT_CHARS + 1];
+    memcpy(str, textPool + c.textOffset, c.textLen);
+    str[c.textLen] = '\0';
+    textCanvas.fillScreen(0);
+    textCanvas.setTextWrap(false);
+    textCanvas.setTextSize(1);
+    textCanvas.setTextColor(1);
+    textCanvas.setCursor(0, 0);
+    textCanvas.print(str);
+
+    const uint8_t *bits = textCanvas.getBuffer();
+    int16_t w = x1 - x0;
+    display.setAddrWindow(x0, c.y, w, c.h);
+    for (int row = 0; row < FONT_H; row++) {
+        const uint8_t *src = bits + row * CANVAS_ROW_BYTES;
+        for (int16_t i = 0; i < w; i++) {
+            int16_t col = (x0 - c.x + i) / c.size;
+            line[i] = (src[col >> 3] & (0x80 >> (col & 7))) ? c.fg : c.bg;
+        }
+        for (int rep = 0; rep < c.size; rep++)
+            display.writePixels(line, w);
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+#include <Adafruit_ST7789.h>
+#include <Arduino.h>
+
+// Records fills and opaque text and sends them to the panel in one SPI
+// transaction. Adjacent fills of the same colour are merged into a single
+// address window, and each text run goes out as one window rasterised a
+// line at a time, instead of GFX's one window per font pixel.
+//
+// Outside a batch every call is sent immediately; inside begin()/end()
+// (or a DrawBatch) commands queue until the outermost end(). Code that
+// draws on the display directly while a batch is open must flush() first
+// to keep the painting order.
+class DrawList {
+  public:
+    static const int MAX_CMDS = 32;
+    static const int TEXT_POOL = 256;
+    static const int MAX_TEXT_CHARS = 53; // a full screen width at size 1
+
+    explicit DrawList(Adafruit_ST7789 &display);
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void rect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void text(const char *str, int16_t x, int16_t y, uint8_t size,
+              uint16_t fg, uint16_t bg);
+
+    void begin() { depth++; }
+    void end();
+    void flush();
+
+    // Width in pixels of str in the built-in 6x8 font.
+    static int16_t textWidth(const char *str, uint8_t size);
+
+    uint32_t windowsSent() const { return totalWindows; }
+    uint32_t lastFlushWindows() const { return lastWindows; }
+
+  private:
+    enum CmdType : uint8_t { CMD_FILL, CMD_TEXT };
+    struct Cmd {
+        CmdType type;
+        uint8_t size;
+        uint8_t textLen;
+        uint16_t textOffset;
+        int16_t x, y, w, h;
+        uint16_t fg, bg;
+    };
+
+    Adafruit_ST7789 &display;
+    Cmd cmds[MAX_CMDS];
+    int cmdCount = 0;
+    char textPool[TEXT_POOL];
+    int textUsed = 0;
+    int depth = 0;
+    uint32_t totalWindows = 0;
+    uint32_t lastWindows = 0;
+
+    void push(const Cmd &c);
+    void commit();
+    void sendText(const Cmd &c);
+};
+
+// Scoped begin()/end().
+class DrawBatch {
+  public:
+    explicit DrawBatch(DrawList &list) : list(list) { list.begin(); }
+    ~DrawBatch() { list.end(); }
+
+  private:
+    DrawList &list;
+};
+
+#endif
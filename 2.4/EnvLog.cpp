@@ -0,0 +1,358 @@
+#include "EnvLog.h"
+#include <LittleFS.h>
+#include <esp_rom_crc.h>
+
+EnvLog Log;
+
+namespace {
+const char *const DIR = "/envlog";
+// Outside DIR, where every file is a segment
+const char *const JOURNAL = "/envlog.jrn";
+const uint16_t MAGIC = 0xE106;
+
+void segmentPath(char *out, size_t len, uint16_t seg) {
+    snprintf(out, len, "%s/%05u.seg", DIR, (unsigned)seg);
+}
+
+void put16(uint8_t *p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+void put32(uint8_t *p, uint32_t v) {
+    put16(p, v);
+    put16(p + 2, v >> 16);
+}
+uint16_t get16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+uint32_t get32(const uint8_t *p) {
+    return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+int putVarint(uint8_t *p, uint32_t v) {
+    int n = 0;
+    while (v >= 0x80) {
+        p[n++] = (v & 0x7F) | 0x80;
+        v >>= 7;
+    }
+    p[n++] = v;
+    return n;
+}
+
+// Returns bytes consumed, 0 if the varint runs past end.
+int getVarint(const uint8_t *p, const uint8_t *end, uint32_t &v) {
+    v = 0;
+    for (int n = 0, shift = 0; p + n < end && shift < 35; shift += 7) {
+        uint8_t b = p[n++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return n;
+    }
+    return 0;
+}
+
+uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+// Applies one delta-coded record to r; returns bytes consumed, 0 if it
+// runs past end.
+int getDelta(const uint8_t *p, const uint8_t *end, EnvRecord &r) {
+    uint32_t v;
+    int used = getVarint(p, end, v);
+    if (used == 0)
+        return 0;
+    EnvRecord next = r;
+    next.time += v;
+    for (int c = 0; c < HIST_CHANNELS; c++) {
+        int n = getVarint(p + used, end, v);
+        if (n == 0)
+            return 0;
+        used += n;
+        next.values[c] += unzigzag(v);
+    }
+    r = next;
+    return used;
+}
+} // namespace
+
+bool EnvLog::begin() {
+    if (!LittleFS.begin(true)) {
+        Serial.println("LittleFS mount failed; history not persisted");
+        return false;
+    }
+    mounted = true;
+    if (!LittleFS.exists(DIR))
+        LittleFS.mkdir(DIR);
+
+    // Segment names are increasing numbers; find the live range
+    bool any = false;
+    File dir = LittleFS.open(DIR);
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        const char *name = strrchr(f.name(), '/');
+        uint16_t seg = (uint16_t)atoi(name ? name + 1 : f.name());
+        if (!any || (int16_t)(seg - firstSegment) < 0)
+            firstSegment = seg;
+        if (!any || (int16_t)(seg - lastSegment) > 0)
+            lastSegment = seg;
+        any = true;
+    }
+    if (!any) {
+        firstSegment = lastSegment = 0;
+    } else {
+        for (uint16_t seg = firstSegment;; seg++) {
+            scanSegment(seg);
+            if (seg == lastSegment)
+                break;
+        }
+    }
+    findNewest();
+    recoverJournal();
+    return true;
+}
+
+// The index only knows block starts; read the last block for the end.
+void EnvLog::findNewest() {
+    if (indexCount > 0)
+        replay(index[indexCount - 1].start,
+               [](const EnvRecord &r) { Log.newest = r.time; });
+}
+
+// A journal still here means the block it holds was never written: make
+// it a block of its own, up to the last whole record.
+void EnvLog::recoverJournal() {
+    File f = LittleFS.open(JOURNAL, "r");
+    if (!f)
+        return;
+    uint8_t raw[RAW_RECORD_BYTES];
+    bool ok = f.read(raw, RAW_RECORD_BYTES) == RAW_RECORD_BYTES;
+    int len = ok ? (int)f.read(payload, MAX_PAYLOAD) : 0;
+    f.close();
+    LittleFS.remove(JOURNAL);
+    if (!ok)
+        return;
+    first.time = get32(raw);
+    for (int c = 0; c < HIST_CHANNELS; c++)
+        first.values[c] = get16(raw + 4 + 2 * c);
+    // Already in the log if power went between the block and the removal
+    if (first.time <= newest)
+        return;
+    EnvRecord r = first;
+    recordCount = 1;
+    payloadLen = 0;
+    for (int n; (n = getDelta(payload + payloadLen, payload + len, r)) > 0;) {
+        payloadLen += n;
+        recordCount++;
+    }
+    writeBlock();
+    findNewest();
+}
+
+void EnvLog::scanSegment(uint16_t seg) {
+    char path[24];
+    segmentPath(path, sizeof(path), seg);
+    File f = LittleFS.open(path, "r");
+    if (!f)
+        return;
+    int blocks = 0;
+    size_t size = f.size();
+    uint8_t hdr[HEADER_BYTES];
+    while (f.position() + HEADER_BYTES <= size) {
+        uint32_t offset = f.position();
+        if (f.read(hdr, HEADER_BYTES) != HEADER_BYTES || get16(hdr) != MAGIC)
+            break;
+        uint16_t len = get16(hdr + 3);
+        if (offset + HEADER_BYTES + len > size || len > MAX_PAYLOAD)
+            break;
+        if (indexCount < MAX_SEGMENTS * BLOCKS_PER_SEGMENT)
+            index[indexCount++] = {get32(hdr + 7), seg, (uint16_t)offset};
+        f.seek(offset + HEADER_BYTES + len);
+        blocks++;
+    }
+    bool torn = f.position() != size;
+    f.close();
+    // Never append after a torn block; the next block opens a new file.
+    if (seg == lastSegment)
+        lastSegmentBlocks = torn ? BLOCKS_PER_SEGMENT : blocks;
+}
+
+void EnvLog::addSample(const uint16_t values[HIST_CHANNELS], uint32_t now) {
+    if (!mounted || now == 0)
+        return;
+    uint32_t m = now - now % RECORD_SECONDS;
+    if (m != minute)
+        closeMinute();
+    minute = m;
+    for (int c = 0; c < HIST_CHANNELS; c++)
+        sums[c] += values[c];
+    sampleCount++;
+}
+
+void EnvLog::closeMinute() {
+    if (sampleCount == 0)
+        return;
+    EnvRecord r;
+    r.time = minute;
+    for (int c = 0; c < HIST_CHANNELS; c++) {
+        r.values[c] = (sums[c] + sampleCount / 2) / sampleCount;
+        sums[c] = 0;
+    }
+    sampleCount = 0;
+    append(r);
+}
+
+void EnvLog::append(const EnvRecord &r) {
+    // Keep the whole log ordered, across reboots too: the block index is
+    // binary searched. A clock behind the log only resumes logging once it
+    // has caught up.
+    if (r.time <= newest)
+        return;
+    if (recordCount == 0) {
+        first = r;
+    } else {
+        uint8_t *p = payload + payloadLen;
+        p += putVarint(p, r.time - prev.time);
+        for (int c = 0; c < HIST_CHANNELS; c++)
+            p += putVarint(p, zigzag((int32_t)r.values[c] - prev.values[c]));
+        payloadLen = p - payload;
+    }
+    prev = r;
+    recordCount++;
+    newest = r.time;
+    if (recordCount == MAX_RECORDS ||
+        payloadLen + MAX_RECORD_BYTES > MAX_PAYLOAD)
+        writeBlock();
+    else if (recordCount - journaledRecords >= JOURNAL_RECORDS)
+        writeJournal();
+}
+
+// Appends the records not yet journaled: the first one raw, the rest as
+// the payload bytes the block will hold.
+void EnvLog::writeJournal() {
+    File f = LittleFS.open(JOURNAL, journaledRecords == 0 ? "w" : "a");
+    if (!f)
+        return;
+    if (journaledRecords == 0) {
+        uint8_t raw[RAW_RECORD_BYTES];
+        put32(raw, first.time);
+        for (int c = 0; c < HIST_CHANNELS; c++)
+            put16(raw + 4 + 2 * c, first.values[c]);
+        f.write(raw, RAW_RECORD_BYTES);
+    }
+    f.write(payload + journaledBytes, payloadLen - journaledBytes);
+    f.close();
+    journaledRecords = recordCount;
+    journaledBytes = payloadLen;
+}
+
+void EnvLog::flush() {
+    closeMinute();
+    if (recordCount > 0)
+        writeBlock();
+}
+
+void EnvLog::writeBlock() {
+    uint8_t hdr[HEADER_BYTES];
+    put16(hdr, MAGIC);
+    hdr[2] = recordCount;
+    put16(hdr + 3, payloadLen);
+    put16(hdr + 5, esp_rom_crc16_le(0, payload, payloadLen));
+    put32(hdr + 7, first.time);
+    for (int c = 0; c < HIST_CHANNELS; c++)
+        put16(hdr + 11 + 2 * c, first.values[c]);
+
+    if (lastSegmentBlocks >= BLOCKS_PER_SEGMENT) {
+        lastSegment++;
+        lastSegmentBlocks = 0;
+        if ((uint16_t)(lastSegment - firstSegment) >= MAX_SEGMENTS)
+            dropOldestSegment();
+    }
+    char path[24];
+    segmentPath(path, sizeof(path), lastSegment);
+    File f = LittleFS.open(path, "a");
+    if (f) {
+        uint32_t offset = f.size();
+        f.write(hdr, HEADER_BYTES);
+        f.write(payload, payloadLen);
+        f.close();
+        if (indexCount == MAX_SEGMENTS * BLOCKS_PER_SEGMENT)
+            dropOldestSegment();
+        index[indexCount++] = {first.time, lastSegment, (uint16_t)offset};
+        lastSegmentBlocks++;
+    }
+    recordCount = 0;
+    payloadLen = 0;
+    if (journaledRecords > 0)
+        LittleFS.remove(JOURNAL);
+    journaledRecords = 0;
+    journaledBytes = 0;
+}
+
+void EnvLog::dropOldestSegment() {
+    char path[24];
+    segmentPath(path, sizeof(path), firstSegment);
+    LittleFS.remove(path);
+    int n = 0;
+    while (n < indexCount && index[n].segment == firstSegment)
+        n++;
+    memmove(index, index + n, (indexCount - n) * sizeof(IndexEntry));
+    indexCount -= n;
+    firstSegment++;
+}
+
+// Last block starting at or before time, or 0 if time precedes the log.
+int EnvLog::findBlock(uint32_t time) const {
+    int lo = 0, hi = indexCount;
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (index[mid].start <= time)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void EnvLog::replay(uint32_t from, void (*fn)(const EnvRecord &r)) {
+    if (!mounted)
+        return;
+    File f;
+    uint16_t openSeg = 0;
+    char path[24];
+    uint8_t hdr[HEADER_BYTES];
+    uint8_t buf[MAX_PAYLOAD];
+    for (int i = indexCount > 0 ? findBlock(from) : 0; i < indexCount; i++) {
+        const IndexEntry &e = index[i];
+        if (!f || openSeg != e.segment) {
+            if (f)
+                f.close();
+            segmentPath(path, sizeof(path), e.segment);
+            f = LittleFS.open(path, "r");
+            openSeg = e.segment;
+            if (!f)
+                continue;
+        }
+        f.seek(e.offset);
+        if (f.read(hdr, HEADER_BYTES) != HEADER_BYTES)
+            continue;
+        uint16_t len = get16(hdr + 3);
+        if (len > MAX_PAYLOAD || f.read(buf, len) != len ||
+            esp_rom_crc16_le(0, buf, len) != get16(hdr + 5))
+            continue; // damaged block: skip it, keep the rest
+
+        EnvRecord r;
+        r.time = get32(hdr + 7);
+        for (int c = 0; c < HIST_CHANNELS; c++)
+            r.values[c] = get16(hdr + 11 + 2 * c);
+        const uint8_t *p = buf, *end = buf + len;
+        for (int k = 0; k < hdr[2]; k++) {
+            if (k > 0) {
+                int n = getDelta(p, end, r);
+                if (n == 0)
+                    break;
+                p += n;
+            }
+            if (r.time >= from)
+                fn(r);
+        }
+    }
+    if (f)
+        f.close();
+}
@@ -0,0 +1,101 @@
+#ifndef ENVLOG_H
+#define ENVLOG_H
+
+#include "HistoryPyramid.h"
+#include <Arduino.h>
+
+// One logged minute: the mean of every history sample taken in it.
+struct EnvRecord {
+    uint32_t time; // Unix seconds, start of the minute
+    uint16_t values[HIST_CHANNELS];
+};
+
+// Append-only log of EnvRecords on LittleFS, kept across reboots.
+//
+// Records are packed into blocks of up to MAX_RECORDS: a fixed header with
+// the first record, then each further record as varint deltas (time
+// step, then zigzag per channel), usually 5 bytes a minute. A block is
+// written in one append when it fills (or on flush()), and blocks go into
+// segment files of BLOCKS_PER_SEGMENT; the oldest segment is deleted once
+// MAX_SEGMENTS exist, which bounds flash use and leaves wear levelling to
+// LittleFS. A RAM index of block start times, built on mount, finds the
+// block holding a timestamp by binary search.
+//
+// The block being filled is journaled to a side file every
+// JOURNAL_RECORDS minutes, appending only what is new, and begin() turns
+// a journal left by a power loss into a block. So an unclean shutdown
+// loses at most JOURNAL_RECORDS minutes rather than a whole block.
+//
+// Capacity: 8 segments * 64 blocks of up to 48 minutes, about two weeks
+// of data in ~120 KB.
+class EnvLog {
+  public:
+    static const uint32_t RECORD_SECONDS = 60;
+    static const int MAX_RECORDS = 48;
+    static const int BLOCKS_PER_SEGMENT = 64;
+    static const int MAX_SEGMENTS = 8;
+    static const int JOURNAL_RECORDS = 5;
+
+    // Mounts the filesystem and indexes the existing blocks.
+    bool begin();
+    // Feeds one history sample; emits a record at each minute boundary of
+    // the wall clock. Pass now = 0 while the clock has not been synced
+    // (the fallback clock included); those samples are not logged.
+    void addSample(const uint16_t values[HIST_CHANNELS], uint32_t now);
+    // Writes the current minute and the partly filled block now, e.g.
+    // before a restart.
+    void flush();
+
+    uint32_t newestTime() const { return newest; }
+    // Calls fn for every record on flash at or after from, oldest first.
+    void replay(uint32_t from, void (*fn)(const EnvRecord &r));
+
+  private:
+    static const int HEADER_BYTES = 19;
+    static const int MAX_PAYLOAD = 256 - HEADER_BYTES;
+    static const int MAX_RECORD_BYTES = 5 + HIST_CHANNELS * 3;
+    static const int RAW_RECORD_BYTES = 4 + HIST_CHANNELS * 2;
+
+    struct IndexEntry {
+        uint32_t start;
+        uint16_t segment;
+        uint16_t offset;
+    };
+
+    bool mounted = false;
+    IndexEntry index[MAX_SEGMENTS * BLOCKS_PER_SEGMENT];
+    int indexCount = 0;
+    uint16_t firstSegment = 0;
+    uint16_t lastSegment = 0;
+    int lastSegmentBlocks = 0;
+    uint32_t newest = 0;
+
+    // Block being filled
+    EnvRecord first;
+    EnvRecord prev;
+    uint8_t payload[MAX_PAYLOAD];
+    int payloadLen = 0;
+    int recordCount = 0;
+    // How much of it the journal holds
+    int journaledRecords = 0;
+    int journaledBytes = 0;
+
+    // Minute being averaged
+    uint32_t minute = 0;
+    uint32_t sums[HIST_CHANNELS] = {};
+    uint16_t sampleCount = 0;
+
+    void closeMinute();
+    void append(const EnvRecord &r);
+    void writeBlock();
+    void writeJournal();
+    void recoverJournal();
+    void findNewest();
+    void scanSegment(uint16_t seg);
+    void dropOldestSegment();
+    int findBlock(uint32_t time) const;
+};
+
+extern EnvLog Log;
+
+#endif
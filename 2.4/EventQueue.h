@@ -0,0 +1,49 @@
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Lock-free single-producer/single-consumer ring. The producer only
+// advances head and the consumer only advances tail, so an ISR can push
+// while the loop pops without disabling interrupts. N must be a power of
+// two no larger than 128 so the 8-bit indices wrap cleanly.
+template <typename T, uint8_t N> class EventQueue {
+    static_assert(N > 0 && N <= 128 && (N & (N - 1)) == 0,
+                  "N must be a power of two <= 128");
+
+  private:
+    T items[N];
+    std::atomic<uint8_t> head{0};
+    std::atomic<uint8_t> tail{0};
+    volatile uint16_t dropped = 0;
+
+  public:
+    bool IRAM_ATTR push(const T &item) {
+        uint8_t h = head.load(std::memory_order_relaxed);
+        if ((uint8_t)(h - tail.load(std::memory_order_acquire)) == N) {
+            dropped = dropped + 1;
+            return false;
+        }
+        items[h % N] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &out) {
+        uint8_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+        out = items[t % N];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_relaxed) ==
+               head.load(std::memory_order_acquire);
+    }
+    uint16_t droppedCount() const { return dropped; }
+};
+
+#endif
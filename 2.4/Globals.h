@@ -1,8 +1,11 @@
 #ifndef GLOBALS_H
 #define GLOBALS_H
 
+#include "Compositor.h"
 #include "Config.h"
+#include "DrawList.h"
 #include "InputManager.h"
+#include "Profiler.h"
 #include "Types.h"
 #include <Adafruit_AHTX0.h>
 #include <Adafruit_ST7789.h>
@@ -10,8 +13,9 @@
 #include <ScioSense_ENS160.h>
 #include <WiFiManager.h>
 
-extern Adafruit_ST7789 tft;
-extern GFXcanvas16 graphCanvas;
+extern Display tft;
+extern Compositor compositor;
+extern DrawList drawList;
 extern Adafruit_AHTX0 aht;
 extern ScioSense_ENS160 ens160;
 extern Preferences prefs;
@@ -19,12 +23,9 @@ extern WiFiManager wm;
 
 extern AppSettings settings;
 extern EnvData env;
-extern PomodoroContext pomo;
 extern UIContext ui;
 extern InputManager Input;
 
-extern const int GRAPH_RANGES_MIN[];
-extern const int GRAPH_RANGES_COUNT;
 extern uint16_t dvdPalette[];
 
 #endif
\ No newline at end of file
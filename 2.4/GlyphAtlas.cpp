@@ -0,0 +1,79 @@
+#include "GlyphAtlas.h"
+#include "Globals.h"
+
+namespace GlyphAtlas {
+namespace {
+const char CHARS[] = "0123456789:- ";
+const int COUNT = sizeof(CHARS) - 1;
+const int ROW_BYTES = (CELL_W + 7) / 8;
+const int GLYPH_BYTES = ROW_BYTES * CELL_H;
+
+uint8_t atlas[COUNT][GLYPH_BYTES];
+bool built = false;
+
+void build() {
+    // Let GFX do the scaling once; keep the result as packed bits.
+    GFXcanvas1 cell(CELL_W, CELL_H);
+    for (int i = 0; i < COUNT; i++) {
+        cell.fillScreen(0);
+        cell.drawChar(0, 0, CHARS[i], 1, 0, SCALE);
+        memcpy(atlas[i], cell.getBuffer(), GLYPH_BYTES);
+    }
+    built = true;
+}
+
+int indexOf(char c) {
+    for (int i = 0; i < COUNT; i++)
+        if (CHARS[i] == c)
+            return i;
+    return COUNT - 1; // unknown characters render blank
+}
+} // namespace
+
+void drawChar(Adafruit_ST7789 &display, int16_t x, int16_t y, char c,
+              uint16_t fg, uint16_t bg) {
+    if (!built)
+        build();
+    const uint8_t *bits = atlas[indexOf(c)];
+    uint16_t line[CELL_W];
+    display.startWrite();
+    display.setAddrWindow(x, y, CELL_W, CELL_H);
+    for (int row = 0; row < CELL_H; row++) {
+        const uint8_t *src = bits + row * ROW_BYTES;
+        for (int col = 0; col < CELL_W; col++)
+            line[col] = (src[col >> 3] & (0x80 >> (col & 7))) ? fg : bg;
+        display.writePixels(line, CELL_W);
+    }
+    display.endWrite();
+}
+} // namespace GlyphAtlas
+
+const int BigText::MAX_LEN;
+
+void BigText::draw(const char *str, int16_t x, int16_t y, uint16_t fg,
+                   uint16_t bg) {
+    int len = min((int)strlen(str), MAX_LEN);
+    int shownLen = strlen(shown);
+    bool moved = x != shownX || y != shownY || len != shownLen;
+    bool full = moved || fg != shownFg || bg != shownBg;
+    if (moved && shownLen > 0)
+        tft.fillRect(shownX, shownY, shownLen * GlyphAtlas::CELL_W,
+                     GlyphAtlas::CELL_H, bg);
+    for (int i = 0; i < len; i++) {
+        if (full || shown[i] != str[i])
+            GlyphAtlas::drawChar(tft, x + i * GlyphAtlas::CELL_W, y, str[i],
+                                 fg, bg);
+        shown[i] = str[i];
+    }
+    shown[len] = '\0';
+    shownX = x;
+    shownY = y;
+    shownFg = fg;
+    shownBg = bg;
+}
+
+void BigText::drawCentered(const char *str, int16_t y, uint16_t fg,
+                           uint16_t bg) {
+    int len = min((int)strlen(str), MAX_LEN);
+    draw(str, (Screen::WIDTH - len * GlyphAtlas::CELL_W) / 2, y, fg, bg);
+}
@@ -0,0 +1,38 @@
+#ifndef GLYPHATLAS_H
+#define GLYPHATLAS_H
+
+#include <Adafruit_ST7789.h>
+#include <Arduino.h>
+
+// Pre-scaled 1-bit bitmaps of the characters used by the big size-6
+// readouts (clock, Pomodoro timer). A glyph goes out as a single address
+// window of pixel runs instead of one fillRect per font pixel.
+namespace GlyphAtlas {
+constexpr int SCALE = 6;
+constexpr int CELL_W = 6 * SCALE;
+constexpr int CELL_H = 8 * SCALE;
+
+void drawChar(Adafruit_ST7789 &display, int16_t x, int16_t y, char c,
+              uint16_t fg, uint16_t bg);
+} // namespace GlyphAtlas
+
+// A line of big text that remembers what is on screen and only redraws
+// the cells that changed.
+class BigText {
+  private:
+    static const int MAX_LEN = 10;
+    char shown[MAX_LEN + 1] = "";
+    int16_t shownX = -1;
+    int16_t shownY = -1;
+    uint16_t shownFg = 0;
+    uint16_t shownBg = 0;
+
+  public:
+    void draw(const char *str, int16_t x, int16_t y, uint16_t fg,
+              uint16_t bg);
+    void drawCentered(const char *str, int16_t y, uint16_t fg, uint16_t bg);
+    // Forget the on-screen state, e.g. after the screen was cleared.
+    void invalidate() { shown[0] = '\0'; }
+};
+
+#endif
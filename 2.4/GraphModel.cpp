@@ -0,0 +1,105 @@
+#include "GraphModel.h"
+
+namespace {
+struct ChannelRange {
+    uint16_t lo;
+    uint16_t hi;
+    uint16_t step;    // autoscaled bounds are multiples of this
+    uint16_t minSpan; // autoscaled ranges are never narrower
+};
+
+// Raw units as stored in the pyramid; temperature is in tenths of a degree.
+const ChannelRange RANGES[HIST_CHANNELS] = {
+    {100, 400, 10, 30},   // HIST_TEMP, 10..40 C
+    {0, 100, 5, 10},      // HIST_HUM, %
+    {0, 1500, 50, 100},   // HIST_TVOC, ppb
+    {400, 2000, 50, 200}, // HIST_CO2, ppm
+};
+
+uint32_t stepQ16(uint16_t lo, uint16_t hi) {
+    return ((uint32_t)(GraphModel::Y_BOT - GraphModel::Y_TOP) << 16) /
+           (hi - lo);
+}
+} // namespace
+
+uint8_t GraphModel::scale(int ch, uint16_t v) const {
+    const ChannelScale &s = scales[ch];
+    uint16_t c = v < s.lo ? s.lo : (v > s.hi ? s.hi : v);
+    return Y_BOT - (uint8_t)(((uint32_t)(c - s.lo) * s.stepQ16) >> 16);
+}
+
+void GraphModel::load(const HistoryPyramid &hist, int i) {
+    GraphPoint &p = points[i];
+    for (int c = 0; c < HIST_CHANNELS; c++) {
+        HistBucket b = hist.at(shownLevel, c, i);
+        p.mean[c] = scale(c, b.mean);
+        p.top[c] = scale(c, b.hi);
+        p.bot[c] = scale(c, b.lo);
+    }
+}
+
+void GraphModel::reloadAll(const HistoryPyramid &hist) {
+    for (int i = 0; i < LEN; i++)
+        load(hist, i);
+}
+
+// Recomputes every channel's range; returns true if any changed.
+bool GraphModel::updateScales() {
+    bool changed = false;
+    for (int c = 0; c < HIST_CHANNELS; c++) {
+        const ChannelRange &r = RANGES[c];
+        uint16_t lo = r.lo, hi = r.hi;
+        if (autoScale && !window[c].empty()) {
+            lo = window[c].min() / r.step * r.step;
+            hi = (window[c].max() + r.step - 1) / r.step * r.step;
+            if (hi - lo < r.minSpan) {
+                uint16_t grow = (r.minSpan - (hi - lo)) / 2 / r.step * r.step;
+                lo = lo > grow ? lo - grow : 0;
+                hi = lo + r.minSpan;
+            }
+        }
+        ChannelScale &s = scales[c];
+        if (s.lo != lo || s.hi != hi || s.stepQ16 == 0) {
+            s.lo = lo;
+            s.hi = hi;
+            s.stepQ16 = stepQ16(lo, hi);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void GraphModel::select(const HistoryPyramid &hist, int level,
+                        bool autoScale) {
+    if (level == shownLevel && autoScale == this->autoScale)
+        return;
+    shownLevel = level;
+    this->autoScale = autoScale;
+    // Refill the windows from the buckets that hold data; the rest read
+    // as zero and would pin every minimum to 0.
+    for (int c = 0; c < HIST_CHANNELS; c++) {
+        window[c].clear();
+        for (int i = LEN - hist.count(level); i < LEN; i++) {
+            HistBucket b = hist.at(level, c, i);
+            window[c].push(b.lo, b.hi);
+        }
+    }
+    updateScales();
+    reloadAll(hist);
+}
+
+GraphChange GraphModel::onAdd(const HistoryPyramid &hist, uint8_t closed) {
+    if (shownLevel < 0 || !(closed & (1 << shownLevel)))
+        return GRAPH_UNCHANGED;
+    for (int c = 0; c < HIST_CHANNELS; c++) {
+        HistBucket b = hist.at(shownLevel, c, LEN - 1);
+        window[c].push(b.lo, b.hi);
+    }
+    if (updateScales()) {
+        reloadAll(hist);
+        return GRAPH_RESCALED;
+    }
+    memmove(points, points + 1, (LEN - 1) * sizeof(GraphPoint));
+    load(hist, LEN - 1);
+    return GRAPH_SHIFTED;
+}
@@ -0,0 +1,69 @@
+#ifndef GRAPHMODEL_H
+#define GRAPHMODEL_H
+
+#include "HistoryPyramid.h"
+#include "RollingMinMax.h"
+#include <Arduino.h>
+
+// Graph rows of one pyramid bucket per channel, 0 at the top.
+struct GraphPoint {
+    uint8_t mean[HIST_CHANNELS];
+    uint8_t top[HIST_CHANNELS]; // row of the bucket's highest value
+    uint8_t bot[HIST_CHANNELS]; // row of the bucket's lowest value
+};
+
+// What onAdd() changed.
+enum GraphChange : uint8_t {
+    GRAPH_UNCHANGED = 0,
+    GRAPH_SHIFTED,  // one new point at LEN - 1, the rest moved left
+    GRAPH_RESCALED, // a channel's range changed; every point moved
+};
+
+// Screen-space copy of the pyramid level the graph shows. Each bucket is
+// scaled once, when the pyramid closes it, with per-channel fixed-point
+// factors, so redrawing the graph only reads small integers.
+//
+// With autoscaling, each channel's range follows the min/max of the
+// visible window (rounded to a step and kept above a minimum span so
+// noise is not blown up); otherwise the fixed ranges are used.
+class GraphModel {
+  public:
+    static const int LEN = HistoryPyramid::LEN;
+    static const uint8_t Y_TOP = 2;
+    static const uint8_t Y_BOT = Layout::GRAPH_H - 2;
+
+    // Switches to level and scaling mode, rescaling every bucket if either
+    // differs from what is shown so far.
+    void select(const HistoryPyramid &hist, int level, bool autoScale);
+    // Forces the next select() to reload, after the pyramid was refilled
+    // behind the model's back.
+    void invalidate() { shownLevel = -1; }
+    // Call with the mask returned by HistoryPyramid::add.
+    GraphChange onAdd(const HistoryPyramid &hist, uint8_t closed);
+
+    int level() const { return shownLevel; }
+    const GraphPoint &at(int i) const { return points[i]; }
+    // Current range of a channel in raw pyramid units.
+    uint16_t rangeLo(int ch) const { return scales[ch].lo; }
+    uint16_t rangeHi(int ch) const { return scales[ch].hi; }
+
+  private:
+    struct ChannelScale {
+        uint16_t lo;
+        uint16_t hi;
+        uint32_t stepQ16; // rows per unit, 16.16 fixed point
+    };
+
+    GraphPoint points[LEN];
+    ChannelScale scales[HIST_CHANNELS] = {};
+    RollingMinMax<LEN> window[HIST_CHANNELS];
+    int shownLevel = -1;
+    bool autoScale = false;
+
+    uint8_t scale(int ch, uint16_t v) const;
+    void load(const HistoryPyramid &hist, int i);
+    void reloadAll(const HistoryPyramid &hist);
+    bool updateScales();
+};
+
+#endif
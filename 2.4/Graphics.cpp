@@ -1,64 +1,59 @@
 #include "Graphics.h"
+#include "AlarmEngine.h"
+#include "GlyphAtlas.h"
+
+static BigText clockText;
 
 namespace UI {
 void clear(uint16_t bgColor) {
+    drawList.flush();
     tft.fillScreen(bgColor);
     if (bgColor == Colors::BG)
         drawAlarmIcon();
 }
 
-void drawHeader(String title) {
+void drawHeader(const char *title) {
     clear();
     textCentered(title, 40, 2, Colors::LIGHT);
 }
 
-void text(String str, int x, int y, int size, uint16_t color, uint16_t bg) {
-    tft.setTextSize(size);
-    tft.setTextColor(color, bg);
-    tft.setCursor(x, y);
-    tft.print(str);
+void text(const char *str, int x, int y, int size, uint16_t color, uint16_t bg) {
+    drawList.text(str, x, y, size, color, bg);
 }
 
-void textCentered(String str, int y, int size, uint16_t color, uint16_t bg) {
-    int16_t x1, y1;
-    uint16_t w, h;
-    tft.setTextSize(size);
-    tft.getTextBounds(str, 0, 0, &x1, &y1, &w, &h);
-    tft.setCursor((Screen::WIDTH - w) / 2, y);
-    tft.setTextColor(color, bg);
-    tft.print(str);
+void textCentered(const char *str, int y, int size, uint16_t color, uint16_t bg) {
+    int w = DrawList::textWidth(str, size);
+    text(str, (Screen::WIDTH - w) / 2, y, size, color, bg);
 }
 
-void textCenteredX(String str, int x_start, int x_end, int y, int size,
+void textCenteredX(const char *str, int x_start, int x_end, int y, int size,
                    uint16_t color, uint16_t bg) {
-    int16_t x1, y1;
-    uint16_t w, h;
-    tft.setTextSize(size);
-    tft.getTextBounds(str, 0, 0, &x1, &y1, &w, &h);
-    int x = x_start + ((x_end - x_start) - (int)w) / 2;
+    int w = DrawList::textWidth(str, size);
+    int x = x_start + ((x_end - x_start) - w) / 2;
     text(str, x, y, size, color, bg);
 }
 
 void drawBar(int x, int y, int w, int h, int percent, uint16_t color,
              int &prevW) {
+    DrawBatch batch(drawList);
     if (prevW == -1) {
-        tft.drawRect(x - 1, y - 1, w + 2, h + 2, ST77XX_WHITE);
-        tft.fillRect(x, y, w, h, Colors::DARK);
+        drawList.rect(x - 1, y - 1, w + 2, h + 2, ST77XX_WHITE);
+        drawList.fillRect(x, y, w, h, Colors::DARK);
         prevW = 0;
     }
     int targetW = (int)((float)w * (percent / 100.0f));
     if (targetW != prevW) {
         if (targetW > prevW)
-            tft.fillRect(x + prevW, y, targetW - prevW, h, color);
+            drawList.fillRect(x + prevW, y, targetW - prevW, h, color);
         else
-            tft.fillRect(x + targetW, y, prevW - targetW, h, Colors::DARK);
+            drawList.fillRect(x + targetW, y, prevW - targetW, h,
+                              Colors::DARK);
         prevW = targetW;
     }
 }
 
-void drawListItem(int index, int selectedIndex, const char *label,
-                  bool fullRedraw) {
-    int rowCenterY = 60 + index * 35;
+void drawListItem(int row, bool selected, const char *label) {
+    int rowCenterY = Layout::LIST_Y + row * Layout::LIST_PITCH;
     int boxY = rowCenterY - 14;
     int boxH = 28;
     int boxW = 300;
@@ -66,12 +61,12 @@ void drawListItem(int index, int selectedIndex, const char *label,
     int textY = rowCenterY - 7;
     int textX = 24;
 
-    bool selected = (index == selectedIndex);
+    DrawBatch batch(drawList);
     if (selected) {
-        tft.fillRect(boxX, boxY, boxW, boxH, Colors::ACCENT);
+        drawList.fillRect(boxX, boxY, boxW, boxH, Colors::ACCENT);
         text(label, textX, textY, 2, Colors::BG, Colors::ACCENT);
     } else {
-        tft.fillRect(boxX, boxY, boxW, boxH, Colors::BG);
+        drawList.fillRect(boxX, boxY, boxW, boxH, Colors::BG);
         text(label, textX, textY, 2, ST77XX_WHITE, Colors::BG);
     }
 }
@@ -79,8 +74,9 @@ void drawListItem(int index, int selectedIndex, const char *label,
 
 void drawAlarmIcon() {
     int x = Screen::WIDTH - 24;
+    drawList.flush();
     tft.fillRect(x - 10, 0, 24, 24, Colors::BG);
-    if (!settings.alarmEnabled)
+    if (!Alarms.anyEnabled())
         return;
     uint16_t c = Colors::LIGHT;
     tft.drawRoundRect(x - 9, 4, 18, 14, 4, c);
@@ -88,48 +84,211 @@ void drawAlarmIcon() {
     tft.fillCircle(x, 19, 2, c);
 }
 
-void drawHistoryGraph() {
-    graphCanvas.fillScreen(Colors::BG);
-    int h = 90;
-    graphCanvas.drawFastHLine(0, h / 4, 320, Colors::GRID);
-    graphCanvas.drawFastHLine(0, h / 2, 320, Colors::GRID);
-    graphCanvas.drawFastHLine(0, 3 * h / 4, 320, Colors::GRID);
-    int pX = -1;
-    int pY_T = -1, pY_H = -1, pY_V = -1, pY_C = -1;
-    for (int i = 0; i < EnvData::HIST_LEN; i++) {
-        int idx = (env.head + i) % EnvData::HIST_LEN;
-        int x = i;
-        // Simple scaling logic kept same
-        int yT = map(constrain(env.hTemp[idx] / 10, 10, 40), 10, 40, 88, 2);
-        int yH = map(constrain(env.hHum[idx], 0, 100), 0, 100, 88, 2);
-        int yV = map(constrain(env.hTVOC[idx], 0, 1500), 0, 1500, 88, 2);
-        int yC = map(constrain(env.hCO2[idx], 400, 2000), 400, 2000, 88, 2);
-
-        if (i > 0) {
-            graphCanvas.drawLine(pX, pY_T, x, yT, Colors::TEMP);
-            graphCanvas.drawLine(pX, pY_H, x, yH, Colors::HUM);
-            graphCanvas.drawLine(pX, pY_V, x, yV, Colors::TVOC);
-            graphCanvas.drawLine(pX, pY_C, x, yC, Colors::CO2);
+namespace {
+// Vertical span of each trace per graph column, in graph-local rows. The
+// compositor paints the graph from these, so a column is computed once
+// when its data changes rather than on every repaint.
+struct GraphColumn {
+    uint8_t lo[HIST_CHANNELS];
+    uint8_t hi[HIST_CHANNELS];
+    uint8_t top, bot; // union of the spans; bot < top when empty
+};
+GraphColumn columns[Layout::GRAPH_W];
+
+const uint16_t TRACE_COLORS[4] = {Colors::TEMP, Colors::HUM, Colors::TVOC,
+                                  Colors::CO2};
+
+// Computes one column from its own sample and its two neighbours, so a
+// column can be refreshed in isolation and still join up with the rest.
+void computeGraphColumn(int x) {
+    GraphColumn &col = columns[x];
+    col.top = Layout::GRAPH_H;
+    col.bot = 0;
+    if (x == 0 || x == Layout::GRAPH_W - 1)
+        return;
+
+    const GraphPoint &prev = env.graph.at(x - 1);
+    const GraphPoint &cur = env.graph.at(x);
+    const GraphPoint &next = env.graph.at(x + 1);
+    for (int c = 0; c < HIST_CHANNELS; c++) {
+        int m = cur.mean[c];
+        int a = (prev.mean[c] + m) >> 1;
+        int b = (m + next.mean[c]) >> 1;
+        // Widen the column to the bucket's extremes so short spikes stay
+        // visible at coarse ranges.
+        int lo = min(min(m, (int)cur.top[c]), min(a, b));
+        int hi = max(max(m, (int)cur.bot[c]), max(a, b));
+        col.lo[c] = lo;
+        col.hi[c] = hi;
+        if (lo < col.top)
+            col.top = lo;
+        if (hi > col.bot)
+            col.bot = hi;
+    }
+}
+
+void traceExtent(int &top, int &bot) {
+    for (int x = 1; x < Layout::GRAPH_W - 1; x++) {
+        if (columns[x].top < top)
+            top = columns[x].top;
+        if (columns[x].bot > bot)
+            bot = columns[x].bot;
+    }
+}
+
+class GraphWidget : public Widget {
+  public:
+    DirtyRect bounds() const override {
+        return DirtyRect(Layout::GRAPH_X, Layout::GRAPH_Y, Layout::GRAPH_W,
+                         Layout::GRAPH_H);
+    }
+
+    void render(uint16_t *buf, const DirtyRect &area) override {
+        const int h = Layout::GRAPH_H;
+        DirtyRect r = bounds().intersect(area);
+        int y0 = r.y - Layout::GRAPH_Y;
+        int y1 = y0 + r.h;
+        for (int16_t sx = r.x; sx < r.x + r.w; sx++) {
+            int x = sx - Layout::GRAPH_X;
+            uint16_t *px = buf + (sx - area.x) + (r.y - area.y) * area.w;
+            // px[row * area.w] is graph row y0 + row
+            if (x == 0 || x == Layout::GRAPH_W - 1) {
+                for (int y = y0; y < y1; y++)
+                    px[(y - y0) * area.w] = Colors::GRID;
+                continue;
+            }
+            const int grid[] = {h / 4, h / 2, 3 * h / 4};
+            for (int g : grid)
+                if (g >= y0 && g < y1)
+                    px[(g - y0) * area.w] = Colors::GRID;
+            const GraphColumn &col = columns[x];
+            for (int c = 0; c < HIST_CHANNELS; c++) {
+                int lo = max<int>(col.lo[c], y0);
+                int hi = min<int>(col.hi[c], y1 - 1);
+                for (int y = lo; y <= hi; y++)
+                    px[(y - y0) * area.w] = TRACE_COLORS[c];
+            }
+            if (y0 == 0)
+                px[0] = Colors::GRID;
+            if (y1 == h)
+                px[(h - 1 - y0) * area.w] = Colors::GRID;
+        }
+    }
+};
+
+// Each channel's current range, printed small over the left end of the
+// graph: maxima along the top, minima along the bottom. The text is drawn
+// once per range change into 1-bit strips and overlaid by the compositor,
+// so it repaints together with the traces underneath.
+class AxisLabelWidget : public Widget {
+  public:
+    static const int SEG_W = 40; // one label per channel
+    static const int X = Layout::GRAPH_X + 3;
+    static const int TOP_Y = Layout::GRAPH_Y + 2;
+    static const int BOT_Y = Layout::GRAPH_Y + Layout::GRAPH_H - 10;
+
+    void update() {
+        for (int row = 0; row < 2; row++) {
+            GFXcanvas1 &strip = row == 0 ? top : bot;
+            strip.fillScreen(0);
+            strip.setTextWrap(false);
+            strip.setTextColor(1);
+            for (int c = 0; c < HIST_CHANNELS; c++) {
+                uint16_t v = row == 0 ? env.graph.rangeHi(c)
+                                      : env.graph.rangeLo(c);
+                TextBuf<6> s;
+                if (c == HIST_TEMP)
+                    s.appendInt(v / 10).append('C');
+                else if (c == HIST_HUM)
+                    s.appendInt(v).append('%');
+                else
+                    s.appendInt(v);
+                strip.setCursor(c * SEG_W, 0);
+                strip.print(s.c_str());
+            }
         }
-        pX = x;
-        pY_T = yT;
-        pY_H = yH;
-        pY_V = yV;
-        pY_C = yC;
     }
-    graphCanvas.drawRect(0, 0, 320, 90, Colors::GRID);
-    tft.drawRGBBitmap(0, 145, graphCanvas.getBuffer(), 320, 90);
+
+    DirtyRect bounds() const override {
+        return DirtyRect(X, TOP_Y, SEG_W * HIST_CHANNELS, BOT_Y + 8 - TOP_Y);
+    }
+
+    void render(uint16_t *buf, const DirtyRect &area) override {
+        blit(top, TOP_Y, buf, area);
+        blit(bot, BOT_Y, buf, area);
+    }
+
+  private:
+    GFXcanvas1 top{SEG_W * HIST_CHANNELS, 8};
+    GFXcanvas1 bot{SEG_W * HIST_CHANNELS, 8};
+
+    // Copies set bits only, so the traces show between the letters.
+    void blit(GFXcanvas1 &strip, int y, uint16_t *buf, const DirtyRect &area) {
+        DirtyRect r = DirtyRect(X, y, strip.width(), 8).intersect(area);
+        if (r.empty())
+            return;
+        const uint8_t *bits = strip.getBuffer();
+        const int rowBytes = (strip.width() + 7) / 8;
+        for (int16_t sy = r.y; sy < r.y + r.h; sy++) {
+            const uint8_t *src = bits + (sy - y) * rowBytes;
+            uint16_t *dst = buf + (sy - area.y) * area.w;
+            for (int16_t sx = r.x; sx < r.x + r.w; sx++) {
+                int col = sx - X;
+                if (src[col >> 3] & (0x80 >> (col & 7)))
+                    dst[sx - area.x] = TRACE_COLORS[col / SEG_W];
+            }
+        }
+    }
+};
+
+GraphWidget graphWidget;
+AxisLabelWidget axisLabels;
+} // namespace
+
+void drawHistoryGraph() {
+    env.graph.select(env.history,
+                     HistoryPyramid::levelForRange(settings.graphDuration),
+                     settings.graphAutoScale);
+    for (int x = 0; x < Layout::GRAPH_W; x++)
+        computeGraphColumn(x);
+    axisLabels.update();
+    compositor.addWidget(graphWidget);
+    compositor.addWidget(axisLabels);
+    compositor.markDirty(graphWidget.bounds());
+    compositor.flush();
+}
+
+void scrollHistoryGraph() {
+    const int w = Layout::GRAPH_W;
+    int top = Layout::GRAPH_H, bot = 0;
+    traceExtent(top, bot);
+
+    // env.graph has already shifted; keep the spans in step
+    memmove(columns, columns + 1, (w - 1) * sizeof(GraphColumn));
+    computeGraphColumn(0);
+    computeGraphColumn(w - 2);
+    computeGraphColumn(w - 1);
+
+    // Rows outside the union of old and new traces are plain background and
+    // grid, which look the same after the scroll, so they are not re-sent.
+    traceExtent(top, bot);
+    if (bot >= top)
+        compositor.markDirty(Layout::GRAPH_X, Layout::GRAPH_Y + top, w,
+                             bot - top + 1);
+    compositor.flush();
 }
 
 void initClockStaticUI() {
     UI::clear();
-    tft.drawFastHLine(Layout::GRID_L, Layout::GRID_TOP,
-                      Layout::GRID_R - Layout::GRID_L, ST77XX_WHITE);
-    tft.drawFastHLine(Layout::GRID_L, Layout::GRID_MID,
-                      Layout::GRID_R - Layout::GRID_L, ST77XX_WHITE);
-    tft.drawFastHLine(Layout::GRID_L, Layout::GRID_BOT,
-                      Layout::GRID_R - Layout::GRID_L, ST77XX_WHITE);
-    tft.drawFastVLine(Layout::GRID_MID_X, Layout::GRID_TOP,
+    clockText.invalidate();
+    drawList.begin();
+    drawList.fillRect(Layout::GRID_L, Layout::GRID_TOP,
+                      Layout::GRID_R - Layout::GRID_L, 1, ST77XX_WHITE);
+    drawList.fillRect(Layout::GRID_L, Layout::GRID_MID,
+                      Layout::GRID_R - Layout::GRID_L, 1, ST77XX_WHITE);
+    drawList.fillRect(Layout::GRID_L, Layout::GRID_BOT,
+                      Layout::GRID_R - Layout::GRID_L, 1, ST77XX_WHITE);
+    drawList.fillRect(Layout::GRID_MID_X, Layout::GRID_TOP, 1,
                       Layout::GRID_BOT - Layout::GRID_TOP, ST77XX_WHITE);
     UI::textCenteredX("HUMI", Layout::GRID_L, Layout::GRID_MID_X,
                       Layout::LBL_TOP_Y, 1, ST77XX_WHITE);
@@ -139,226 +298,79 @@ void initClockStaticUI() {
                       Layout::LBL_BOT_Y, 1, ST77XX_WHITE);
     UI::textCenteredX("CO2", Layout::GRID_MID_X, Layout::GRID_R,
                       Layout::LBL_BOT_Y, 1, ST77XX_WHITE);
+    drawList.end();
     drawHistoryGraph();
 }
 
-void drawClockTime(String hourStr, String minStr, String secStr) {
-    String cur = hourStr + ":" + minStr + ":" + secStr;
-    if (cur == ui.prevTimeStr)
-        return;
-    ui.prevTimeStr = cur;
-    UI::textCentered(cur, 10, 6, ST77XX_WHITE);
+void drawClockTime(const char *hms) {
+    clockText.drawCentered(hms, 10, ST77XX_WHITE, Colors::BG);
 }
 
 void drawEnvDynamic() {
+    DrawBatch batch(drawList);
     char buf[32];
 
     sprintf(buf, " %2.0f%% ", env.hum);
-    UI::textCenteredX(String(buf), Layout::GRID_L, Layout::GRID_MID_X,
+    UI::textCenteredX(buf, Layout::GRID_L, Layout::GRID_MID_X,
                       Layout::VAL_TOP_Y, 2, Colors::HUM, Colors::BG);
     sprintf(buf, " %2.1fC ", env.temp);
-    UI::textCenteredX(String(buf), Layout::GRID_MID_X, Layout::GRID_R,
+    UI::textCenteredX(buf, Layout::GRID_MID_X, Layout::GRID_R,
                       Layout::VAL_TOP_Y, 2, Colors::TEMP, Colors::BG);
     sprintf(buf, "  %d  ", env.tvoc);
-    UI::textCenteredX(String(buf), Layout::GRID_L, Layout::GRID_MID_X,
+    UI::textCenteredX(buf, Layout::GRID_L, Layout::GRID_MID_X,
                       Layout::VAL_BOT_Y, 2, Colors::TVOC, Colors::BG);
     sprintf(buf, "  %d  ", env.eco2);
-    UI::textCenteredX(String(buf), Layout::GRID_MID_X, Layout::GRID_R,
+    UI::textCenteredX(buf, Layout::GRID_MID_X, Layout::GRID_R,
                       Layout::VAL_BOT_Y, 2, Colors::CO2, Colors::BG);
 }
 
-void drawGenericList(const char *items[], int count, int selectedIndex,
-                     int lastIndex, bool fullRedraw) {
-    if (fullRedraw)
-        UI::clear();
-    for (int i = 0; i < count; i++) {
-        if (fullRedraw || i == selectedIndex || i == lastIndex) {
-            UI::drawListItem(i, selectedIndex, items[i], fullRedraw);
-        }
-    }
+namespace {
+// Thin bar in the right margin showing which part of the list is visible.
+void drawListScrollbar(int count, int top) {
+    const int x = 313, w = 3;
+    int y = Layout::LIST_Y - 14;
+    int h = (Layout::LIST_ROWS - 1) * Layout::LIST_PITCH + 28;
+    int thumbH = max(8, h * Layout::LIST_ROWS / count);
+    int thumbY = y + (h - thumbH) * top / (count - Layout::LIST_ROWS);
+    drawList.fillRect(x, y, w, thumbY - y, Colors::GRID);
+    drawList.fillRect(x, thumbY, w, thumbH, Colors::LIGHT);
+    drawList.fillRect(x, thumbY + thumbH, w, y + h - thumbY - thumbH,
+                      Colors::GRID);
 }
+} // namespace
 
-void drawPomodoroScreen(bool forceStatic) {
-    if (forceStatic) {
-        UI::clear();
-        pomo.prevBarWidth = -1;
-        pomo.prevLabel = "";
-        ui.prevTimeStr = "";
-        char cycleBuf[20];
-        sprintf(cycleBuf, "Cycle: %d/%d", pomo.currentCycle,
-                settings.pomoCycles);
-        UI::textCentered(cycleBuf, 190, 2, ST77XX_WHITE);
-    }
-
-    String labelStr = "";
-    uint16_t labelColor = Colors::LIGHT;
-    if (pomo.state == POMO_PAUSED) {
-        labelStr = "Paused";
-        labelColor = ST77XX_YELLOW;
-    } else if (pomo.phase == PHASE_WORK) {
-        labelStr = "Get to Work!";
-        labelColor = Colors::LIGHT;
-    } else if (pomo.phase == PHASE_SHORT) {
-        labelStr = "Short Break";
-        labelColor = Colors::GREEN;
-    } else {
-        labelStr = "Long Break";
-        labelColor = Colors::BLUE;
-    }
-
-    if (labelStr != pomo.prevLabel) {
-        tft.fillRect(0, 30, Screen::WIDTH, 20, Colors::BG);
-        UI::textCentered(labelStr, 30, 2, labelColor);
-        pomo.prevLabel = labelStr;
-    }
-
-    unsigned long elapsed = 0;
-    if (pomo.state == POMO_RUNNING)
-        elapsed = millis() - pomo.startMillis;
-    else if (pomo.state == POMO_PAUSED)
-        elapsed = pomo.pausedMillis - pomo.startMillis;
-    if (elapsed > pomo.durationMs)
-        elapsed = pomo.durationMs;
-    float progress =
-        (pomo.durationMs > 0) ? (float)elapsed / pomo.durationMs : 0.0f;
-
-    UI::drawBar(20, 225, 280, 10, (int)(progress * 100), Colors::GREEN,
-                pomo.prevBarWidth);
-
-    unsigned long remain = pomo.durationMs - elapsed;
-    char buf[8];
-    sprintf(buf, "%02d:%02d", (int)(remain / 60000UL),
-            (int)((remain / 1000UL) % 60));
-    String timeStr = String(buf);
-    static uint16_t prevTimeColor = 0;
-    uint16_t timeColor =
-        (pomo.state == POMO_PAUSED) ? Colors::LIGHT : ST77XX_WHITE;
-    if (timeStr != ui.prevTimeStr || timeColor != prevTimeColor) {
-        UI::textCentered(timeStr, 90, 6, timeColor);
-        ui.prevTimeStr = timeStr;
-        prevTimeColor = timeColor;
-    }
-}
-
-void updatePomodoroValue(int value) {
-    if (value == pomo.prevVal)
-        return;
-    pomo.prevVal = value;
-    int numY = 100;
-    int numW = 100;
-    int startX = (Screen::WIDTH - numW) / 2;
-    tft.fillRect(startX, numY, numW, 50, Colors::BG);
-    UI::textCentered(String(value), numY, 6, ST77XX_WHITE);
-}
-
-void drawAlarmRingingScreen() {
-    UI::clear(ST77XX_RED);
-    UI::text("ALARM!", 60, 100, 4, ST77XX_WHITE, ST77XX_RED);
-}
+void drawGenericList(const char *items[], int count, int selectedIndex,
+                     int lastIndex, bool fullRedraw, int &top) {
+    // Scroll just far enough to keep the selection on screen
+    int oldTop = top;
+    if (selectedIndex < top)
+        top = selectedIndex;
+    else if (selectedIndex >= top + Layout::LIST_ROWS)
+        top = selectedIndex - Layout::LIST_ROWS + 1;
+    top = constrain(top, 0, max(0, count - Layout::LIST_ROWS));
+    bool scrolled = top != oldTop;
 
-void drawAlarmScreen(bool full) {
-    if (full) {
+    if (fullRedraw)
         UI::clear();
-        UI::text("Status:", 50, 165, 3, ST77XX_WHITE);
+    DrawBatch batch(drawList);
+    int rows = min(count - top, Layout::LIST_ROWS);
+    for (int row = 0; row < rows; row++) {
+        int i = top + row;
+        // After a scroll every row shows a different item
+        if (fullRedraw || scrolled || i == selectedIndex || i == lastIndex)
+            UI::drawListItem(row, i == selectedIndex, items[i]);
     }
-    char hBuf[3], mBuf[3];
-    sprintf(hBuf, "%02d", settings.alarmHour);
-    sprintf(mBuf, "%02d", settings.alarmMinute);
-
-    int16_t x1, y1;
-    uint16_t w, h;
-    tft.setTextSize(6);
-    tft.getTextBounds("88:88", 0, 0, &x1, &y1, &w, &h);
-    int x = (Screen::WIDTH - w) / 2;
-
-    tft.setCursor(x, 60);
-    tft.setTextColor(ui.alarmSelectedField == 0 ? Colors::LIGHT : ST77XX_WHITE,
-                     Colors::BG);
-    tft.print(hBuf);
-    tft.setTextColor(ST77XX_WHITE, Colors::BG);
-    tft.print(":");
-    tft.setTextColor(ui.alarmSelectedField == 1 ? Colors::LIGHT : ST77XX_WHITE,
-                     Colors::BG);
-    tft.print(mBuf);
-
-    uint16_t enColor =
-        ui.alarmSelectedField == 2
-            ? Colors::LIGHT
-            : (settings.alarmEnabled ? Colors::GREEN : ST77XX_RED);
-    UI::text(settings.alarmEnabled ? "ON " : "OFF", 180, 165, 3, enColor);
+    if (count > Layout::LIST_ROWS && (fullRedraw || scrolled))
+        drawListScrollbar(count, top);
 }
 
-void initDvd() {
-    ui.dvdInited = true;
-    UI::clear();
-    ui.dvdX = 80;
-    ui.dvdY = 80;
-    ui.dvdVX = 3;
-    ui.dvdVY = 2;
-    ui.lastDvdMs = millis();
-    ui.dvdColorIndex = 0;
-}
-
-void drawDvdLogo(int x, int y, uint16_t c) {
-    tft.fillRoundRect(x, y, ui.dvdW, ui.dvdH, 8, c);
-    tft.drawRoundRect(x, y, ui.dvdW, ui.dvdH, 8, Colors::BG);
-    UI::textCenteredX("DVD", x, x + ui.dvdW, y + ui.dvdH / 2 - 6, 2, Colors::BG,
-                      c);
+void renderDvdLogo(GFXcanvas16 &sprite, uint16_t c) {
+    int16_t w = sprite.width(), h = sprite.height();
+    sprite.fillScreen(Colors::BG);
+    sprite.fillRoundRect(0, 0, w, h, 8, c);
+    sprite.drawRoundRect(0, 0, w, h, 8, Colors::BG);
+    sprite.setTextSize(2);
+    sprite.setTextColor(Colors::BG, c);
+    sprite.setCursor((w - DrawList::textWidth("DVD", 2)) / 2, h / 2 - 6);
+    sprite.print("DVD");
 }
-
-void drawSettingsScreen(bool full) {
-    if (full) {
-        UI::clear();
-        ui.prevLedBarW = -1;
-        ui.prevSpkBarW = -1;
-    }
-    int barX = 40;
-    int barW = 240;
-    int barH = 15;
-    uint16_t cLed = (ui.settingsSelectedRow == 0)
-                        ? (ui.settingsEditMode ? Colors::GREEN : Colors::BLUE)
-                        : ST77XX_WHITE;
-    uint16_t cSpk = (ui.settingsSelectedRow == 1)
-                        ? (ui.settingsEditMode ? Colors::GREEN : Colors::BLUE)
-                        : ST77XX_WHITE;
-    uint16_t cGr = (ui.settingsSelectedRow == 2)
-                       ? (ui.settingsEditMode ? Colors::GREEN : Colors::BLUE)
-                       : ST77XX_WHITE;
-
-    UI::text("LED Brightness", barX, 20, 2, cLed);
-    UI::drawBar(barX, 40, barW, barH, settings.ledBrightness, Colors::GREEN,
-                ui.prevLedBarW);
-
-    UI::text("Speaker Volume", barX, 60, 2, cSpk);
-    UI::drawBar(barX, 80, barW, barH, settings.speakerVol, Colors::GREEN,
-                ui.prevSpkBarW);
-
-    UI::text("Graph Range", barX, 100, 2, cGr);
-    tft.drawRect(barX - 1, 119, barW + 2, barH + 12, ST77XX_WHITE);
-    tft.fillRect(barX, 120, barW, barH + 10, Colors::DARK);
-
-    String rangeStr = (settings.graphDuration < 60)
-                          ? String(settings.graphDuration) + " Min"
-                          : String(settings.graphDuration / 60) + " Hours";
-    UI::textCenteredX(rangeStr, barX, barX + barW, 124, 2, ST77XX_WHITE,
-                      Colors::DARK);
-
-    // WiFi Buttons
-    int yWifi = 165;
-    tft.fillRoundRect(barX, yWifi, barW, 25, 4,
-                      (ui.settingsSelectedRow == 3) ? Colors::BLUE
-                                                    : Colors::DARK);
-    UI::textCenteredX("Setup WiFi", barX, barX + barW, yWifi + 5, 2,
-                      (ui.settingsSelectedRow == 3) ? Colors::BG : ST77XX_WHITE,
-                      (ui.settingsSelectedRow == 3) ? Colors::BLUE
-                                                    : Colors::DARK);
-
-    int yReset = 200;
-    tft.fillRoundRect(barX, yReset, barW, 25, 4,
-                      (ui.settingsSelectedRow == 4) ? ST77XX_RED
-                                                    : Colors::DARK);
-    UI::textCenteredX("Reset WiFi", barX, barX + barW, yReset + 5, 2,
-                      (ui.settingsSelectedRow == 4) ? Colors::BG : ST77XX_WHITE,
-                      (ui.settingsSelectedRow == 4) ? ST77XX_RED
-                                                    : Colors::DARK);
-}
\ No newline at end of file
@@ -3,35 +3,32 @@
 
 #include "Config.h"
 #include "Globals.h"
+#include "TextBuf.h"
 
 namespace UI {
 void clear(uint16_t bgColor = Colors::BG);
-void drawHeader(String title);
-void text(String str, int x, int y, int size, uint16_t color,
+void drawHeader(const char *title);
+void text(const char *str, int x, int y, int size, uint16_t color,
           uint16_t bg = Colors::BG);
-void textCentered(String str, int y, int size, uint16_t color,
+void textCentered(const char *str, int y, int size, uint16_t color,
                   uint16_t bg = Colors::BG);
-void textCenteredX(String str, int x_start, int x_end, int y, int size,
+void textCenteredX(const char *str, int x_start, int x_end, int y, int size,
                    uint16_t color, uint16_t bg = Colors::BG);
 void drawBar(int x, int y, int w, int h, int percent, uint16_t color,
              int &prevW);
-void drawListItem(int index, int selectedIndex, const char *label,
-                  bool fullRedraw);
+void drawListItem(int row, bool selected, const char *label);
 } // namespace UI
 
 void drawAlarmIcon();
 void drawHistoryGraph();
+void scrollHistoryGraph();
 void initClockStaticUI();
-void drawClockTime(String hourStr, String minStr, String secStr);
+void drawClockTime(const char *hms);
 void drawEnvDynamic();
+// top is the first item on screen; it follows the selection one row at a
+// time so lists longer than Layout::LIST_ROWS can be scrolled through.
 void drawGenericList(const char *items[], int count, int selectedIndex,
-                     int lastIndex, bool fullRedraw);
-void drawPomodoroScreen(bool forceStatic);
-void updatePomodoroValue(int value);
-void drawAlarmRingingScreen();
-void drawAlarmScreen(bool full);
-void drawDvdLogo(int x, int y, uint16_t c);
-void initDvd();
-void drawSettingsScreen(bool full);
+                     int lastIndex, bool fullRedraw, int &top);
+void renderDvdLogo(GFXcanvas16 &sprite, uint16_t c);
 
 #endif
\ No newline at end of file
@@ -1,20 +1,19 @@
 #include "Hardware.h"
+#include "AlertEngine.h"
+#include "Connectivity.h"
+#include "EnvLog.h"
 #include "Graphics.h"
+#include "SensorTask.h"
+#include "TimeService.h"
 
 void initHardware() {
     Input.begin();
 
     ledcSetup(PWM::CH_LED, 5000, 8);
     ledcAttachPin(Pins::LED, PWM::CH_LED);
-    ledcSetup(PWM::CH_BUZZ, 2000, 8);
-    ledcAttachPin(Pins::BUZZ, PWM::CH_BUZZ);
-
-    for (int i = 0; i < EnvData::HIST_LEN; i++) {
-        env.hTemp[i] = 0;
-        env.hHum[i] = 0;
-        env.hTVOC[i] = 0;
-        env.hCO2[i] = 0;
-    }
+    Buzzer.begin();
+
+    env.history.clear();
 }
 
 void setLedState(bool on) {
@@ -26,141 +25,193 @@ void setLedState(bool on) {
     }
 }
 
-void playSystemTone(unsigned int frequency, unsigned long durationMs) {
-    if (settings.speakerVol == 0) {
-        ledcWrite(PWM::CH_BUZZ, 0);
-        return;
-    }
-    ledcSetup(PWM::CH_BUZZ, frequency, 8);
-    ledcAttachPin(Pins::BUZZ, PWM::CH_BUZZ);
-    int duty = map(settings.speakerVol, 0, 100, 0, 128);
-    ledcWrite(PWM::CH_BUZZ, duty);
-    if (durationMs > 0) {
-        delay(durationMs);
-        stopSystemTone();
+void flashLed(unsigned long durationMs) {
+    ui.ledHoldUntilMs = millis() + durationMs;
+    setLedState(true);
+}
+
+void playSystemTone(unsigned int frequency, unsigned long durationMs,
+                    TonePriority prio) {
+    Buzzer.play(frequency, durationMs, prio);
+}
+
+void stopSystemTone() { Buzzer.stop(); }
+
+namespace {
+// Missing minutes up to this many are bridged with the previous record so
+// the time axis stays aligned; a longer gap (power off) restarts the graph.
+const uint32_t MAX_BRIDGE_RECORDS = 5;
+// How long live samples wait for network time to measure the gap since
+// the last restored record; without it the gap counts as a long one.
+const unsigned long JOIN_WAIT_MS = 30000;
+EnvRecord restoredPrev = {};
+unsigned long restoredAtMs = 0;
+
+void restoreRecord(const EnvRecord &r) {
+    // A logged minute stands in for every sample taken during it
+    const unsigned long perRecord =
+        EnvLog::RECORD_SECONDS * 1000UL / HistoryPyramid::SAMPLE_MS;
+    uint32_t missing = 0;
+    if (restoredPrev.time != 0)
+        missing = (r.time - restoredPrev.time) / EnvLog::RECORD_SECONDS - 1;
+    if (missing > MAX_BRIDGE_RECORDS) {
+        env.history.clear();
+        missing = 0;
     }
+    for (uint32_t m = 0; m < missing; m++)
+        for (unsigned long i = 0; i < perRecord; i++)
+            env.history.add(restoredPrev.values);
+    for (unsigned long i = 0; i < perRecord; i++)
+        env.history.add(r.values);
+    restoredPrev = r;
 }
 
-void stopSystemTone() { ledcWrite(PWM::CH_BUZZ, 0); }
+// Joins the first live sample after a restore to the restored history
+// across the time the device was off, by the same rule as restoreRecord().
+// Returns false while that time is not known yet.
+bool joinRestored() {
+    if (restoredPrev.time == 0)
+        return true;
+    if (!Network.synced() && millis() - restoredAtMs < JOIN_WAIT_MS)
+        return false;
+    // The restored record covers its whole minute
+    uint32_t now = Network.synced() ? (uint32_t)Time.epoch() : 0;
+    uint32_t end = restoredPrev.time + EnvLog::RECORD_SECONDS;
+    uint32_t gap = now > end ? now - end : 0;
+    if (now < restoredPrev.time ||
+        gap > MAX_BRIDGE_RECORDS * EnvLog::RECORD_SECONDS) {
+        env.history.clear();
+    } else {
+        unsigned long samples = gap * 1000UL / HistoryPyramid::SAMPLE_MS;
+        for (unsigned long i = 0; i < samples; i++)
+            env.history.add(restoredPrev.values);
+    }
+    restoredPrev.time = 0;
+    env.graph.invalidate();
+    if (ui.currentMode == MODE_CLOCK)
+        drawHistoryGraph();
+    return true;
+}
+} // namespace
 
 void recordHistory(float t, float h, uint16_t tvoc, uint16_t eco2) {
-    env.hTemp[env.head] = (uint16_t)(t * 10);
-    env.hHum[env.head] = (uint16_t)h;
-    env.hTVOC[env.head] = tvoc;
-    env.hCO2[env.head] = eco2;
-    env.head = (env.head + 1) % EnvData::HIST_LEN;
-    if (ui.currentMode == MODE_CLOCK)
+    if (!joinRestored())
+        return;
+    uint16_t values[HIST_CHANNELS];
+    values[HIST_TEMP] = (uint16_t)(t * 10);
+    values[HIST_HUM] = (uint16_t)h;
+    values[HIST_TVOC] = tvoc;
+    values[HIST_CO2] = eco2;
+    uint8_t closed = env.history.add(values);
+    Log.addSample(values, Network.synced() ? Time.epoch() : 0);
+    // Scale the new bucket now so the graph never scales while drawing
+    GraphChange change = env.graph.onAdd(env.history, closed);
+    if (ui.currentMode != MODE_CLOCK)
+        return;
+    if (change == GRAPH_RESCALED)
         drawHistoryGraph();
+    else if (change == GRAPH_SHIFTED)
+        scrollHistoryGraph();
 }
 
-void updateEnvSensors(bool force) {
-    unsigned long now = millis();
-    if (force || (now - env.lastRead) >= 1000) {
-        env.lastRead = now;
-        sensors_event_t hum, temp;
-        if (aht.getEvent(&hum, &temp)) {
-            env.temp = temp.temperature;
-            env.hum = hum.relative_humidity;
-        }
-        ens160.set_envdata(env.temp, env.hum);
-        ens160.measure();
-        uint16_t newTVOC = ens160.getTVOC();
-        uint16_t newCO2 = ens160.geteCO2();
-        if (newTVOC != 0xFFFF)
-            env.tvoc = newTVOC;
-        if (newCO2 != 0xFFFF)
-            env.eco2 = newCO2;
+void restoreHistory() {
+    uint32_t newest = Log.newestTime();
+    if (newest == 0)
+        return;
+    // The longest graph range is all the pyramid can show
+    uint32_t span = Graph::RANGES_MIN[Graph::RANGE_COUNT - 1] * 60UL;
+    restoredPrev.time = 0;
+    restoredAtMs = millis();
+    Log.replay(newest > span ? newest - span : 0, [](const EnvRecord &r) {
+        restoreRecord(r);
+        // Shown until the sensors deliver
+        env.temp = r.values[HIST_TEMP] / 10.0f;
+        env.hum = r.values[HIST_HUM];
+        env.tvoc = r.values[HIST_TVOC];
+        env.eco2 = r.values[HIST_CO2];
+    });
+    // The graph may already show the empty pyramid from the first frame
+    env.graph.invalidate();
+}
+
+void updateEnvSensors() {
+    // The I2C work happens in the sensor task; this only copies its latest
+    // snapshot.
+    EnvSample sample;
+    if (Sensors.poll(sample)) {
+        env.temp = sample.temp;
+        env.hum = sample.hum;
+        env.tvoc = sample.tvoc;
+        env.eco2 = sample.eco2;
+        env.lastRead = sample.timeMs;
+        int32_t values[HIST_CHANNELS];
+        values[HIST_TEMP] = (int32_t)(sample.temp * 10);
+        values[HIST_HUM] = (int32_t)sample.hum;
+        values[HIST_TVOC] = sample.tvoc;
+        values[HIST_CO2] = sample.eco2;
+        Alerts.onSample(values, sample.timeMs);
     }
-    unsigned long interval =
-        (settings.graphDuration * 60000UL) / EnvData::HIST_LEN;
-    if (interval < 1000)
-        interval = 1000;
-    if (now - env.lastHistAdd >= interval) {
+    // Nothing to record before the first real sample
+    if (env.lastRead == 0)
+        return;
+    unsigned long now = millis();
+    // The pyramid keeps every graph range, so history is always sampled at
+    // the finest resolution regardless of the selected range.
+    if (now - env.lastHistAdd >= HistoryPyramid::SAMPLE_MS) {
         env.lastHistAdd = now;
         recordHistory(env.temp, env.hum, env.tvoc, env.eco2);
     }
 }
 
-void loadSettings() {
-    prefs.begin("cyber", true);
-    settings.ledBrightness = prefs.getInt("led_b", 100);
-    settings.speakerVol = prefs.getInt("spk_v", 100);
-    settings.graphDuration = prefs.getInt("gr_dur", 5);
-    settings.alarmHour = prefs.getInt("alm_h", 7);
-    settings.alarmMinute = prefs.getInt("alm_m", 0);
-    settings.alarmEnabled = prefs.getBool("alm_e", false);
-    settings.pomoWorkMin = prefs.getInt("p_work", 25);
-    settings.pomoShortMin = prefs.getInt("p_short", 5);
-    settings.pomoLongMin = prefs.getInt("p_long", 15);
-    settings.pomoCycles = prefs.getInt("p_cycl", 4);
-    prefs.end();
-}
-
-void saveSettings() {
-    prefs.begin("cyber", false);
-    prefs.putInt("led_b", settings.ledBrightness);
-    prefs.putInt("spk_v", settings.speakerVol);
-    prefs.putInt("gr_dur", settings.graphDuration);
-    prefs.putInt("alm_h", settings.alarmHour);
-    prefs.putInt("alm_m", settings.alarmMinute);
-    prefs.putBool("alm_e", settings.alarmEnabled);
-    prefs.putInt("p_work", settings.pomoWorkMin);
-    prefs.putInt("p_short", settings.pomoShortMin);
-    prefs.putInt("p_long", settings.pomoLongMin);
-    prefs.putInt("p_cycl", settings.pomoCycles);
-    prefs.end();
+void setFallbackTime() {
+    struct tm tm = {};
+    tm.tm_year = 2024 - 1900;
+    tm.tm_mon = 0;
+    tm.tm_mday = 1;
+    tm.tm_hour = 12;
+    time_t t = mktime(&tm);
+    struct timeval now = {.tv_sec = t, .tv_usec = 0};
+    settimeofday(&now, NULL);
 }
 
 void syncTime() {
     configTime(0, 0, Net::NTP_SERVER);
     setenv("TZ", Net::TIME_ZONE, 1);
     tzset();
-}
-
-String getTimeStr(char type) {
-    struct tm timeinfo;
-    if (!getLocalTime(&timeinfo))
-        return "--";
-    char buf[8];
-    if (type == 'H')
-        strftime(buf, sizeof(buf), "%H", &timeinfo);
-    else if (type == 'M')
-        strftime(buf, sizeof(buf), "%M", &timeinfo);
-    else if (type == 'S')
-        strftime(buf, sizeof(buf), "%S", &timeinfo);
-    return String(buf);
+    Time.invalidate();
 }
 
 void updateAlertStateAndLED() {
     if (ui.currentMode == MODE_WIFI_SETUP)
         return;
-    if (ui.alarmRinging)
-        ui.currentAlert = ALERT_ALARM;
-    else if (env.eco2 > 1800)
-        ui.currentAlert = ALERT_CO2;
-    else
-        ui.currentAlert = ALERT_NONE;
+    AlertLevel prev = ui.currentAlert;
+    ui.currentAlert = ui.alarmRinging ? ALERT_ALARM : Alerts.level();
 
     unsigned long now = millis();
     if (ui.currentAlert == ALERT_NONE) {
-        if (ui.currentMode != MODE_SETTINGS &&
+        bool ledHeld = (long)(ui.ledHoldUntilMs - now) > 0;
+        if (!ledHeld && ui.currentMode != MODE_SETTINGS &&
             ui.currentMode != MODE_SETTINGS_EDIT) {
             setLedState(false);
         }
         ui.ledState = false;
     } else {
-        unsigned long interval = (ui.currentAlert == ALERT_ALARM) ? 120 : 250;
+        unsigned long interval = ui.currentAlert == ALERT_ALARM     ? 120
+                                 : ui.currentAlert == ALERT_WARNING ? 250
+                                                                    : 1000;
         if (now - ui.lastLedToggleMs > interval) {
             ui.lastLedToggleMs = now;
             ui.ledState = !ui.ledState;
             setLedState(ui.ledState);
         }
     }
-    if (ui.currentAlert == ALERT_CO2) {
-        if (now - ui.lastCo2BlinkMs > 350) {
-            ui.lastCo2BlinkMs = now;
-            ui.co2BlinkOn = !ui.co2BlinkOn;
-            playSystemTone(1800, 80);
+    // A warning beeps until it clears; a notice chirps once when raised
+    if (ui.currentAlert == ALERT_WARNING) {
+        if (now - ui.lastAlertToneMs > 350) {
+            ui.lastAlertToneMs = now;
+            playSystemTone(1800, 80, TONE_ALERT);
         }
+    } else if (ui.currentAlert == ALERT_NOTICE && prev < ALERT_NOTICE) {
+        playSystemTone(1200, 60, TONE_NOTIFY);
     }
 }
\ No newline at end of file
@@ -3,16 +3,21 @@
 
 #include "Config.h"
 #include "Globals.h"
+#include "ToneSequencer.h"
 
 void initHardware();
 void setLedState(bool on);
-void playSystemTone(unsigned int frequency, unsigned long durationMs = 0);
+void flashLed(unsigned long durationMs);
+void playSystemTone(unsigned int frequency, unsigned long durationMs = 0,
+                    TonePriority prio = TONE_UI);
 void stopSystemTone();
-void updateEnvSensors(bool force = false);
-void loadSettings();
-void saveSettings();
+void updateEnvSensors();
+// Refills the history from the flash log after a reboot. Live samples
+// join it once network time shows how long the device was off.
+void restoreHistory();
+// Clock used when no network time is available.
+void setFallbackTime();
 void syncTime();
-String getTimeStr(char type);
 void updateAlertStateAndLED();
 
 #endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "HistoryPyramid.h"
+
+void HistoryPyramid::clear() {
+    memset(buckets, 0, sizeof(buckets));
+    memset(head, 0, sizeof(head));
+    memset(filled, 0, sizeof(filled));
+    memset(accCount, 0, sizeof(accCount));
+    ratio[0] = 1;
+    for (int l = 1; l < LEVELS; l++)
+        ratio[l] = Graph::RANGES_MIN[l] / Graph::RANGES_MIN[l - 1];
+}
+
+uint8_t HistoryPyramid::add(const uint16_t values[HIST_CHANNELS]) {
+    HistBucket b[HIST_CHANNELS];
+    for (int c = 0; c < HIST_CHANNELS; c++)
+        b[c].lo = b[c].hi = b[c].mean = values[c];
+    push(0, b);
+    uint8_t closed = 1;
+
+    for (int l = 1; l < LEVELS; l++) {
+        for (int c = 0; c < HIST_CHANNELS; c++) {
+            Accumulator &a = acc[l][c];
+            if (accCount[l] == 0) {
+                a.lo = b[c].lo;
+                a.hi = b[c].hi;
+                a.sum = 0;
+            } else {
+                a.lo = min(a.lo, b[c].lo);
+                a.hi = max(a.hi, b[c].hi);
+            }
+            a.sum += b[c].mean;
+        }
+        if (++accCount[l] < ratio[l])
+            break;
+        for (int c = 0; c < HIST_CHANNELS; c++) {
+            b[c].lo = acc[l][c].lo;
+            b[c].hi = acc[l][c].hi;
+            b[c].mean = acc[l][c].sum / ratio[l];
+        }
+        accCount[l] = 0;
+        push(l, b);
+        closed |= 1 << l;
+    }
+    return closed;
+}
+
+void HistoryPyramid::push(int level, const HistBucket *b) {
+    for (int c = 0; c < HIST_CHANNELS; c++)
+        buckets[level][c][head[level]] = b[c];
+    head[level] = (head[level] + 1) % LEN;
+    if (filled[level] < LEN)
+        filled[level]++;
+}
+
+HistBucket HistoryPyramid::at(int level, int ch, int i) const {
+    return buckets[level][ch][(head[level] + i) % LEN];
+}
+
+int HistoryPyramid::levelForRange(int minutes) {
+    for (int l = 0; l < LEVELS; l++)
+        if (Graph::RANGES_MIN[l] >= minutes)
+            return l;
+    return LEVELS - 1;
+}
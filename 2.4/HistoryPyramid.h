@@ -0,0 +1,61 @@
+#ifndef HISTORYPYRAMID_H
+#define HISTORYPYRAMID_H
+
+#include "Config.h"
+#include <Arduino.h>
+
+enum HistChannel { HIST_TEMP = 0, HIST_HUM, HIST_TVOC, HIST_CO2, HIST_CHANNELS };
+
+struct HistBucket {
+    uint16_t lo;
+    uint16_t hi;
+    uint16_t mean;
+};
+
+// Min/max/mean decimation pyramid over the environment readings.
+//
+// Level i holds the last LEN buckets at the resolution of graph range
+// Graph::RANGES_MIN[i], so every selectable range is always available at
+// full width and switching ranges needs no resampling. Raw samples go into
+// level 0 at SAMPLE_MS; each coarser level folds a fixed number of buckets
+// of the level below (the ratio of neighbouring ranges), keeping the
+// extremes so short spikes survive decimation.
+//
+// Memory is fixed: LEVELS * HIST_CHANNELS * LEN * sizeof(HistBucket)
+// = 8 * 4 * 320 * 6 B = 60 KB, plus a few bytes of accumulators per level.
+class HistoryPyramid {
+  public:
+    static const int LEVELS = Graph::RANGE_COUNT;
+    static const int LEN = Layout::GRAPH_W;
+    static const unsigned long SAMPLE_MS = Graph::RANGES_MIN[0] * 60000UL / LEN;
+
+    void clear();
+    // Adds one sample per channel to level 0 and cascades upwards.
+    // Returns a bitmask of the levels that completed a bucket.
+    uint8_t add(const uint16_t values[HIST_CHANNELS]);
+
+    int count(int level) const { return filled[level]; }
+    // i = 0 is the oldest of the LEN visible buckets, LEN - 1 the newest.
+    // Buckets not yet filled read as zero.
+    HistBucket at(int level, int ch, int i) const;
+
+    static int levelForRange(int minutes);
+
+  private:
+    struct Accumulator {
+        uint16_t lo;
+        uint16_t hi;
+        uint32_t sum;
+    };
+
+    HistBucket buckets[LEVELS][HIST_CHANNELS][LEN];
+    uint16_t head[LEVELS];
+    uint16_t filled[LEVELS];
+    Accumulator acc[LEVELS][HIST_CHANNELS];
+    uint8_t accCount[LEVELS];
+    uint8_t ratio[LEVELS];
+
+    void push(int level, const HistBucket *b);
+};
+
+#endif
@@ -1,62 +1,172 @@
 #include "InputManager.h"
 
-// Global ISR variables
-volatile bool isrTriggered = false;
-volatile unsigned long lastIsrTime = 0;
-
-// The Interrupt Function
-void IRAM_ATTR ISR_Key0() {
-    unsigned long now = millis();
-    if (now - lastIsrTime > 250) { // 250ms hardware debounce
-        isrTriggered = true;
-        lastIsrTime = now;
+// Raw edges from the ISRs. All GPIO pins share one interrupt, so the
+// handlers below never preempt each other and together form the single
+// producer of this queue; update() is the single consumer.
+static EventQueue<InputEvent, 64> rawEvents;
+
+// Indexed by (previous AB << 2) | current AB. Valid single-bit transitions
+// count +-1; no change and impossible double transitions (bounce or a
+// missed edge) count 0.
+static const int8_t QUAD_TABLE[16] = {0,  -1, 1, 0, 1, 0, 0,  -1,
+                                      -1, 0,  0, 1, 0, 1, -1, 0};
+static const int QUARTERS_PER_DETENT = 4;
+
+// Acceleration: consecutive detents in the same direction closer together
+// than ACCEL_SLOW_MS are multiplied by ACCEL_SLOW_MS / interval, capped at
+// ACCEL_MAX.
+static const uint32_t ACCEL_SLOW_MS = 80;
+static const int ACCEL_MAX = 10;
+
+static const uint32_t DEBOUNCE_MS = 40;
+static const uint32_t LONG_PRESS_MS = 700;
+static const uint32_t DOUBLE_CLICK_MS = 300;
+
+static volatile uint8_t encLastAB = 0;
+static volatile int8_t encQuarters = 0;
+
+struct IsrButton {
+    int pin;
+    InputButton id;
+    volatile bool down;
+    volatile uint32_t lastEdgeMs;
+};
+
+static IsrButton isrButtons[] = {{Pins::ENC_BTN, BTN_ENC, false, 0},
+                                 {Pins::KEY0, BTN_BACK, false, 0}};
+
+void IRAM_ATTR ISR_Encoder() {
+    uint8_t ab = (digitalRead(Pins::ENC_A) << 1) | digitalRead(Pins::ENC_B);
+    int8_t q = encQuarters + QUAD_TABLE[(encLastAB << 2) | ab];
+    encLastAB = ab;
+    int16_t dir = 0;
+    if (q >= QUARTERS_PER_DETENT)
+        dir = 1;
+    else if (q <= -QUARTERS_PER_DETENT)
+        dir = -1;
+    encQuarters = q - dir * QUARTERS_PER_DETENT;
+    if (dir != 0) {
+        InputEvent ev = {(uint32_t)millis(), EV_ROTATE, BTN_NONE, dir, dir};
+        rawEvents.push(ev);
     }
 }
 
+static void IRAM_ATTR buttonEdge(IsrButton &b) {
+    uint32_t now = millis();
+    bool down = digitalRead(b.pin) == LOW;
+    if (down == b.down || now - b.lastEdgeMs < DEBOUNCE_MS)
+        return;
+    b.down = down;
+    b.lastEdgeMs = now;
+    InputEvent ev = {now, down ? EV_PRESS : EV_RELEASE, b.id, 0, 0};
+    rawEvents.push(ev);
+}
+
+void IRAM_ATTR ISR_EncBtn() { buttonEdge(isrButtons[0]); }
+void IRAM_ATTR ISR_Key0() { buttonEdge(isrButtons[1]); }
+
 void InputManager::begin() {
     pinMode(Pins::ENC_A, INPUT_PULLUP);
     pinMode(Pins::ENC_B, INPUT_PULLUP);
     pinMode(Pins::ENC_BTN, INPUT_PULLUP);
-    
     pinMode(Pins::KEY0, INPUT_PULLUP);
-    // Attach the interrupt to catch the press INSTANTLY
-    attachInterrupt(digitalPinToInterrupt(Pins::KEY0), ISR_Key0, FALLING);
+
+    encLastAB = (digitalRead(Pins::ENC_A) << 1) | digitalRead(Pins::ENC_B);
+    attachInterrupt(digitalPinToInterrupt(Pins::ENC_A), ISR_Encoder, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(Pins::ENC_B), ISR_Encoder, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(Pins::ENC_BTN), ISR_EncBtn, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(Pins::KEY0), ISR_Key0, CHANGE);
 }
 
-void InputManager::update() {
-    unsigned long now = millis();
-
-    // 1. Encoder Rotation
-    encStep = 0;
-    int curEncA = digitalRead(Pins::ENC_A);
-    int curEncB = digitalRead(Pins::ENC_B);
-    if (curEncA != lastEncA) {
-        if (curEncA == LOW) {
-            if (curEncB == HIGH) encStep = 1;
-            else encStep = -1;
+bool InputManager::inject(const InputEvent &ev) {
+    // Stay the single producer: keep the pin ISRs out while we push.
+    noInterrupts();
+    bool ok = rawEvents.push(ev);
+    interrupts();
+    return ok;
+}
+
+void InputManager::handleButton(const InputEvent &ev) {
+    ButtonState &b = buttons[ev.button];
+    events.push(ev);
+    if (ev.type == EV_PRESS) {
+        b.down = true;
+        b.longReported = false;
+        b.pressMs = ev.timeMs;
+        if (b.clickArmed && ev.timeMs - b.lastClickMs <= DOUBLE_CLICK_MS) {
+            InputEvent dbl = ev;
+            dbl.type = EV_DOUBLE_CLICK;
+            events.push(dbl);
+            // The press that completed a double click cannot start another
+            b.clickArmed = false;
+            b.lastClickMs = 0;
+            return;
         }
+        b.clickArmed = false;
+        b.lastClickMs = ev.timeMs;
+    } else {
+        b.down = false;
+        // A press that turned into a long press is not half of a double click
+        b.clickArmed = !b.longReported && b.lastClickMs != 0;
+        b.lastClickMs = ev.timeMs;
     }
-    lastEncA = curEncA;
-    lastEncB = curEncB;
-
-    // 2. Encoder Button
-    encPressed = false;
-    bool curBtn = digitalRead(Pins::ENC_BTN);
-    if (curBtn == LOW && lastEncBtnState == HIGH) {
-        if (now - lastEncBtnMs > 150) {
-            encPressed = true;
-            lastEncBtnMs = now;
+}
+
+void InputManager::checkHeld(InputButton id, uint32_t now) {
+    ButtonState &b = buttons[id];
+    if (b.down && !b.longReported && now - b.pressMs >= LONG_PRESS_MS) {
+        b.longReported = true;
+        InputEvent ev = {now, EV_LONG_PRESS, id, 0, 0};
+        events.push(ev);
+    }
+}
+
+void InputManager::update() {
+    InputEvent raw;
+    InputEvent rot = {(uint32_t)millis(), EV_ROTATE, BTN_NONE, 0, 0};
+    while (rawEvents.pop(raw)) {
+        if (raw.type == EV_ROTATE) {
+            uint32_t interval = raw.timeMs - lastDetentMs;
+            int mult = 1;
+            if (raw.steps == lastDir && interval < ACCEL_SLOW_MS)
+                mult = interval == 0 ? ACCEL_MAX
+                                     : min((int)(ACCEL_SLOW_MS / interval),
+                                           ACCEL_MAX);
+            lastDetentMs = raw.timeMs;
+            lastDir = raw.steps;
+            rot.timeMs = raw.timeMs;
+            rot.steps += raw.steps;
+            rot.accel += raw.steps * mult;
+            continue;
+        }
+        // Keep rotation ordered relative to button events
+        if (rot.steps != 0) {
+            events.push(rot);
+            rot.steps = rot.accel = 0;
         }
+        handleButton(raw);
     }
-    lastEncBtnState = curBtn;
-
-    // 3. Back Button (ISR Handover)
-    // We check if the ISR fired since the last update
-    if (isrTriggered) {
-        backPressed = true;
-        isrTriggered = false; // Reset the ISR flag so we don't trigger twice
-        Serial.println("Key0 ISR Triggered"); // Debug
-    } else {
-        backPressed = false;
+    if (rot.steps != 0)
+        events.push(rot);
+
+    uint32_t now = millis();
+    for (IsrButton &ib : isrButtons) {
+        // A tap shorter than the debounce window leaves the ISR thinking the
+        // button is still down; settle it from the pin level.
+        if (ib.down && digitalRead(ib.pin) == HIGH &&
+            now - ib.lastEdgeMs > DEBOUNCE_MS) {
+            noInterrupts();
+            bool stale = ib.down && digitalRead(ib.pin) == HIGH;
+            if (stale) {
+                ib.down = false;
+                ib.lastEdgeMs = now;
+            }
+            interrupts();
+            if (stale) {
+                InputEvent ev = {now, EV_RELEASE, ib.id, 0, 0};
+                handleButton(ev);
+            }
+        }
+        checkHeld(ib.id, now);
     }
-}
\ No newline at end of file
+}
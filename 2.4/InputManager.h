@@ -2,24 +2,61 @@
 #define INPUTMANAGER_H
 
 #include "Config.h"
+#include "EventQueue.h"
 #include <Arduino.h>
 
+enum InputEventType : uint8_t {
+    EV_ROTATE = 0,
+    EV_PRESS,
+    EV_RELEASE,
+    EV_LONG_PRESS,
+    EV_DOUBLE_CLICK
+};
+
+enum InputButton : uint8_t { BTN_NONE = 0, BTN_ENC, BTN_BACK };
+
+struct InputEvent {
+    uint32_t timeMs;
+    InputEventType type;
+    InputButton button;
+    int16_t steps; // EV_ROTATE: detents turned
+    int16_t accel; // EV_ROTATE: steps scaled up for fast spins
+
+    bool is(InputEventType t, InputButton b) const {
+        return type == t && button == b;
+    }
+};
+
+// Turns the raw edges queued by the ISRs into input events for the modes.
+// ISRs push rotate/press/release with the time they happened; update()
+// coalesces rotation, adds acceleration, and derives long presses and
+// double clicks. Modes read the result through poll() (StateManager does
+// this and hands each event to Mode::onInput).
 class InputManager {
   private:
-    int lastEncA = HIGH;
-    int lastEncB = HIGH;
-    bool lastEncBtnState = HIGH;
-    unsigned long lastEncBtnMs = 0;
+    struct ButtonState {
+        bool down = false;
+        bool longReported = false;
+        uint32_t pressMs = 0;
+        uint32_t lastClickMs = 0;
+        bool clickArmed = false;
+    };
 
-  public:
-    int encStep = 0;
-    bool encPressed = false;
-    
-    // This flag is set by the Interrupt Service Routine (ISR)
-    volatile bool backPressed = false;
+    EventQueue<InputEvent, 32> events;
+    ButtonState buttons[3];
+    uint32_t lastDetentMs = 0;
+    int lastDir = 0;
 
+    void handleButton(const InputEvent &ev);
+    void checkHeld(InputButton b, uint32_t now);
+
+  public:
     void begin();
     void update();
+    bool poll(InputEvent &ev) { return events.pop(ev); }
+    // Queues a raw rotate/press/release as if an ISR had seen it, for
+    // scripted input (serial console, off-device runs).
+    bool inject(const InputEvent &ev);
 };
 
-#endif
\ No newline at end of file
+#endif
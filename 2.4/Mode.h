@@ -1,6 +1,7 @@
 #ifndef MODE_H
 #define MODE_H
 
+#include "InputManager.h"
 #include <Arduino.h>
 
 class Mode {
@@ -8,7 +9,9 @@ class Mode {
     virtual ~Mode() {}
     virtual void enter() = 0;
     virtual void loop() = 0;
-    // Optional: virtual void exit() {}
+    virtual void exit() {}
+    // Called with each queued input event before loop().
+    virtual void onInput(const InputEvent &ev) {}
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "Profiler.h"
+
+#if CYBER_PROFILE
+
+#include "Globals.h"
+#include "Graphics.h"
+
+Profiler Prof;
+
+namespace {
+const char *const STAGE_NAMES[PROF_STAGES] = {"input",  "env",    "time",
+                                              "alerts", "buzzer", "ui"};
+const char *const MODE_NAMES[Profiler::MODES] = {
+    "menu",     "clock",         "pomodoro",  "alarm",      "dvd",
+    "settings", "settings_edit", "wifi_menu", "wifi_setup", "wifi_reset"};
+
+// CASET + RASET + RAMWR with their arguments
+const uint32_t WINDOW_CMD_BYTES = 11;
+} // namespace
+
+void Profiler::stageDone(ProfStage stage, uint32_t cycles) {
+    StageStats &s = stages[stage];
+    s.runs++;
+    s.totalCycles += cycles;
+    if (cycles > s.maxCycles)
+        s.maxCycles = cycles;
+}
+
+void Profiler::loopTick() {
+    uint32_t now = micros();
+    if (loops++ > 0) {
+        uint32_t dt = now - lastLoopUs;
+        if (dt > worstLoopUs)
+            worstLoopUs = dt;
+        int b = 0;
+        while (b < HIST_BUCKETS - 1 && dt >= (16UL << b))
+            b++;
+        loopHist[b]++;
+    }
+    lastLoopUs = now;
+
+    windowLoops++;
+    uint32_t ms = now / 1000;
+    if (ms - windowStartMs >= 1000) {
+        loopHz = windowLoops * 1000UL / (ms - windowStartMs);
+        windowStartMs = ms;
+        windowLoops = 0;
+    }
+}
+
+void Profiler::countWindow(uint16_t w, uint16_t h) {
+    if (paused)
+        return;
+    ModeStats &m = modes[ui.currentMode < MODES ? ui.currentMode : 0];
+    uint32_t px = (uint32_t)w * h;
+    m.windows++;
+    m.pixels += px;
+    m.bytes += px * 2 + WINDOW_CMD_BYTES;
+}
+
+void Profiler::printCsv(Print &out) const {
+    uint32_t mhz = ESP.getCpuFreqMHz();
+    out.println("stage,runs,avg_us,max_us");
+    for (int i = 0; i < PROF_STAGES; i++) {
+        const StageStats &s = stages[i];
+        uint32_t avg = s.runs ? (uint32_t)(s.totalCycles / s.runs) : 0;
+        out.printf("%s,%u,%u,%u\n", STAGE_NAMES[i], (unsigned)s.runs,
+                   (unsigned)(avg / mhz), (unsigned)(s.maxCycles / mhz));
+    }
+    out.println("mode,windows,pixels,bytes");
+    for (int i = 0; i < MODES; i++) {
+        const ModeStats &m = modes[i];
+        if (m.windows == 0)
+            continue;
+        out.printf("%s,%u,%u,%u\n", MODE_NAMES[i], (unsigned)m.windows,
+                   (unsigned)m.pixels, (unsigned)m.bytes);
+    }
+    out.printf("loop_hz,%u\nworst_loop_us,%u\n", (unsigned)loopHz,
+               (unsigned)worstLoopUs);
+    out.print("loop_hist_us");
+    for (int b = 0; b < HIST_BUCKETS; b++)
+        out.printf(",%s%lu:%u", b == HIST_BUCKETS - 1 ? ">=" : "<",
+                   b == HIST_BUCKETS - 1 ? (16UL << (b - 1)) : (16UL << b),
+                   (unsigned)loopHist[b]);
+    out.println();
+}
+
+void Profiler::drawOverlay() {
+    TextBuf<20> line;
+    line.format("%5uHz %6uus", (unsigned)loopHz, (unsigned)worstLoopUs);
+    paused = true;
+    UI::text(line.c_str(), Screen::WIDTH - 6 * (int)line.length(), 0, 1,
+             ST77XX_YELLOW, ST77XX_BLACK);
+    paused = false;
+}
+
+void Profiler::reset() {
+    for (int i = 0; i < PROF_STAGES; i++)
+        stages[i] = StageStats();
+    for (int i = 0; i < MODES; i++)
+        modes[i] = ModeStats();
+    for (int b = 0; b < HIST_BUCKETS; b++)
+        loopHist[b] = 0;
+    loops = 0;
+    worstLoopUs = 0;
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "Config.h"
+#include <Adafruit_ST7789.h>
+#include <Arduino.h>
+
+// Top-level stages of loop(), one per scheduler task.
+enum ProfStage : uint8_t {
+    PROF_INPUT = 0,
+    PROF_ENV,
+    PROF_TIME,
+    PROF_ALERTS,
+    PROF_BUZZER,
+    PROF_UI,
+    PROF_STAGES
+};
+
+#if CYBER_PROFILE
+
+// Collects cycle counts per stage, display traffic per UI mode, and a
+// histogram of loop() intervals. Everything is fixed-size and updated in
+// place, so profiling adds no allocation to the paths it measures.
+class Profiler {
+  public:
+    static const int MODES = 10;        // UIMode values
+    static const int HIST_BUCKETS = 12; // <16us, <32us, ... , >=16ms
+
+    struct StageStats {
+        uint32_t runs = 0;
+        uint64_t totalCycles = 0;
+        uint32_t maxCycles = 0;
+    };
+    struct ModeStats {
+        uint32_t windows = 0;
+        uint32_t pixels = 0;
+        uint32_t bytes = 0; // pixel data plus address-window commands
+    };
+
+    void stageDone(ProfStage stage, uint32_t cycles);
+    void loopTick();
+    void countWindow(uint16_t w, uint16_t h);
+
+    void printCsv(Print &out) const;
+    void drawOverlay();
+    void reset();
+
+    uint32_t cycles() const { return counter(); }
+    // Cycle source; swap for a fake counter off-device.
+    void setCycleCounter(uint32_t (*fn)()) { counter = fn; }
+
+  private:
+    StageStats stages[PROF_STAGES];
+    ModeStats modes[MODES];
+    uint32_t loopHist[HIST_BUCKETS] = {};
+    uint32_t loops = 0;
+    uint32_t worstLoopUs = 0;
+    uint32_t lastLoopUs = 0;
+    uint32_t windowStartMs = 0;
+    uint32_t windowLoops = 0;
+    uint32_t loopHz = 0;
+    bool paused = false; // don't count the overlay's own drawing
+    uint32_t (*counter)() = defaultCounter;
+
+    static uint32_t defaultCounter() { return ESP.getCycleCount(); }
+};
+
+extern Profiler Prof;
+
+class ProfileScope {
+  public:
+    explicit ProfileScope(ProfStage s) : stage(s), start(Prof.cycles()) {}
+    ~ProfileScope() { Prof.stageDone(stage, Prof.cycles() - start); }
+
+  private:
+    ProfStage stage;
+    uint32_t start;
+};
+
+// Counts every address window the driver opens. All GFX primitives and
+// our own blits go through setAddrWindow, so this sees all panel traffic.
+class ProfiledST7789 : public Adafruit_ST7789 {
+  public:
+    using Adafruit_ST7789::Adafruit_ST7789;
+    void setAddrWindow(uint16_t x, uint16_t y, uint16_t w,
+                       uint16_t h) override {
+        Prof.countWindow(w, h);
+        Adafruit_ST7789::setAddrWindow(x, y, w, h);
+    }
+};
+
+typedef ProfiledST7789 Display;
+#define PROFILE_SCOPE(stage) ProfileScope profileScope(stage)
+#define PROFILE_LOOP() Prof.loopTick()
+
+#else
+
+typedef Adafruit_ST7789 Display;
+#define PROFILE_SCOPE(stage) ((void)0)
+#define PROFILE_LOOP() ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef ROLLINGMINMAX_H
+#define ROLLINGMINMAX_H
+
+#include <Arduino.h>
+
+// Minimum and maximum over the last N pushed ranges, in amortised O(1)
+// per push. Each side is a monotonic queue: a new low evicts every queued
+// low that is not smaller (those can never be the minimum again), and the
+// front is dropped once it slides out of the window.
+template <uint16_t N> class RollingMinMax {
+  private:
+    struct Entry {
+        uint16_t seq;
+        uint16_t value;
+    };
+
+    struct Queue {
+        Entry items[N];
+        uint16_t head = 0;
+        uint16_t size = 0;
+
+        Entry &at(uint16_t i) {
+            uint16_t k = head + i;
+            return items[k >= N ? k - N : k];
+        }
+        const Entry &front() const { return items[head]; }
+        void popFront() {
+            head = head + 1 == N ? 0 : head + 1;
+            size--;
+        }
+        // Drops entries from the back while keep(back) is false, then
+        // appends e.
+        template <typename Keep> void pushBack(const Entry &e, Keep keep) {
+            while (size > 0 && !keep(at(size - 1)))
+                size--;
+            at(size++) = e;
+        }
+    };
+
+    Queue lows;
+    Queue highs;
+    uint16_t seq = 0;
+
+    void expire(Queue &q) {
+        while (q.size > 0 && (uint16_t)(seq - q.front().seq) >= N)
+            q.popFront();
+    }
+
+  public:
+    void clear() {
+        lows.head = lows.size = 0;
+        highs.head = highs.size = 0;
+        seq = 0;
+    }
+
+    // Adds the range [lo, hi] of the newest sample.
+    void push(uint16_t lo, uint16_t hi) {
+        seq++;
+        // Expire first so the queues always have room for the new entry
+        expire(lows);
+        expire(highs);
+        lows.pushBack({seq, lo},
+                      [lo](const Entry &e) { return e.value < lo; });
+        highs.pushBack({seq, hi},
+                       [hi](const Entry &e) { return e.value > hi; });
+    }
+
+    bool empty() const { return lows.size == 0; }
+    uint16_t min() const { return lows.front().value; }
+    uint16_t max() const { return highs.front().value; }
+};
+
+#endif
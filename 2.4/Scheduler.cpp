@@ -0,0 +1,97 @@
+#include "Scheduler.h"
+
+Scheduler Tasks;
+
+int Scheduler::add(const char *name, uint32_t periodUs, uint32_t delayUs,
+                   TaskFn fn, uint32_t deadlineUs, bool oneShot) {
+    for (int i = 0; i < MAX_TASKS; i++) {
+        Task &t = tasks[i];
+        if (t.active)
+            continue;
+        t.name = name;
+        t.fn = fn;
+        t.periodUs = periodUs;
+        t.deadlineUs = deadlineUs;
+        t.dueUs = clock() + delayUs;
+        t.oneShot = oneShot;
+        t.stats = TaskStats();
+        t.active = true;
+        return i;
+    }
+    Serial.println("Scheduler full");
+    return -1;
+}
+
+int Scheduler::every(const char *name, uint32_t periodMs, TaskFn fn,
+                     uint32_t deadlineMs) {
+    return add(name, periodMs * 1000UL, 0, fn, deadlineMs * 1000UL, false);
+}
+
+int Scheduler::after(uint32_t delayMs, TaskFn fn, const char *name) {
+    return add(name, 0, delayMs * 1000UL, fn, 0, true);
+}
+
+void Scheduler::cancel(int id) {
+    if (id >= 0 && id < MAX_TASKS)
+        tasks[id].active = false;
+}
+
+void Scheduler::tick() {
+    for (int i = 0; i < MAX_TASKS; i++) {
+        Task &t = tasks[i];
+        if (!t.active)
+            continue;
+        uint32_t start = clock();
+        int32_t late = (int32_t)(start - t.dueUs);
+        if (late < 0)
+            continue;
+
+        if (t.periodUs > 0 || t.oneShot) {
+            if ((uint32_t)late > t.stats.maxJitterUs)
+                t.stats.maxJitterUs = late;
+            if (t.deadlineUs > 0 && (uint32_t)late > t.deadlineUs)
+                t.stats.missed++;
+        }
+        if (t.oneShot) {
+            t.active = false;
+        } else {
+            // Stay on the original grid unless we fell a whole period behind.
+            t.dueUs += t.periodUs;
+            if ((int32_t)(start - t.dueUs) >= 0)
+                t.dueUs = start + t.periodUs;
+        }
+
+        t.fn();
+
+        uint32_t took = clock() - start;
+        t.stats.runs++;
+        t.stats.totalUs += took;
+        if (took > t.stats.maxUs)
+            t.stats.maxUs = took;
+    }
+}
+
+const TaskStats *Scheduler::stats(int id) const {
+    if (id < 0 || id >= MAX_TASKS)
+        return nullptr;
+    return &tasks[id].stats;
+}
+
+void Scheduler::printStats(Print &out) const {
+    out.println("task,runs,avg_us,max_us,max_jitter_us,missed");
+    for (int i = 0; i < MAX_TASKS; i++) {
+        const Task &t = tasks[i];
+        if (!t.active || t.oneShot)
+            continue;
+        const TaskStats &s = t.stats;
+        out.printf("%s,%u,%u,%u,%u,%u\n", t.name, (unsigned)s.runs,
+                   (unsigned)(s.runs ? s.totalUs / s.runs : 0),
+                   (unsigned)s.maxUs, (unsigned)s.maxJitterUs,
+                   (unsigned)s.missed);
+    }
+}
+
+void Scheduler::resetStats() {
+    for (int i = 0; i < MAX_TASKS; i++)
+        tasks[i].stats = TaskStats();
+}
@@ -0,0 +1,64 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+typedef void (*TaskFn)();
+
+struct TaskStats {
+    uint32_t runs = 0;
+    uint64_t totalUs = 0; // uint32_t would wrap after ~71 min of runtime
+    uint32_t maxUs = 0;
+    uint32_t maxJitterUs = 0; // worst lateness of a start versus its due time
+    uint32_t missed = 0;      // starts later than the task's deadline
+};
+
+// Cooperative tick scheduler driven from loop(). Tasks never block; anything
+// that used to delay() is split into work scheduled for later.
+//
+// Within a tick tasks run in slot order. New tasks take the first free
+// slot, so that is registration order only until a task is cancelled or a
+// one-shot finishes and its slot is reused.
+class Scheduler {
+  public:
+    static const int MAX_TASKS = 16;
+
+    // Runs fn every periodMs (0 = every tick). A start more than deadlineMs
+    // after its due time counts as a miss (0 = no deadline).
+    int every(const char *name, uint32_t periodMs, TaskFn fn,
+              uint32_t deadlineMs = 0);
+    // Runs fn once, delayMs from now.
+    int after(uint32_t delayMs, TaskFn fn, const char *name = "oneshot");
+    void cancel(int id);
+    void tick();
+
+    const TaskStats *stats(int id) const;
+    void printStats(Print &out) const;
+    void resetStats();
+
+    // Time source in microseconds; swap for a fake clock off-device.
+    void setClock(uint32_t (*nowUs)()) { clock = nowUs; }
+
+  private:
+    struct Task {
+        const char *name;
+        TaskFn fn;
+        uint32_t periodUs;
+        uint32_t deadlineUs;
+        uint32_t dueUs;
+        bool active;
+        bool oneShot;
+        TaskStats stats;
+    };
+
+    Task tasks[MAX_TASKS] = {};
+    uint32_t (*clock)() = defaultClock;
+
+    static uint32_t defaultClock() { return micros(); }
+    int add(const char *name, uint32_t periodUs, uint32_t delayUs, TaskFn fn,
+            uint32_t deadlineUs, bool oneShot);
+};
+
+extern Scheduler Tasks;
+
+#endif
@@ -0,0 +1,63 @@
+#include "SensorTask.h"
+#include "Globals.h"
+
+SensorTask Sensors;
+
+void SensorTask::begin() {
+    if (handle != nullptr)
+        return;
+    // The C3 has a single core; pinning keeps this portable to dual-core
+    // parts, where the loop task runs on ARDUINO_RUNNING_CORE.
+    xTaskCreatePinnedToCore(run, "sensors", STACK_BYTES, this, PRIORITY,
+                            &handle, 0);
+}
+
+bool SensorTask::poll(EnvSample &out) {
+    // Cheap check first; the copy only happens when something is new
+    if (latest.version() == seenVersion)
+        return false;
+    uint32_t v;
+    if (!latest.read(out, v) || v == seenVersion)
+        return false;
+    seenVersion = v;
+    return true;
+}
+
+void SensorTask::measure(EnvSample &sample) {
+    sensors_event_t hum, temp;
+    if (aht.getEvent(&hum, &temp)) {
+        sample.temp = temp.temperature;
+        sample.hum = hum.relative_humidity;
+    }
+    ens160.set_envdata(sample.temp, sample.hum);
+    ens160.measure();
+    uint16_t newTVOC = ens160.getTVOC();
+    uint16_t newCO2 = ens160.geteCO2();
+    if (newTVOC != 0xFFFF)
+        sample.tvoc = newTVOC;
+    if (newCO2 != 0xFFFF)
+        sample.eco2 = newCO2;
+    sample.timeMs = millis();
+}
+
+void SensorTask::run(void *arg) {
+    SensorTask *self = static_cast<SensorTask *>(arg);
+
+    // Sensor bring-up blocks on I2C too, so it happens here rather than
+    // in setup().
+    if (!aht.begin())
+        Serial.println("AHT21 not found");
+    if (!ens160.begin())
+        Serial.println("ENS160 begin FAIL");
+    else
+        ens160.setMode(ENS160_OPMODE_STD);
+
+    // Keep the last good values across failed reads
+    EnvSample sample;
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        self->measure(sample);
+        self->latest.write(sample);
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(PERIOD_MS));
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef SENSORTASK_H
+#define SENSORTASK_H
+
+#include "Seqlock.h"
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+struct EnvSample {
+    float temp = 0;
+    float hum = 0;
+    uint16_t tvoc = 0;
+    uint16_t eco2 = 0;
+    uint32_t timeMs = 0;
+};
+
+// Owns the I2C sensors. A FreeRTOS task initialises the AHT21 and ENS160
+// and then reads them every PERIOD_MS, publishing each result through a
+// seqlock; the UI only ever copies the latest snapshot and never waits on
+// the bus.
+class SensorTask {
+  public:
+    static const uint32_t PERIOD_MS = 1000;
+    static const uint32_t STACK_BYTES = 4096;
+    static const UBaseType_t PRIORITY = 1; // same as the Arduino loop task
+
+    void begin();
+    // Copies the newest sample into out. Returns false if nothing new has
+    // been published since the last successful call.
+    bool poll(EnvSample &out);
+
+  private:
+    Seqlock<EnvSample> latest;
+    uint32_t seenVersion = 0;
+    TaskHandle_t handle = nullptr;
+
+    static void run(void *arg);
+    void measure(EnvSample &sample);
+};
+
+extern SensorTask Sensors;
+
+#endif
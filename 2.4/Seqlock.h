@@ -0,0 +1,56 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Single-writer sequence lock for handing a small struct from one task to
+// another without a mutex. The writer bumps the sequence to odd, copies the
+// data, then bumps it to even; a reader retries if the sequence was odd or
+// changed under it. Only plain loads and stores are used, so it needs no
+// atomic read-modify-write support from the CPU.
+template <typename T> class Seqlock {
+  private:
+    std::atomic<uint32_t> seq{0};
+    T data;
+
+  public:
+    void write(const T &value) {
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        data = value;
+        std::atomic_thread_fence(std::memory_order_release);
+        seq.store(s + 2, std::memory_order_relaxed);
+    }
+
+    // Copies the latest value into out. Gives up after a few attempts
+    // rather than spinning: on a single core a higher-priority reader would
+    // otherwise starve the writer it is waiting for.
+    bool read(T &out) const {
+        uint32_t version;
+        return read(out, version);
+    }
+
+    // As above, also returning the version of the copy, so a caller
+    // tracking versions never pairs a value with a different one's version.
+    bool read(T &out, uint32_t &version) const {
+        for (int attempt = 0; attempt < 4; attempt++) {
+            uint32_t s = seq.load(std::memory_order_acquire);
+            if (s & 1)
+                continue;
+            out = data;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == s) {
+                version = s;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Even and increasing; changes every time a new value is published.
+    uint32_t version() const { return seq.load(std::memory_order_acquire); }
+};
+
+#endif
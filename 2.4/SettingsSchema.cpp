@@ -0,0 +1,84 @@
+#include "SettingsSchema.h"
+
+namespace Schema {
+
+int get(const AppSettings &s, SettingId id) {
+    const SettingDef &f = FIELDS[id];
+    const uint8_t *p = (const uint8_t *)&s + f.offset;
+    switch (f.type) {
+    case TYPE_U8:
+        return *p;
+    case TYPE_BOOL:
+        return *(const bool *)p ? 1 : 0;
+    default:
+        return *(const int *)p;
+    }
+}
+
+int clamp(SettingId id, int v) {
+    const SettingDef &f = FIELDS[id];
+    if (f.choices != nullptr) {
+        // Snap to the nearest allowed value
+        int best = f.choices[0];
+        for (int i = 1; i < f.choiceCount; i++)
+            if (abs(f.choices[i] - v) < abs(best - v))
+                best = f.choices[i];
+        return best;
+    }
+    return constrain(v, f.min, f.max);
+}
+
+void set(AppSettings &s, SettingId id, int v) {
+    const SettingDef &f = FIELDS[id];
+    uint8_t *p = (uint8_t *)&s + f.offset;
+    v = clamp(id, v);
+    switch (f.type) {
+    case TYPE_U8:
+        *p = (uint8_t)v;
+        break;
+    case TYPE_BOOL:
+        *(bool *)p = v != 0;
+        break;
+    default:
+        *(int *)p = v;
+        break;
+    }
+}
+
+int adjust(AppSettings &s, SettingId id, int delta) {
+    const SettingDef &f = FIELDS[id];
+    int v = get(s, id);
+    if (delta == 0)
+        return v;
+
+    if (f.type == TYPE_BOOL) {
+        v = !v;
+    } else if (f.choices != nullptr) {
+        int idx = 0;
+        while (idx < f.choiceCount - 1 && f.choices[idx] != v)
+            idx++;
+        idx = constrain(idx + delta, 0, f.choiceCount - 1);
+        v = f.choices[idx];
+    } else if (f.wraps) {
+        int span = f.max - f.min + 1;
+        v = ((v - f.min + delta * f.step) % span + span) % span + f.min;
+    } else {
+        v += delta * f.step;
+    }
+    set(s, id, v);
+    return get(s, id);
+}
+
+void applyDefaults(AppSettings &s) {
+    for (int i = 0; i < SETTING_COUNT; i++)
+        set(s, (SettingId)i, FIELDS[i].def);
+}
+
+bool equal(const AppSettings &a, const AppSettings &b) {
+    for (int i = 0; i < SETTING_COUNT; i++)
+        if (get(a, (SettingId)i) != get(b, (SettingId)i))
+            return false;
+    return true;
+}
+
+} // namespace Schema
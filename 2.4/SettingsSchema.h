@@ -0,0 +1,238 @@
+#ifndef SETTINGSSCHEMA_H
+#define SETTINGSSCHEMA_H
+
+#include "Config.h"
+#include "Types.h"
+#include <Arduino.h>
+#include <stddef.h>
+#include <type_traits>
+#include <utility>
+
+// Every persisted setting. The store writes values in this order, so new
+// settings are only ever appended.
+enum SettingId : uint8_t {
+    SET_LED_BRIGHTNESS = 0,
+    SET_SPEAKER_VOL,
+    SET_GRAPH_RANGE,
+    SET_GRAPH_AUTOSCALE,
+    SET_ALARM1_HOUR,
+    SET_ALARM1_MINUTE,
+    SET_ALARM1_ENABLED,
+    SET_POMO_WORK,
+    SET_POMO_SHORT,
+    SET_POMO_LONG,
+    SET_POMO_CYCLES,
+    SET_ALARM1_DAYS,
+    SET_ALARM2_HOUR,
+    SET_ALARM2_MINUTE,
+    SET_ALARM2_ENABLED,
+    SET_ALARM2_DAYS,
+    SET_ALARM3_HOUR,
+    SET_ALARM3_MINUTE,
+    SET_ALARM3_ENABLED,
+    SET_ALARM3_DAYS,
+    SET_ALARM4_HOUR,
+    SET_ALARM4_MINUTE,
+    SET_ALARM4_ENABLED,
+    SET_ALARM4_DAYS,
+    // Per alert rule: enabled, channel, kind, level, threshold,
+    // hysteresis, hold, window
+    SET_ALERT1_FIRST,
+    SET_ALERT_LAST = SET_ALERT1_FIRST + ALERT_RULE_COUNT * 8 - 1,
+    SETTING_COUNT
+};
+
+enum SettingType : uint8_t { TYPE_INT, TYPE_U8, TYPE_BOOL };
+
+// How the generic edit screen shows a value.
+enum SettingFormat : uint8_t {
+    FMT_NUMBER,
+    FMT_PERCENT,
+    FMT_DURATION,
+    FMT_AUTO_FIXED,
+    FMT_ON_OFF
+};
+
+struct SettingDef {
+    // NVS key from before settings were stored as a blob; later fields
+    // only need a unique name
+    const char *key;
+    const char *label;
+    SettingType type;
+    uint8_t offset;
+    SettingFormat format;
+    int16_t def;
+    int16_t min;
+    int16_t max;
+    int16_t step;  // per encoder detent
+    bool wraps;    // past max comes back at min, like a clock
+    const int *choices; // if set, the value must be one of these
+    uint8_t choiceCount;
+};
+
+namespace Schema {
+
+template <typename T> struct TypeOf;
+template <> struct TypeOf<int> {
+    static constexpr SettingType value = TYPE_INT;
+};
+template <> struct TypeOf<uint8_t> {
+    static constexpr SettingType value = TYPE_U8;
+};
+template <> struct TypeOf<bool> {
+    static constexpr SettingType value = TYPE_BOOL;
+};
+
+// The type is taken from the member itself, so the table cannot disagree
+// with AppSettings. m may name an array element, e.g. alarms[1].hour.
+#define SETTING_FIELD(m)                                                       \
+    Schema::TypeOf<std::remove_reference<decltype(                           \
+        std::declval<AppSettings &>().m)>::type>::value,                       \
+        offsetof(AppSettings, m)
+
+// Every day, as the single alarm always was
+constexpr int16_t ALARM_DAYS_ALL = 0x7F;
+
+constexpr SettingDef FIELDS[] = {
+    {"led_b", "LED Brightness", SETTING_FIELD(ledBrightness), FMT_PERCENT,
+     100, 0, 100, 5, false, nullptr, 0},
+    {"spk_v", "Speaker Volume", SETTING_FIELD(speakerVol), FMT_PERCENT, 100,
+     0, 100, 5, false, nullptr, 0},
+    {"gr_dur", "Graph Range", SETTING_FIELD(graphDuration), FMT_DURATION, 5,
+     5, 1440, 1, false, Graph::RANGES_MIN, Graph::RANGE_COUNT},
+    {"gr_auto", "Graph Scale", SETTING_FIELD(graphAutoScale), FMT_AUTO_FIXED,
+     1, 0, 1, 1, true, nullptr, 0},
+    {"alm_h", "Alarm Hour", SETTING_FIELD(alarms[0].hour), FMT_NUMBER, 7, 0,
+     23, 1, true, nullptr, 0},
+    {"alm_m", "Alarm Minute", SETTING_FIELD(alarms[0].minute), FMT_NUMBER, 0,
+     0, 59, 1, true, nullptr, 0},
+    {"alm_e", "Alarm", SETTING_FIELD(alarms[0].enabled), FMT_ON_OFF, 0, 0, 1,
+     1, true, nullptr, 0},
+    {"p_work", "Set Work", SETTING_FIELD(pomoWorkMin), FMT_NUMBER, 25, 1,
+     90, 1, false, nullptr, 0},
+    {"p_short", "Short Break", SETTING_FIELD(pomoShortMin), FMT_NUMBER, 5, 1,
+     30, 1, false, nullptr, 0},
+    {"p_long", "Long Break", SETTING_FIELD(pomoLongMin), FMT_NUMBER, 15, 1,
+     60, 1, false, nullptr, 0},
+    {"p_cycl", "Set Cycles", SETTING_FIELD(pomoCycles), FMT_NUMBER, 4, 1, 10,
+     1, false, nullptr, 0},
+    {"alm_d", "Alarm Days", SETTING_FIELD(alarms[0].days), FMT_NUMBER,
+     ALARM_DAYS_ALL, 0, 127, 1, false, nullptr, 0},
+// Alarms 2-4; alarm 1 keeps its original slots above
+#define ALARM_SETTINGS(i, h, m, e, d)                                          \
+    {h, "Alarm Hour", SETTING_FIELD(alarms[i].hour), FMT_NUMBER, 7, 0, 23,    \
+     1, true, nullptr, 0},                                                     \
+    {m, "Alarm Minute", SETTING_FIELD(alarms[i].minute), FMT_NUMBER, 0, 0,    \
+     59, 1, true, nullptr, 0},                                                 \
+    {e, "Alarm", SETTING_FIELD(alarms[i].enabled), FMT_ON_OFF, 0, 0, 1, 1,    \
+     true, nullptr, 0},                                                        \
+    {d, "Alarm Days", SETTING_FIELD(alarms[i].days), FMT_NUMBER,              \
+     ALARM_DAYS_ALL, 0, 127, 1, false, nullptr, 0}
+    ALARM_SETTINGS(1, "alm2_h", "alm2_m", "alm2_e", "alm2_d"),
+    ALARM_SETTINGS(2, "alm3_h", "alm3_m", "alm3_e", "alm3_d"),
+    ALARM_SETTINGS(3, "alm4_h", "alm4_m", "alm4_e", "alm4_d"),
+#undef ALARM_SETTINGS
+#define ALERT_SETTINGS(i, k, en_, ch_, kind_, lvl_, thr_, hy_, hold_, win_)    \
+    {k "e", "Alert", SETTING_FIELD(alertRules[i].enabled), FMT_ON_OFF, en_, 0, \
+     1, 1, true, nullptr, 0},                                                  \
+    {k "c", "Alert Channel", SETTING_FIELD(alertRules[i].channel),             \
+     FMT_NUMBER, ch_, 0, HIST_CHANNELS - 1, 1, true, nullptr, 0},              \
+    {k "k", "Alert Kind", SETTING_FIELD(alertRules[i].kind), FMT_NUMBER,       \
+     kind_, RULE_ABOVE, RULE_RISE, 1, true, nullptr, 0},                       \
+    {k "l", "Alert Level", SETTING_FIELD(alertRules[i].level), FMT_NUMBER,     \
+     lvl_, ALERT_NOTICE, ALERT_WARNING, 1, false, nullptr, 0},                 \
+    {k "t", "Threshold", SETTING_FIELD(alertRules[i].threshold), FMT_NUMBER,   \
+     thr_, -1000, 10000, 10, false, nullptr, 0},                               \
+    {k "h", "Hysteresis", SETTING_FIELD(alertRules[i].hysteresis),             \
+     FMT_NUMBER, hy_, 0, 2000, 5, false, nullptr, 0},                          \
+    {k "d", "Hold Time", SETTING_FIELD(alertRules[i].holdS), FMT_NUMBER,       \
+     hold_, 0, 3600, 5, false, nullptr, 0},                                    \
+    {k "w", "Rise Window", SETTING_FIELD(alertRules[i].windowMin), FMT_NUMBER, \
+     win_, 1, 30, 1, false, nullptr, 0}
+    // The first rule is the eCO2 alarm the firmware always had
+    ALERT_SETTINGS(0, "ar1_", 1, HIST_CO2, RULE_ABOVE, ALERT_WARNING, 1800,
+                   200, 30, 10),
+    ALERT_SETTINGS(1, "ar2_", 1, HIST_CO2, RULE_RISE, ALERT_NOTICE, 200, 50,
+                   0, 10),
+    ALERT_SETTINGS(2, "ar3_", 0, HIST_TVOC, RULE_ABOVE, ALERT_NOTICE, 1000,
+                   150, 60, 10),
+    ALERT_SETTINGS(3, "ar4_", 0, HIST_HUM, RULE_BELOW, ALERT_NOTICE, 25, 3,
+                   300, 10),
+#undef ALERT_SETTINGS
+};
+
+#undef SETTING_FIELD
+
+// Shown by SettingsMode, in this order, ahead of the WiFi entry.
+constexpr SettingId MENU[] = {SET_LED_BRIGHTNESS, SET_SPEAKER_VOL,
+                              SET_GRAPH_RANGE, SET_GRAPH_AUTOSCALE};
+constexpr int MENU_COUNT = sizeof(MENU) / sizeof(MENU[0]);
+
+constexpr bool inChoices(const SettingDef &f, int v, int i) {
+    return i < f.choiceCount && (f.choices[i] == v || inChoices(f, v, i + 1));
+}
+
+constexpr bool typeFits(const SettingDef &f) {
+    return f.type == TYPE_INT ||
+           (f.type == TYPE_U8 && f.min >= 0 && f.max <= 255) ||
+           (f.type == TYPE_BOOL && f.min == 0 && f.max == 1);
+}
+
+constexpr bool fieldValid(const SettingDef &f) {
+    return typeFits(f) && f.min <= f.def && f.def <= f.max && f.step > 0 &&
+           (f.choices == nullptr || inChoices(f, f.def, 0));
+}
+
+constexpr bool allValid(int i) {
+    return i >= SETTING_COUNT || (fieldValid(FIELDS[i]) && allValid(i + 1));
+}
+
+static_assert(sizeof(FIELDS) / sizeof(FIELDS[0]) == SETTING_COUNT,
+              "one FIELDS entry per SettingId");
+static_assert(allValid(0), "setting default or bounds invalid");
+
+// The settings behind each alarm, by AlarmField.
+enum AlarmField : uint8_t {
+    ALARM_HOUR = 0,
+    ALARM_MINUTE,
+    ALARM_ENABLED,
+    ALARM_DAYS,
+    ALARM_FIELDS
+};
+constexpr SettingId ALARMS[ALARM_COUNT][ALARM_FIELDS] = {
+    {SET_ALARM1_HOUR, SET_ALARM1_MINUTE, SET_ALARM1_ENABLED, SET_ALARM1_DAYS},
+    {SET_ALARM2_HOUR, SET_ALARM2_MINUTE, SET_ALARM2_ENABLED, SET_ALARM2_DAYS},
+    {SET_ALARM3_HOUR, SET_ALARM3_MINUTE, SET_ALARM3_ENABLED, SET_ALARM3_DAYS},
+    {SET_ALARM4_HOUR, SET_ALARM4_MINUTE, SET_ALARM4_ENABLED, SET_ALARM4_DAYS},
+};
+
+constexpr bool alarmSlot(int i, AlarmField f, size_t member) {
+    return FIELDS[ALARMS[i][f]].offset ==
+           offsetof(AppSettings, alarms) + i * sizeof(AlarmSpec) + member;
+}
+
+constexpr bool alarmsValid(int i) {
+    return i >= ALARM_COUNT ||
+           (alarmSlot(i, ALARM_HOUR, offsetof(AlarmSpec, hour)) &&
+            alarmSlot(i, ALARM_MINUTE, offsetof(AlarmSpec, minute)) &&
+            alarmSlot(i, ALARM_ENABLED, offsetof(AlarmSpec, enabled)) &&
+            alarmSlot(i, ALARM_DAYS, offsetof(AlarmSpec, days)) &&
+            alarmsValid(i + 1));
+}
+
+static_assert(alarmsValid(0), "ALARMS does not match AppSettings::alarms");
+
+inline const SettingDef &field(SettingId id) { return FIELDS[id]; }
+
+int get(const AppSettings &s, SettingId id);
+// Stores v after forcing it into the field's bounds.
+void set(AppSettings &s, SettingId id, int v);
+int clamp(SettingId id, int v);
+// Moves a setting by delta encoder detents and returns the new value.
+int adjust(AppSettings &s, SettingId id, int delta);
+void applyDefaults(AppSettings &s);
+bool equal(const AppSettings &a, const AppSettings &b);
+
+} // namespace Schema
+
+#endif
@@ -0,0 +1,187 @@
+#include "SettingsStore.h"
+#include "Globals.h"
+#include <esp_rom_crc.h>
+
+SettingsStore Store;
+
+static const char *NAMESPACE = "cyber";
+static const char *BLOB_KEY = "cfg";
+static const uint16_t MAGIC = 0x5E77;
+
+// Blob version 1 was a copy of AppSettings as it was then. Frozen here:
+// the live struct has changed since, so it cannot decode v1.
+struct AppSettingsV1 {
+    int ledBrightness;
+    int speakerVol;
+    int graphDuration;
+    bool graphAutoScale;
+    uint8_t alarmHour;
+    uint8_t alarmMinute;
+    bool alarmEnabled;
+    int pomoWorkMin;
+    int pomoShortMin;
+    int pomoLongMin;
+    int pomoCycles;
+};
+
+// v1 fields in SettingId order; they are the first ids of the schema.
+static void readV1(AppSettings &out, const AppSettingsV1 &v) {
+    const int values[] = {v.ledBrightness,  v.speakerVol,   v.graphDuration,
+                          v.graphAutoScale, v.alarmHour,    v.alarmMinute,
+                          v.alarmEnabled,   v.pomoWorkMin,  v.pomoShortMin,
+                          v.pomoLongMin,    v.pomoCycles};
+    static_assert(sizeof(values) / sizeof(values[0]) == SET_POMO_CYCLES + 1,
+                  "v1 covers the ids up to SET_POMO_CYCLES");
+    for (int i = 0; i <= SET_POMO_CYCLES; i++)
+        Schema::set(out, (SettingId)i, values[i]);
+}
+
+void SettingsStore::load(AppSettings &out) {
+    if (lock == nullptr)
+        lock = xSemaphoreCreateMutex();
+
+    if (readBlob(out)) {
+        stored = out;
+    } else {
+        readLegacy(out);
+        // Boot is the one place a synchronous write is fine
+        xSemaphoreTake(lock, portMAX_DELAY);
+        write(out);
+        prefs.begin(NAMESPACE, false);
+        for (const SettingDef &f : Schema::FIELDS)
+            if (prefs.isKey(f.key))
+                prefs.remove(f.key);
+        prefs.end();
+        xSemaphoreGive(lock);
+    }
+
+    if (handle == nullptr)
+        xTaskCreatePinnedToCore(run, "settings", STACK_BYTES, this, PRIORITY,
+                                &handle, 0);
+}
+
+bool SettingsStore::readBlob(AppSettings &out) {
+    static_assert(sizeof(Header) + PAYLOAD_BYTES <= MAX_BLOB_BYTES,
+                  "settings outgrew MAX_BLOB_BYTES");
+    uint8_t buf[MAX_BLOB_BYTES];
+    prefs.begin(NAMESPACE, true);
+    size_t len = prefs.getBytesLength(BLOB_KEY);
+    bool ok = len >= sizeof(Header) && len <= sizeof(buf) &&
+              prefs.getBytes(BLOB_KEY, buf, len) == len;
+    prefs.end();
+    if (!ok) {
+        if (len > sizeof(buf))
+            Serial.println("Settings blob too large");
+        return false;
+    }
+
+    Header h;
+    memcpy(&h, buf, sizeof(h));
+    const uint8_t *payload = buf + sizeof(Header);
+    if (h.magic != MAGIC || h.size != len - sizeof(Header) ||
+        esp_rom_crc32_le(0, payload, h.size) != h.crc) {
+        Serial.println("Settings blob invalid");
+        return false;
+    }
+
+    Schema::applyDefaults(out);
+    if (h.version == 1) {
+        if (h.size != sizeof(AppSettingsV1)) {
+            Serial.println("Settings blob v1 has the wrong size");
+            return false;
+        }
+        AppSettingsV1 old = {};
+        memcpy(&old, payload, sizeof(old));
+        readV1(out, old);
+    } else {
+        // One value per schema field. An older blob is a prefix and the
+        // rest keep their defaults; of a newer one only the fields this
+        // firmware knows are read.
+        int count = min((int)(h.size / sizeof(int32_t)), (int)SETTING_COUNT);
+        for (int i = 0; i < count; i++) {
+            int32_t v;
+            memcpy(&v, payload + i * sizeof(int32_t), sizeof(v));
+            Schema::set(out, (SettingId)i, v);
+        }
+    }
+    if (h.version != VERSION)
+        Serial.printf("Settings migrated from v%u\n", h.version);
+    return true;
+}
+
+void SettingsStore::readLegacy(AppSettings &out) {
+    prefs.begin(NAMESPACE, true);
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        const SettingDef &f = Schema::FIELDS[i];
+        int v = f.type == TYPE_BOOL ? prefs.getBool(f.key, f.def)
+                                    : prefs.getInt(f.key, f.def);
+        Schema::set(out, (SettingId)i, v);
+    }
+    prefs.end();
+}
+
+void SettingsStore::requestSave() {
+    dirty = true;
+    changedMs = millis();
+}
+
+void SettingsStore::update() {
+    if (!dirty || millis() - changedMs < DEBOUNCE_MS)
+        return;
+    dirty = false;
+    pending.write(settings);
+    if (handle != nullptr)
+        xTaskNotifyGive(handle);
+}
+
+void SettingsStore::flush() {
+    // Also covers a change already handed to the writer but not yet written
+    dirty = false;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (changed(settings))
+        write(settings);
+    xSemaphoreGive(lock);
+}
+
+bool SettingsStore::changed(const AppSettings &s) const {
+    return !Schema::equal(s, stored);
+}
+
+// Called with lock held.
+void SettingsStore::write(const AppSettings &s) {
+    uint8_t buf[sizeof(Header) + PAYLOAD_BYTES];
+    uint8_t *payload = buf + sizeof(Header);
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        int32_t v = Schema::get(s, (SettingId)i);
+        memcpy(payload + i * sizeof(int32_t), &v, sizeof(v));
+    }
+    Header h;
+    h.magic = MAGIC;
+    h.version = VERSION;
+    h.size = PAYLOAD_BYTES;
+    h.reserved = 0;
+    h.crc = esp_rom_crc32_le(0, payload, PAYLOAD_BYTES);
+    memcpy(buf, &h, sizeof(h));
+
+    prefs.begin(NAMESPACE, false);
+    // On failure stored keeps the old value, so the next save retries
+    if (prefs.putBytes(BLOB_KEY, buf, sizeof(buf)) == sizeof(buf))
+        stored = s;
+    prefs.end();
+    writeCount++;
+}
+
+void SettingsStore::run(void *arg) {
+    SettingsStore *self = static_cast<SettingsStore *>(arg);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        AppSettings s;
+        while (!self->pending.read(s))
+            vTaskDelay(1);
+        // Values that were changed and changed back cost nothing
+        xSemaphoreTake(self->lock, portMAX_DELAY);
+        if (self->changed(s))
+            self->write(s);
+        xSemaphoreGive(self->lock);
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef SETTINGSSTORE_H
+#define SETTINGSSTORE_H
+
+#include "Seqlock.h"
+#include "SettingsSchema.h"
+#include "Types.h"
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+// Keeps AppSettings in NVS as a single versioned, CRC-checked blob.
+// Editing code only calls requestSave(); the blob is written DEBOUNCE_MS
+// after the last change by a task below the loop task's priority, and only
+// if it differs from what is already stored, so scrolling through a value
+// costs one flash write instead of one per step.
+//
+// The write itself still stalls the UI: NVS disables the flash cache while
+// it erases or programs, which on the single-core C3 stops everything but
+// IRAM code. The debounce and the change check are what keep that rare.
+class SettingsStore {
+  public:
+    // Bump when a field changes meaning. The blob holds one value per
+    // SettingsSchema field, and fields are only ever appended, so an older,
+    // shorter blob loads over the defaults.
+    static const uint16_t VERSION = 2;
+    static const uint32_t DEBOUNCE_MS = 3000;
+    static const uint32_t STACK_BYTES = 3072;
+    // Below the loop task (1). The loop never blocks, but the core yields
+    // it for a few ticks every couple of seconds on single-core chips,
+    // which is when the writer runs; flush() waiting on the lock lends it
+    // the loop's priority through the mutex.
+    static const UBaseType_t PRIORITY = tskIDLE_PRIORITY;
+
+    // Reads the blob, falling back to the pre-blob per-key layout, and
+    // starts the writer task.
+    void load(AppSettings &out);
+    void requestSave();
+    // Scheduler hook: hands the settings to the writer once they settle.
+    void update();
+    // Writes any pending change right away, e.g. before a restart.
+    void flush();
+
+    uint32_t writes() const { return writeCount; }
+
+  private:
+    static const size_t PAYLOAD_BYTES = SETTING_COUNT * sizeof(int32_t);
+    // NVS only hands out whole blobs, so a newer firmware's longer blob is
+    // read whole up to this size and only its known prefix decoded.
+    static const size_t MAX_BLOB_BYTES = 1024;
+
+    struct Header {
+        uint16_t magic;
+        uint16_t version;
+        uint16_t size;
+        uint16_t reserved;
+        uint32_t crc;
+    };
+
+    Seqlock<AppSettings> pending;
+    AppSettings stored;
+    SemaphoreHandle_t lock = nullptr;
+    TaskHandle_t handle = nullptr;
+    bool dirty = false;
+    uint32_t changedMs = 0;
+    uint32_t writeCount = 0;
+
+    static void run(void *arg);
+    bool readBlob(AppSettings &out);
+    void readLegacy(AppSettings &out);
+    bool changed(const AppSettings &s) const;
+    void write(const AppSettings &s);
+};
+
+extern SettingsStore Store;
+
+#endif
@@ -1,25 +1,28 @@
 #include "StateManager.h"
+#include "Globals.h"
 
 StateManager State;
 
-void StateManager::switchMode(Mode *newMode) {
-    if (nextMode != nullptr) {
-        delete nextMode;
-    }
-    nextMode = newMode;
-}
+void StateManager::switchMode(Mode &newMode) { nextMode = &newMode; }
 
 void StateManager::update() {
     if (nextMode != nullptr) {
         if (currentMode != nullptr) {
-            delete currentMode;
+            currentMode->exit();
         }
         currentMode = nextMode;
         nextMode = nullptr;
+        compositor.clearWidgets();
         currentMode->enter();
     }
 
     if (currentMode != nullptr) {
-        currentMode->loop();
+        // Stop delivering once a mode asks to switch; the rest of the queue
+        // goes to the next mode.
+        InputEvent ev;
+        while (nextMode == nullptr && Input.poll(ev))
+            currentMode->onInput(ev);
+        if (nextMode == nullptr)
+            currentMode->loop();
     }
 }
\ No newline at end of file
@@ -3,13 +3,16 @@
 
 #include "Mode.h"
 
+// Modes are long-lived objects (see Modes in AppModes.h); switching only
+// moves a pointer, so transitions never touch the heap and each mode keeps
+// its state between visits.
 class StateManager {
   private:
     Mode *currentMode = nullptr;
     Mode *nextMode = nullptr;
 
   public:
-    void switchMode(Mode *newMode);
+    void switchMode(Mode &newMode);
     void update();
 };
 
@@ -0,0 +1,76 @@
+#ifndef TEXTBUF_H
+#define TEXTBUF_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+// Fixed-capacity, NUL-terminated string that lives on the stack or inside
+// its owner. Used instead of Arduino String on render paths so drawing a
+// frame never touches the heap. Appends that do not fit are truncated.
+template <size_t N> class TextBuf {
+  private:
+    char buf[N + 1];
+    size_t len = 0;
+
+  public:
+    TextBuf() { buf[0] = '\0'; }
+    TextBuf(const char *s) {
+        buf[0] = '\0';
+        append(s);
+    }
+
+    const char *c_str() const { return buf; }
+    size_t length() const { return len; }
+    static size_t capacity() { return N; }
+
+    void clear() {
+        len = 0;
+        buf[0] = '\0';
+    }
+
+    TextBuf &append(const char *s) {
+        while (*s && len < N)
+            buf[len++] = *s++;
+        buf[len] = '\0';
+        return *this;
+    }
+
+    TextBuf &append(char c) {
+        if (len < N) {
+            buf[len++] = c;
+            buf[len] = '\0';
+        }
+        return *this;
+    }
+
+    TextBuf &appendInt(long v) {
+        char tmp[12];
+        snprintf(tmp, sizeof(tmp), "%ld", v);
+        return append(tmp);
+    }
+
+    TextBuf &prepend(char c) {
+        if (len < N) {
+            memmove(buf + 1, buf, len + 1);
+            buf[0] = c;
+            len++;
+        }
+        return *this;
+    }
+
+    // Replaces the contents with printf-style formatted text.
+    TextBuf &format(const char *fmt, ...)
+        __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        len = n < 0 ? 0 : min((size_t)n, N);
+        return *this;
+    }
+
+    bool operator==(const char *s) const { return strcmp(buf, s) == 0; }
+    bool operator!=(const char *s) const { return strcmp(buf, s) != 0; }
+};
+
+#endif
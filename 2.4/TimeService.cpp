@@ -0,0 +1,60 @@
+#include "TimeService.h"
+
+TimeService Time;
+
+bool TimeService::subscribe(TimeListener fn, uint8_t mask) {
+    if (listenerCount >= MAX_LISTENERS)
+        return false;
+    listeners[listenerCount].fn = fn;
+    listeners[listenerCount].mask = mask;
+    listenerCount++;
+    return true;
+}
+
+void TimeService::update() {
+    time_t now = clock();
+    if (now == last)
+        return;
+
+    uint8_t events = TIME_SECOND;
+    // A stalled loop can skip a second or two; anything else means the
+    // clock itself was changed.
+    bool stepped = now < last || now - last > 2;
+    if (stepped)
+        events |= TIME_JUMP;
+
+    if (!stepped && now - last == 1 && cached.tm_sec < 59) {
+        cached.tm_sec++;
+    } else {
+        int oldMin = cached.tm_min;
+        int oldHour = cached.tm_hour;
+        int oldDay = cached.tm_yday;
+        localtime_r(&now, &cached);
+        if (stepped || cached.tm_min != oldMin || cached.tm_hour != oldHour)
+            events |= TIME_MINUTE;
+        if (stepped || cached.tm_yday != oldDay)
+            events |= TIME_DAY;
+    }
+    last = now;
+    formatHms();
+
+    for (int i = 0; i < listenerCount; i++)
+        if (listeners[i].mask & events)
+            listeners[i].fn(events & listeners[i].mask);
+}
+
+void TimeService::formatHms() {
+    if (!valid()) {
+        strcpy(hmsBuf, "--:--:--");
+        return;
+    }
+    hmsBuf[0] = '0' + cached.tm_hour / 10;
+    hmsBuf[1] = '0' + cached.tm_hour % 10;
+    hmsBuf[2] = ':';
+    hmsBuf[3] = '0' + cached.tm_min / 10;
+    hmsBuf[4] = '0' + cached.tm_min % 10;
+    hmsBuf[5] = ':';
+    hmsBuf[6] = '0' + cached.tm_sec / 10;
+    hmsBuf[7] = '0' + cached.tm_sec % 10;
+    hmsBuf[8] = '\0';
+}
@@ -0,0 +1,65 @@
+#ifndef TIMESERVICE_H
+#define TIMESERVICE_H
+
+#include <Arduino.h>
+#include <time.h>
+
+enum TimeEvent : uint8_t {
+    TIME_SECOND = 1 << 0,
+    TIME_MINUTE = 1 << 1,
+    TIME_DAY = 1 << 2,
+    // The clock was set or stepped (NTP, manual, time zone change)
+    TIME_JUMP = 1 << 3,
+};
+
+typedef void (*TimeListener)(uint8_t events);
+
+// Owns the conversion from epoch to local time. update() polls the epoch,
+// which is cheap; the broken-down time and the HH:MM:SS text are rebuilt
+// only when the second changes, and within a minute that is just an
+// increment. A full localtime_r (with its TZ rules) runs once a minute or
+// after a jump, so DST changes, which happen on a minute boundary, are
+// picked up as they occur.
+class TimeService {
+  public:
+    static const int MAX_LISTENERS = 6;
+    // Earlier than this the clock has not been set at all. The fallback
+    // clock counts as set; Network.synced() tells real time apart.
+    static const time_t VALID_AFTER = 1600000000;
+
+    // Calls fn with the events in mask that occurred, after the cached
+    // time has been updated.
+    bool subscribe(TimeListener fn, uint8_t mask);
+    void update();
+    // Forces a full conversion on the next update, e.g. after a TZ change.
+    void invalidate() { last = 0; }
+
+    bool valid() const { return last >= VALID_AFTER; }
+    time_t epoch() const { return last; }
+    const struct tm &local() const { return cached; }
+    // "HH:MM:SS", or "--:--:--" until the clock is set.
+    const char *hms() const { return hmsBuf; }
+
+    // Epoch source; swap for a fake clock off-device.
+    void setClock(time_t (*now)()) { clock = now; }
+
+  private:
+    struct Listener {
+        TimeListener fn;
+        uint8_t mask;
+    };
+
+    time_t (*clock)() = defaultClock;
+    time_t last = 0;
+    struct tm cached = {};
+    char hmsBuf[9] = "--:--:--";
+    Listener listeners[MAX_LISTENERS] = {};
+    int listenerCount = 0;
+
+    static time_t defaultClock() { return time(nullptr); }
+    void formatHms();
+};
+
+extern TimeService Time;
+
+#endif
@@ -0,0 +1,74 @@
+#include "ToneSequencer.h"
+#include "Globals.h"
+
+ToneSequencer Buzzer;
+
+void ToneSequencer::begin() {
+    currentFreq = 2000;
+    ledcSetup(PWM::CH_BUZZ, currentFreq, 8);
+    ledcAttachPin(Pins::BUZZ, PWM::CH_BUZZ);
+    silence();
+}
+
+bool ToneSequencer::play(const Note *notes, int n, TonePriority p) {
+    if (busy() && p < prio)
+        return false;
+    if (!busy() || p > prio) {
+        head = 0;
+        count = 0;
+        noteActive = false;
+        prio = p;
+    }
+    for (int i = 0; i < n && count < QUEUE_LEN; i++)
+        queue[(head + count++) % QUEUE_LEN] = notes[i];
+    update();
+    return true;
+}
+
+bool ToneSequencer::play(uint16_t freq, uint16_t durationMs, TonePriority p) {
+    Note n = {freq, durationMs, 100};
+    return play(&n, 1, p);
+}
+
+void ToneSequencer::stop() {
+    head = 0;
+    count = 0;
+    noteActive = false;
+    silence();
+}
+
+void ToneSequencer::update() {
+    if (count == 0)
+        return;
+    unsigned long now = millis();
+    if (noteActive) {
+        const Note &cur = queue[head];
+        if (cur.durationMs == 0 || now - noteStartMs < cur.durationMs)
+            return;
+        head = (head + 1) % QUEUE_LEN;
+        count--;
+        noteActive = false;
+        if (count == 0) {
+            silence();
+            return;
+        }
+    }
+    noteStartMs = now;
+    noteActive = true;
+    startNote(queue[head]);
+}
+
+void ToneSequencer::startNote(const Note &n) {
+    int vol = settings.speakerVol * n.volume / 100;
+    if (n.freq == 0 || vol == 0) {
+        silence();
+        return;
+    }
+    if (n.freq != currentFreq) {
+        ledcChangeFrequency(PWM::CH_BUZZ, n.freq, 8);
+        currentFreq = n.freq;
+    }
+    ledcWrite(PWM::CH_BUZZ, map(vol, 0, 100, 0, 128));
+}
+
+void ToneSequencer::silence() { ledcWrite(PWM::CH_BUZZ, 0); }
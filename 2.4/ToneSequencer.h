@@ -0,0 +1,48 @@
+#ifndef TONESEQUENCER_H
+#define TONESEQUENCER_H
+
+#include <Arduino.h>
+
+struct Note {
+    uint16_t freq;       // Hz, 0 = rest
+    uint16_t durationMs; // 0 = hold until stopped
+    uint8_t volume;      // percent of the speaker volume setting
+};
+
+// Higher values preempt lower ones.
+enum TonePriority { TONE_UI = 0, TONE_NOTIFY, TONE_ALERT, TONE_ALARM };
+
+// Non-blocking buzzer driver. Notes are queued and advanced by update(),
+// which the scheduler calls every few milliseconds. The LEDC channel is only
+// re-timed when the frequency actually changes.
+class ToneSequencer {
+  public:
+    static const int QUEUE_LEN = 16;
+
+    void begin();
+    // Queues notes behind those of the same priority, replaces anything of
+    // lower priority, and is dropped while something more important plays.
+    bool play(const Note *notes, int count, TonePriority prio = TONE_UI);
+    bool play(uint16_t freq, uint16_t durationMs, TonePriority prio = TONE_UI);
+    void stop();
+    void update();
+
+    bool busy() const { return count > 0; }
+    TonePriority priority() const { return prio; }
+
+  private:
+    Note queue[QUEUE_LEN];
+    uint8_t head = 0;
+    uint8_t count = 0;
+    TonePriority prio = TONE_UI;
+    bool noteActive = false;
+    unsigned long noteStartMs = 0;
+    uint32_t currentFreq = 0;
+
+    void startNote(const Note &n);
+    void silence();
+};
+
+extern ToneSequencer Buzzer;
+
+#endif
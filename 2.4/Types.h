@@ -1,6 +1,8 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include "GraphModel.h"
+#include "HistoryPyramid.h"
 #include <Arduino.h>
 
 enum UIMode {
@@ -16,7 +18,9 @@ enum UIMode {
     MODE_WIFI_RESET_CONFIRM
 };
 
-enum AlertLevel { ALERT_NONE = 0, ALERT_CO2, ALERT_ALARM };
+// In rising order of priority; the highest active one drives the LED and
+// buzzer.
+enum AlertLevel { ALERT_NONE = 0, ALERT_NOTICE, ALERT_WARNING, ALERT_ALARM };
 enum PomodoroState {
     POMO_SET_WORK = 0,
     POMO_SET_SHORT,
@@ -29,17 +33,49 @@ enum PomodoroState {
 };
 enum PomoPhase { PHASE_WORK, PHASE_SHORT, PHASE_LONG };
 
+constexpr int ALARM_COUNT = 4;
+
+// days has bit 0 = Sunday .. bit 6 = Saturday, like tm_wday. An alarm
+// with no days rings once and then switches itself off.
+struct AlarmSpec {
+    uint8_t hour;
+    uint8_t minute;
+    bool enabled;
+    uint8_t days;
+};
+
+constexpr int ALERT_RULE_COUNT = 4;
+
+enum AlertRuleKind : uint8_t { RULE_ABOVE = 0, RULE_BELOW, RULE_RISE };
+
+// One environmental alert. Values are in history units (temperature in
+// 0.1 C, humidity %, TVOC ppb, eCO2 ppm). A rise rule compares the
+// increase over the last windowMin minutes. The alert is raised once the
+// condition has held for holdS seconds and clears only when the value is
+// back by more than hysteresis.
+struct AlertRuleSpec {
+    bool enabled;
+    uint8_t channel; // HistChannel
+    uint8_t kind;    // AlertRuleKind
+    uint8_t level;   // AlertLevel, NOTICE or WARNING
+    int threshold;
+    int hysteresis;
+    int holdS;
+    int windowMin;
+};
+
+// Defaults, bounds and labels live in SettingsSchema.h.
 struct AppSettings {
-    int ledBrightness = 100;
-    int speakerVol = 100;
-    int graphDuration = 180;
-    uint8_t alarmHour = 6;
-    uint8_t alarmMinute = 0;
-    bool alarmEnabled = false;
-    int pomoWorkMin = 25;
-    int pomoShortMin = 5;
-    int pomoLongMin = 15;
-    int pomoCycles = 4;
+    int ledBrightness;
+    int speakerVol;
+    int graphDuration;
+    bool graphAutoScale;
+    AlarmSpec alarms[ALARM_COUNT];
+    int pomoWorkMin;
+    int pomoShortMin;
+    int pomoLongMin;
+    int pomoCycles;
+    AlertRuleSpec alertRules[ALERT_RULE_COUNT];
 };
 
 struct EnvData {
@@ -48,75 +84,19 @@ struct EnvData {
     uint16_t tvoc = 0;
     uint16_t eco2 = 0;
     unsigned long lastRead = 0;
-    static const int HIST_LEN = 320;
-    uint16_t hTemp[HIST_LEN];
-    uint16_t hHum[HIST_LEN];
-    uint16_t hTVOC[HIST_LEN];
-    uint16_t hCO2[HIST_LEN];
-    int head = 0;
+    HistoryPyramid history;
+    GraphModel graph;
     unsigned long lastHistAdd = 0;
 };
 
-struct PomodoroContext {
-    PomodoroState state = POMO_SET_WORK;
-    PomoPhase phase = PHASE_WORK;
-    int currentCycle = 1;
-    unsigned long startMillis = 0;
-    unsigned long pausedMillis = 0;
-    unsigned long durationMs = 0;
-    int prevVal = -1;
-    int prevBarWidth = -1;
-    String prevLabel = "";
-};
-
 struct UIContext {
     UIMode currentMode = MODE_CLOCK;
-    int menuIndex = 0;
-    static const int MENU_ITEMS = 5;
-    const char *menuLabels[MENU_ITEMS] = {"Monitor", "Pomodoro", "Alarm", "DVD",
-                                          "Settings"};
-    int settingsIndex = 0;
-    static const int SETTINGS_ITEMS = 4;
-    const char *settingsLabels[SETTINGS_ITEMS] = {
-        "LED Brightness", "Speaker Volume", "Graph Range", "WiFi"};
-    int editId = -1;
-    int prevVal = -1;
     bool alarmRinging = false;
-    int alarmSelectedField = 0;
-    int lastAlarmDayTriggered = -1;
-    int settingsSelectedRow = 0;
-    static const int SETTINGS_ROWS = 4;
-    bool settingsEditMode = false;
-    bool settingsInited = false;
-    int prevLedBarW = -1;
-    int prevSpkBarW = -1;
-    int wifiMenuIndex = 0;
-    bool wifiMenuRedraw = true;
-    int wifiResetConfirmIndex = 1;
-    bool wifiResetRedraw = true;
-    bool wifiSetupInited = false;
-    int prevSecond = -1;
-    String prevTimeStr = "";
-    bool dvdInited = false;
-    int dvdX, dvdY, dvdVX = 2, dvdVY = 1;
-    int dvdW = 80, dvdH = 30;
-    unsigned long lastDvdMs = 0;
-    int dvdColorIndex = 0;
     AlertLevel currentAlert = ALERT_NONE;
     unsigned long lastLedToggleMs = 0;
     bool ledState = false;
-    unsigned long lastCo2BlinkMs = 0;
-    bool co2BlinkOn = false;
-};
-
-struct InputState {
-    int lastEncA = HIGH;
-    int lastEncB = HIGH;
-    bool lastEncBtn = HIGH;
-    bool lastKey0 = HIGH;
-    unsigned long lastEncBtnMs = 0;
-    unsigned long lastKey0Ms = 0;
-    bool key0Consumed = false;
+    unsigned long ledHoldUntilMs = 0;
+    unsigned long lastAlertToneMs = 0;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,174 @@
+// Runs the sketch on the host: setup(), then loop() on the virtual clock,
+// with scripted input, network and sensors. At the end it prints the
+// display traffic and storage writes, and can dump the screen as a PPM.
+//
+//   simulator [--seconds N] [--step-us N] [--ppm FILE] [--fs DIR]
+//             [--input SCRIPT] [--sntp EPOCH] [--no-wifi] [--drift PPM]
+//             [--quiet]
+//
+// SCRIPT is a comma-separated list of MS:EVENT, where EVENT is rotN
+// (N detents, negative for counter-clockwise), press, release, click,
+// back or hold (a 1.5 s press). --sntp answers SNTP with EPOCH plus the
+// virtual time once the network is up and at every sync interval.
+
+#include "../../2.4.ino"
+#include "HostSim.h"
+#include <string>
+#include <vector>
+
+namespace {
+struct ScriptedEvent {
+    uint32_t ms;
+    InputEventType type;
+    InputButton button;
+    int16_t steps;
+};
+
+bool parseScript(const char *script, std::vector<ScriptedEvent> &out) {
+    std::string s(script);
+    size_t pos = 0;
+    while (pos < s.size()) {
+        size_t end = s.find(',', pos);
+        if (end == std::string::npos)
+            end = s.size();
+        std::string item = s.substr(pos, end - pos);
+        pos = end + 1;
+        size_t colon = item.find(':');
+        if (colon == std::string::npos)
+            return false;
+        uint32_t ms = strtoul(item.c_str(), nullptr, 10);
+        std::string ev = item.substr(colon + 1);
+        if (ev.compare(0, 3, "rot") == 0) {
+            int16_t n = (int16_t)atoi(ev.c_str() + 3);
+            out.push_back({ms, EV_ROTATE, BTN_NONE, n});
+        } else if (ev == "press") {
+            out.push_back({ms, EV_PRESS, BTN_ENC, 0});
+        } else if (ev == "release") {
+            out.push_back({ms, EV_RELEASE, BTN_ENC, 0});
+        } else if (ev == "click") {
+            out.push_back({ms, EV_PRESS, BTN_ENC, 0});
+            out.push_back({ms + 80, EV_RELEASE, BTN_ENC, 0});
+        } else if (ev == "hold") {
+            out.push_back({ms, EV_PRESS, BTN_ENC, 0});
+            out.push_back({ms + 1500, EV_RELEASE, BTN_ENC, 0});
+        } else if (ev == "back") {
+            out.push_back({ms, EV_PRESS, BTN_BACK, 0});
+            out.push_back({ms + 80, EV_RELEASE, BTN_BACK, 0});
+        } else {
+            return false;
+        }
+    }
+    std::stable_sort(out.begin(), out.end(),
+                     [](const ScriptedEvent &a, const ScriptedEvent &b) {
+                         return a.ms < b.ms;
+                     });
+    return true;
+}
+
+int usage() {
+    fprintf(stderr,
+            "usage: simulator [--seconds N] [--step-us N] [--ppm FILE] "
+            "[--fs DIR]\n"
+            "                 [--input SCRIPT] [--sntp EPOCH] [--no-wifi] "
+            "[--drift PPM] [--quiet]\n");
+    return 2;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    double seconds = 10;
+    uint32_t stepUs = 1000;
+    const char *ppm = nullptr;
+    const char *fsDir = nullptr;
+    long long sntpEpoch = 0;
+    bool wifi = true;
+    bool quiet = false;
+    double drift = 0;
+    std::vector<ScriptedEvent> script;
+
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (a == "--seconds" && hasValue)
+            seconds = atof(argv[++i]);
+        else if (a == "--step-us" && hasValue)
+            stepUs = strtoul(argv[++i], nullptr, 10);
+        else if (a == "--ppm" && hasValue)
+            ppm = argv[++i];
+        else if (a == "--fs" && hasValue)
+            fsDir = argv[++i];
+        else if (a == "--input" && hasValue) {
+            if (!parseScript(argv[++i], script))
+                return usage();
+        } else if (a == "--sntp" && hasValue)
+            sntpEpoch = atoll(argv[++i]);
+        else if (a == "--drift" && hasValue)
+            drift = atof(argv[++i]);
+        else if (a == "--no-wifi")
+            wifi = false;
+        else if (a == "--quiet")
+            quiet = true;
+        else
+            return usage();
+    }
+    if (stepUs == 0)
+        return usage();
+
+    Host::setSerialEcho(!quiet);
+    if (fsDir)
+        Host::setFsRoot(fsDir);
+    Host::setWifiAvailable(wifi);
+    Host::setWallDriftPpm(drift);
+
+    setup();
+
+    const uint64_t endUs = (uint64_t)(seconds * 1e6);
+    size_t nextEvent = 0;
+    bool synced = false;
+    uint32_t lastSyncMs = 0;
+    while (Host::nowUs() < endUs && !Host::restartRequested()) {
+        uint32_t now = millis();
+        for (; nextEvent < script.size() && script[nextEvent].ms <= now;
+             nextEvent++) {
+            const ScriptedEvent &e = script[nextEvent];
+            Input.inject({now, e.type, e.button, e.steps, e.steps});
+        }
+        if (sntpEpoch > 0 && Network.online() && Host::sntpStarted() &&
+            (!synced || now - lastSyncMs >= Host::sntpIntervalMs())) {
+            uint64_t us = Host::nowUs();
+            Host::sntpDeliver((time_t)(sntpEpoch + us / 1000000),
+                              (uint32_t)(us % 1000000));
+            synced = true;
+            lastSyncMs = now;
+        }
+        loop();
+        Host::advanceUs(stepUs);
+    }
+
+    fflush(stdout);
+    const Adafruit_SPITFT::Stats &s = tft.stats();
+    Host::NvsStats nvs = Host::nvsStats();
+    fprintf(stderr,
+            "virtual time     %.3f s%s\n"
+            "spi transactions %u\n"
+            "spi windows      %u\n"
+            "spi pixels       %llu\n"
+            "spi bytes        %llu\n"
+            "compositor bytes %u\n"
+            "drawlist windows %u\n"
+            "settings writes  %u\n"
+            "nvs writes       %u (%u bytes)\n"
+            "flash written    %llu bytes\n",
+            Host::nowUs() / 1e6,
+            Host::restartRequested() ? " (restart requested)" : "",
+            s.transactions, s.windows, (unsigned long long)s.pixels,
+            (unsigned long long)s.bytes, compositor.bytesSent(),
+            drawList.windowsSent(), Store.writes(), nvs.writes, nvs.bytes,
+            (unsigned long long)Host::fsBytesWritten());
+
+    if (ppm && !tft.writePpm(ppm)) {
+        fprintf(stderr, "could not write %s\n", ppm);
+        return 1;
+    }
+    return 0;
+}
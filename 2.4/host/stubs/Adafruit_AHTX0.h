@@ -0,0 +1,18 @@
+#ifndef ADAFRUIT_AHTX0_H
+#define ADAFRUIT_AHTX0_H
+
+#include "Arduino.h"
+
+struct sensors_event_t {
+    float temperature;
+    float relative_humidity;
+};
+
+// Host stand-in: reads Host::sensors().
+class Adafruit_AHTX0 {
+  public:
+    bool begin();
+    bool getEvent(sensors_event_t *humidity, sensors_event_t *temp);
+};
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef ADAFRUIT_GFX_H
+#define ADAFRUIT_GFX_H
+
+#include "Arduino.h"
+#include <vector>
+
+// Host stand-in for the parts of Adafruit GFX the firmware uses. The
+// primitives follow the library's own algorithms and go through the same
+// write*() hooks, so a display subclass sees the calls (and address
+// windows) the real library would make. Text uses the classic 5x7 font in
+// 6x8 cells.
+class Adafruit_GFX : public Print {
+  public:
+    Adafruit_GFX(int16_t w, int16_t h);
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    virtual void startWrite() {}
+    virtual void endWrite() {}
+    virtual void writePixel(int16_t x, int16_t y, uint16_t color) {
+        drawPixel(x, y, color);
+    }
+    virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                               uint16_t color) {
+        fillRect(x, y, w, h, color);
+    }
+    virtual void writeFastVLine(int16_t x, int16_t y, int16_t h,
+                                uint16_t color) {
+        drawFastVLine(x, y, h, color);
+    }
+    virtual void writeFastHLine(int16_t x, int16_t y, int16_t w,
+                                uint16_t color) {
+        drawFastHLine(x, y, w, color);
+    }
+
+    virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                           uint16_t color);
+
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                          uint16_t color);
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h,
+                               uint16_t color);
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w,
+                               uint16_t color);
+    virtual void fillScreen(uint16_t color);
+    virtual void setRotation(uint8_t r);
+
+    virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                          uint16_t color);
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r,
+                       uint16_t color);
+    void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r,
+                       uint16_t color);
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                  uint16_t bg, uint8_t size);
+
+    void setCursor(int16_t x, int16_t y) {
+        cursorX = x;
+        cursorY = y;
+    }
+    void setTextSize(uint8_t s) { textSize = s > 0 ? s : 1; }
+    // Background equal to the foreground means transparent
+    void setTextColor(uint16_t c) { textColor = textBg = c; }
+    void setTextColor(uint16_t c, uint16_t bg) {
+        textColor = c;
+        textBg = bg;
+    }
+    void setTextWrap(bool w) { wrap = w; }
+    int16_t getCursorX() const { return cursorX; }
+    int16_t getCursorY() const { return cursorY; }
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+    uint8_t getRotation() const { return rotation; }
+
+  protected:
+    int16_t WIDTH, HEIGHT; // unrotated size
+    int16_t _width, _height;
+    uint8_t rotation = 0;
+    int16_t cursorX = 0, cursorY = 0;
+    uint16_t textColor = 0xFFFF, textBg = 0xFFFF;
+    uint8_t textSize = 1;
+    bool wrap = true;
+
+    void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners,
+                          uint16_t color);
+    void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners,
+                          int16_t delta, uint16_t color);
+};
+
+// 1 bit per pixel, rows of (w + 7) / 8 bytes, most significant bit first.
+class GFXcanvas1 : public Adafruit_GFX {
+  public:
+    GFXcanvas1(uint16_t w, uint16_t h);
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    bool getPixel(int16_t x, int16_t y) const;
+    uint8_t *getBuffer() { return buffer.data(); }
+
+  private:
+    std::vector<uint8_t> buffer;
+};
+
+// RGB565, row-major.
+class GFXcanvas16 : public Adafruit_GFX {
+  public:
+    GFXcanvas16(uint16_t w, uint16_t h);
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    uint16_t getPixel(int16_t x, int16_t y) const;
+    uint16_t *getBuffer() { return buffer.data(); }
+
+  private:
+    std::vector<uint16_t> buffer;
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include "Adafruit_SPITFT.h"
+
+Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h)
+    : Adafruit_GFX(w, h), fb((size_t)w * h) {}
+
+void Adafruit_SPITFT::resize(uint16_t w, uint16_t h) {
+    WIDTH = w;
+    HEIGHT = h;
+    fb.assign((size_t)w * h, 0);
+    setRotation(rotation);
+}
+
+void Adafruit_SPITFT::setRotation(uint8_t r) {
+    Adafruit_GFX::setRotation(r);
+    // MADCTL and its argument
+    counters.bytes += 2;
+}
+
+void Adafruit_SPITFT::invertDisplay(bool invert) {
+    inverted = invert;
+    counters.bytes += 1;
+}
+
+void Adafruit_SPITFT::startWrite() {
+    if (depth++ == 0)
+        counters.transactions++;
+}
+
+void Adafruit_SPITFT::endWrite() {
+    if (depth > 0)
+        depth--;
+}
+
+void Adafruit_SPITFT::setAddrWindow(uint16_t x, uint16_t y, uint16_t w,
+                                    uint16_t h) {
+    winX = x;
+    winY = y;
+    winW = w;
+    winH = h;
+    winPos = 0;
+    counters.windows++;
+    counters.bytes += WINDOW_BYTES;
+}
+
+// Pixels fill the window row by row and wrap back to its start, as in
+// the controller's RAM.
+void Adafruit_SPITFT::put(uint16_t color) {
+    if (winW <= 0 || winH <= 0)
+        return;
+    int16_t x = winX + winPos % winW;
+    int16_t y = winY + (winPos / winW) % winH;
+    if (++winPos == (uint32_t)winW * winH)
+        winPos = 0;
+    if (x < _width && y < _height)
+        fb[(size_t)y * _width + x] = color;
+}
+
+void Adafruit_SPITFT::writePixels(uint16_t *colors, uint32_t len,
+                                  bool /*block*/, bool bigEndian) {
+    for (uint32_t i = 0; i < len; i++)
+        put(bigEndian ? (uint16_t)(colors[i] << 8 | colors[i] >> 8)
+                      : colors[i]);
+    counters.pixels += len;
+    counters.bytes += 2 * (uint64_t)len;
+}
+
+void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++)
+        put(color);
+    counters.pixels += len;
+    counters.bytes += 2 * (uint64_t)len;
+}
+
+void Adafruit_SPITFT::writePixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+        return;
+    setAddrWindow(x, y, 1, 1);
+    writeColor(color, 1);
+}
+
+void Adafruit_SPITFT::writeFillRect(int16_t x, int16_t y, int16_t w,
+                                    int16_t h, uint16_t color) {
+    if (w < 0) {
+        x += w + 1;
+        w = -w;
+    }
+    if (h < 0) {
+        y += h + 1;
+        h = -h;
+    }
+    int16_t x2 = std::min<int16_t>(x + w, _width);
+    int16_t y2 = std::min<int16_t>(y + h, _height);
+    x = std::max<int16_t>(x, 0);
+    y = std::max<int16_t>(y, 0);
+    if (x2 <= x || y2 <= y)
+        return;
+    setAddrWindow(x, y, x2 - x, y2 - y);
+    writeColor(color, (uint32_t)(x2 - x) * (y2 - y));
+}
+
+void Adafruit_SPITFT::writeFastVLine(int16_t x, int16_t y, int16_t h,
+                                     uint16_t color) {
+    writeFillRect(x, y, 1, h, color);
+}
+
+void Adafruit_SPITFT::writeFastHLine(int16_t x, int16_t y, int16_t w,
+                                     uint16_t color) {
+    writeFillRect(x, y, w, 1, color);
+}
+
+void Adafruit_SPITFT::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    startWrite();
+    writePixel(x, y, color);
+    endWrite();
+}
+
+void Adafruit_SPITFT::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                               uint16_t color) {
+    startWrite();
+    writeFillRect(x, y, w, h, color);
+    endWrite();
+}
+
+void Adafruit_SPITFT::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                    uint16_t color) {
+    fillRect(x, y, 1, h, color);
+}
+
+void Adafruit_SPITFT::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                    uint16_t color) {
+    fillRect(x, y, w, 1, color);
+}
+
+void Adafruit_SPITFT::fillScreen(uint16_t color) {
+    fillRect(0, 0, _width, _height, color);
+}
+
+uint16_t Adafruit_SPITFT::pixel(int16_t x, int16_t y) const {
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+        return 0;
+    return fb[(size_t)y * _width + x];
+}
+
+bool Adafruit_SPITFT::writePpm(const char *path) const {
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+    fprintf(f, "P6\n%d %d\n255\n", _width, _height);
+    for (uint16_t c : fb) {
+        if (inverted)
+            c = ~c;
+        uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+        uint8_t rgb[3] = {(uint8_t)(r << 3 | r >> 2),
+                          (uint8_t)(g << 2 | g >> 4),
+                          (uint8_t)(b << 3 | b >> 2)};
+        fwrite(rgb, 1, 3, f);
+    }
+    return fclose(f) == 0;
+}
@@ -0,0 +1,71 @@
+#ifndef ADAFRUIT_SPITFT_H
+#define ADAFRUIT_SPITFT_H
+
+#include "Adafruit_GFX.h"
+
+// Host stand-in for an SPI panel. Instead of a bus it keeps a framebuffer
+// in rotated coordinates and counts the traffic the real driver would
+// send: each address window costs 11 bytes (CASET, RASET and RAMWR with
+// their arguments), each pixel two.
+class Adafruit_SPITFT : public Adafruit_GFX {
+  public:
+    struct Stats {
+        uint32_t transactions = 0; // outermost startWrite()/endWrite() pairs
+        uint32_t windows = 0;
+        uint64_t pixels = 0;
+        uint64_t bytes = 0;
+    };
+    static const uint32_t WINDOW_BYTES = 11;
+
+    Adafruit_SPITFT(uint16_t w, uint16_t h);
+
+    void startWrite() override;
+    void endWrite() override;
+    virtual void setAddrWindow(uint16_t x, uint16_t y, uint16_t w,
+                               uint16_t h);
+    void writePixels(uint16_t *colors, uint32_t len, bool block = true,
+                     bool bigEndian = false);
+    void writeColor(uint16_t color, uint32_t len);
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void writePixel(int16_t x, int16_t y, uint16_t color) override;
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                       uint16_t color) override;
+    void writeFastVLine(int16_t x, int16_t y, int16_t h,
+                        uint16_t color) override;
+    void writeFastHLine(int16_t x, int16_t y, int16_t w,
+                        uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                  uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h,
+                       uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w,
+                       uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    void setRotation(uint8_t r) override;
+    void invertDisplay(bool invert);
+
+    // --- Host only ---
+    const Stats &stats() const { return counters; }
+    void resetStats() { counters = Stats(); }
+    uint16_t pixel(int16_t x, int16_t y) const;
+    const std::vector<uint16_t> &framebuffer() const { return fb; }
+    // Binary PPM (P6), RGB565 widened to 8 bits per channel
+    bool writePpm(const char *path) const;
+
+  protected:
+    // Sets the native size and clears the panel
+    void resize(uint16_t w, uint16_t h);
+
+  private:
+    std::vector<uint16_t> fb;
+    Stats counters;
+    int depth = 0;
+    int16_t winX = 0, winY = 0, winW = 0, winH = 0;
+    uint32_t winPos = 0;
+    bool inverted = false;
+
+    void put(uint16_t color);
+};
+
+#endif
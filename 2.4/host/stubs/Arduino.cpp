@@ -0,0 +1,143 @@
+#include "Arduino.h"
+#include "HostSim.h"
+#include <map>
+#include <mutex>
+#include <vector>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+namespace {
+std::map<int, int> pinLevels;
+std::map<int, void (*)()> handlers;
+std::mutex ledcLock;
+std::vector<Host::LedcEvent> ledc;
+std::string serialText;
+bool serialEcho = true;
+bool restarting = false;
+
+void logLedc(Host::LedcOp op, uint8_t channel, uint32_t value) {
+    std::lock_guard<std::mutex> lk(ledcLock);
+    ledc.push_back({(uint32_t)millis(), op, channel, value});
+}
+} // namespace
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+unsigned long millis() { return (unsigned long)(Host::nowUs() / 1000); }
+unsigned long micros() { return (unsigned long)Host::nowUs(); }
+// Time passes on the loop task; a stand-in task waits for it instead.
+void delay(unsigned long ms) { vTaskDelay(ms); }
+
+void pinMode(int /*pin*/, int /*mode*/) {}
+int digitalRead(int pin) {
+    auto it = pinLevels.find(pin);
+    return it == pinLevels.end() ? HIGH : it->second;
+}
+void digitalWrite(int pin, int level) { pinLevels[pin] = level; }
+int digitalPinToInterrupt(int pin) { return pin; }
+void attachInterrupt(int irq, void (*fn)(), int /*mode*/) {
+    handlers[irq] = fn;
+}
+void detachInterrupt(int irq) { handlers.erase(irq); }
+// The stand-in ISRs run on the thread that sets the pin, so there is
+// nothing to mask.
+void noInterrupts() {}
+void interrupts() {}
+
+double ledcSetup(uint8_t channel, double freq, uint8_t /*bits*/) {
+    logLedc(Host::LEDC_SETUP, channel, (uint32_t)freq);
+    return freq;
+}
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    logLedc(Host::LEDC_ATTACH, channel, pin);
+}
+void ledcDetachPin(uint8_t pin) { logLedc(Host::LEDC_DETACH, 0, pin); }
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    logLedc(Host::LEDC_DUTY, channel, duty);
+}
+double ledcChangeFrequency(uint8_t channel, double freq, uint8_t /*bits*/) {
+    logLedc(Host::LEDC_FREQ, channel, (uint32_t)freq);
+    return freq;
+}
+double ledcWriteTone(uint8_t channel, double freq) {
+    logLedc(Host::LEDC_FREQ, channel, (uint32_t)freq);
+    return freq;
+}
+
+size_t Print::write(const uint8_t *buf, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        write(buf[i]);
+    return n;
+}
+
+size_t Print::print(long v, int base) {
+    char buf[40];
+    if (base == 16)
+        snprintf(buf, sizeof(buf), "%lx", v);
+    else
+        snprintf(buf, sizeof(buf), "%ld", v);
+    return write(buf);
+}
+
+size_t Print::print(unsigned long v, int base) {
+    char buf[40];
+    if (base == 16)
+        snprintf(buf, sizeof(buf), "%lx", v);
+    else
+        snprintf(buf, sizeof(buf), "%lu", v);
+    return write(buf);
+}
+
+size_t Print::print(double v, int digits) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return write(buf);
+}
+
+size_t Print::printf(const char *fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n < 0)
+        return 0;
+    return write((const uint8_t *)buf, std::min((size_t)n, sizeof(buf) - 1));
+}
+
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t n) {
+    serialText.append((const char *)buf, n);
+    if (serialEcho)
+        fwrite(buf, 1, n, stdout);
+    return n;
+}
+
+void EspClass::restart() { restarting = true; }
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)(Host::nowUs() * getCpuFreqMHz());
+}
+
+namespace Host {
+void setPin(int pin, int level) {
+    int old = digitalRead(pin);
+    pinLevels[pin] = level;
+    auto it = handlers.find(digitalPinToInterrupt(pin));
+    if (old != level && it != handlers.end())
+        it->second();
+}
+
+const std::vector<LedcEvent> &ledcLog() { return ledc; }
+void clearLedcLog() {
+    std::lock_guard<std::mutex> lk(ledcLock);
+    ledc.clear();
+}
+
+std::string &serialOutput() { return serialText; }
+void setSerialEcho(bool echo) { serialEcho = echo; }
+bool restartRequested() { return restarting; }
+} // namespace Host
@@ -0,0 +1,151 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Host stand-in for the subset of the arduino-esp32 core the firmware uses.
+// Time comes from the virtual clock in HostSim.h.
+
+#include <algorithm>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/time.h>
+#include <time.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define IRAM_ATTR
+#define PROGMEM
+#define F(x) x
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high)                                             \
+    ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+void pinMode(int pin, int mode);
+int digitalRead(int pin);
+void digitalWrite(int pin, int level);
+int digitalPinToInterrupt(int pin);
+void attachInterrupt(int irq, void (*fn)(), int mode);
+void detachInterrupt(int irq);
+void noInterrupts();
+void interrupts();
+
+double ledcSetup(uint8_t channel, double freq, uint8_t bits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcDetachPin(uint8_t pin);
+void ledcWrite(uint8_t channel, uint32_t duty);
+double ledcChangeFrequency(uint8_t channel, double freq, uint8_t bits);
+double ledcWriteTone(uint8_t channel, double freq);
+
+bool getLocalTime(struct tm *info, uint32_t ms = 5000);
+void configTime(long gmtOffset, int dstOffset, const char *server1,
+                const char *server2 = nullptr, const char *server3 = nullptr);
+
+class String {
+  public:
+    String(const char *s = "") : s(s ? s : "") {}
+    String(const std::string &s) : s(s) {}
+    unsigned length() const { return s.size(); }
+    const char *c_str() const { return s.c_str(); }
+    bool operator==(const String &o) const { return s == o.s; }
+    bool operator!=(const String &o) const { return s != o.s; }
+    String &operator+=(const String &o) {
+        s += o.s;
+        return *this;
+    }
+    friend String operator+(const String &a, const String &b) {
+        return String(a.s + b.s);
+    }
+
+  private:
+    std::string s;
+};
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t n);
+    size_t write(const char *s) {
+        return write((const uint8_t *)s, strlen(s));
+    }
+
+    size_t print(const char *s) { return write(s); }
+    size_t print(const String &s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v, int base = 10) { return print((long)v, base); }
+    size_t print(unsigned v, int base = 10) {
+        return print((unsigned long)v, base);
+    }
+    size_t print(long v, int base = 10);
+    size_t print(unsigned long v, int base = 10);
+    size_t print(double v, int digits = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(const T &v) {
+        size_t n = print(v);
+        return n + println();
+    }
+    size_t println(double v, int digits) {
+        size_t n = print(v, digits);
+        return n + println();
+    }
+
+    size_t printf(const char *fmt, ...)
+        __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+};
+
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long /*baud*/) {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t n) override;
+    using Print::write;
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+  public:
+    // Sets Host::restartRequested(); the caller decides what happens next.
+    void restart();
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return 160; }
+    uint32_t getFreeHeap() { return 200000; }
+    uint32_t getMinFreeHeap() { return 200000; }
+    uint32_t getMaxAllocHeap() { return 100000; }
+};
+
+extern EspClass ESP;
+
+#include "freertos/FreeRTOS.h"
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef FS_H
+#define FS_H
+
+#include "Arduino.h"
+#include <memory>
+
+namespace fs {
+
+struct FileImpl;
+
+// Host stand-in for an Arduino file handle. Copies share the open file,
+// as on the device; it closes when the last copy goes.
+class File : public Stream {
+  public:
+    File() {}
+    explicit File(std::shared_ptr<FileImpl> impl) : impl(impl) {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t n) override;
+    using Print::write;
+    int read() override;
+    size_t read(uint8_t *buf, size_t n);
+    bool seek(uint32_t pos);
+    size_t position() const;
+    size_t size() const;
+    void close();
+    // File name without the directory, as in arduino-esp32 2.x
+    const char *name() const;
+    bool isDirectory() const;
+    File openNextFile();
+    operator bool() const;
+
+  private:
+    std::shared_ptr<FileImpl> impl;
+};
+
+} // namespace fs
+
+using fs::File;
+
+#endif
@@ -0,0 +1,212 @@
+#include "HostSim.h"
+#include "freertos/FreeRTOS.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct HostTask {
+    const char *name;
+    uint32_t notified = 0;
+};
+
+struct HostSemaphore {
+    bool taken = false;
+};
+
+namespace {
+struct Waiter {
+    std::function<bool()> ready;
+    uint64_t deadlineUs; // when a timeout makes ready() true, if it can
+    bool task;
+    bool woken;
+};
+
+const uint64_t NO_DEADLINE = UINT64_MAX;
+
+// Leaked on purpose: detached task threads may still be blocked on them
+// while the process exits.
+std::mutex &lock = *new std::mutex;
+std::condition_variable &changed = *new std::condition_variable;
+std::vector<Waiter *> &waiters = *new std::vector<Waiter *>;
+
+std::atomic<uint64_t> clockUs{0};
+// Task threads that are not blocked; guarded by lock.
+int running = 0;
+thread_local HostTask *current = nullptr;
+
+uint32_t nowTicks() { return (uint32_t)(clockUs.load() / 1000); }
+
+// Virtual time at which a wait of ticks from now ends
+uint64_t deadlineAfter(int64_t ticks) {
+    return ticks < 0 ? clockUs.load()
+                     : (clockUs.load() / 1000 + (uint64_t)ticks) * 1000;
+}
+
+// Called with lock held after anything a waiter may be waiting for
+// changed. A task counts as running again from the moment it is woken, so
+// advanceUs() never sees a gap between one task blocking and another
+// being released.
+void wakeReady() {
+    for (Waiter *w : waiters) {
+        if (!w->woken && w->ready()) {
+            w->woken = true;
+            if (w->task)
+                running++;
+        }
+    }
+    changed.notify_all();
+}
+
+// Blocks the calling thread until ready() holds. Several waiters may be
+// woken for one semaphore; whoever gets the lock first takes it and the
+// others block again.
+void block(std::unique_lock<std::mutex> &lk, std::function<bool()> ready,
+           uint64_t deadlineUs = NO_DEADLINE) {
+    while (!ready()) {
+        Waiter w = {ready, deadlineUs, current != nullptr, false};
+        waiters.push_back(&w);
+        if (w.task) {
+            running--;
+            changed.notify_all();
+        }
+        changed.wait(lk, [&] { return w.woken; });
+        waiters.erase(std::find(waiters.begin(), waiters.end(), &w));
+    }
+}
+
+// The loop task has nothing to wait for but time, which only it moves.
+bool onLoopTask() { return current == nullptr; }
+} // namespace
+
+namespace Host {
+uint64_t nowUs() { return clockUs.load(); }
+
+// Stops at every task deadline on the way, so a task that wakes reads the
+// time it asked for rather than the end of the step.
+void advanceUs(uint64_t us) {
+    std::unique_lock<std::mutex> lk(lock);
+    uint64_t target = clockUs + us;
+    for (;;) {
+        wakeReady();
+        changed.wait(lk, [] { return running == 0; });
+        if (clockUs >= target)
+            return;
+        uint64_t next = target;
+        for (Waiter *w : waiters)
+            if (!w->woken && w->deadlineUs > clockUs && w->deadlineUs < next)
+                next = w->deadlineUs;
+        clockUs = next;
+    }
+}
+
+void advanceMs(uint32_t ms) { advanceUs((uint64_t)ms * 1000); }
+} // namespace Host
+
+BaseType_t xTaskCreatePinnedToCore(void (*fn)(void *), const char *name,
+                                   uint32_t /*stackBytes*/, void *arg,
+                                   UBaseType_t /*priority*/,
+                                   TaskHandle_t *handle, BaseType_t /*core*/) {
+    HostTask *t = new HostTask;
+    t->name = name;
+    {
+        std::lock_guard<std::mutex> lk(lock);
+        running++;
+    }
+    std::thread([=] {
+        current = t;
+        fn(arg);
+        std::lock_guard<std::mutex> lk(lock);
+        running--;
+        changed.notify_all();
+    }).detach();
+    if (handle)
+        *handle = t;
+    // Let the new task run until it first blocks, so what it does at
+    // start-up happens at a repeatable virtual time.
+    if (onLoopTask()) {
+        std::unique_lock<std::mutex> lk(lock);
+        changed.wait(lk, [] { return running == 0; });
+    }
+    return pdPASS;
+}
+
+TickType_t xTaskGetTickCount() { return nowTicks(); }
+
+void vTaskDelay(TickType_t ticks) {
+    if (onLoopTask()) {
+        Host::advanceMs(ticks);
+        return;
+    }
+    std::unique_lock<std::mutex> lk(lock);
+    uint32_t until = nowTicks() + ticks;
+    block(lk, [=] { return (int32_t)(nowTicks() - until) >= 0; },
+          deadlineAfter(ticks));
+}
+
+void vTaskDelayUntil(TickType_t *previousWake, TickType_t period) {
+    *previousWake += period;
+    uint32_t until = *previousWake;
+    if (onLoopTask()) {
+        int32_t wait = (int32_t)(until - nowTicks());
+        if (wait > 0)
+            Host::advanceMs(wait);
+        return;
+    }
+    std::unique_lock<std::mutex> lk(lock);
+    block(lk, [=] { return (int32_t)(nowTicks() - until) >= 0; },
+          deadlineAfter((int32_t)(until - nowTicks())));
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t timeout) {
+    HostTask *t = current;
+    if (t == nullptr)
+        return 0;
+    std::unique_lock<std::mutex> lk(lock);
+    uint32_t until = nowTicks() + timeout;
+    block(lk,
+          [=] {
+              return t->notified > 0 || (timeout != portMAX_DELAY &&
+                                         (int32_t)(nowTicks() - until) >= 0);
+          },
+          timeout == portMAX_DELAY ? NO_DEADLINE : deadlineAfter(timeout));
+    uint32_t n = t->notified;
+    if (n > 0)
+        t->notified = clearOnExit ? 0 : n - 1;
+    return n;
+}
+
+void xTaskNotifyGive(TaskHandle_t task) {
+    std::lock_guard<std::mutex> lk(lock);
+    task->notified++;
+    wakeReady();
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new HostSemaphore; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout) {
+    std::unique_lock<std::mutex> lk(lock);
+    if (sem->taken && timeout == 0)
+        return pdFALSE;
+    uint32_t until = nowTicks() + timeout;
+    block(lk,
+          [=] {
+              return !sem->taken || (timeout != portMAX_DELAY &&
+                                     (int32_t)(nowTicks() - until) >= 0);
+          },
+          timeout == portMAX_DELAY ? NO_DEADLINE : deadlineAfter(timeout));
+    if (sem->taken)
+        return pdFALSE;
+    sem->taken = true;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    std::lock_guard<std::mutex> lk(lock);
+    sem->taken = false;
+    wakeReady();
+    return pdTRUE;
+}
@@ -0,0 +1,25 @@
+#ifndef HOSTSHIMS_H
+#define HOSTSHIMS_H
+
+// Force-included into the firmware sources of the host build. Routes the
+// C library's wall clock through the stand-in in HostTime.cpp, so the
+// firmware can set, step and slew "system" time without touching the
+// host's clock. Everything else (mktime, localtime_r, TZ rules) is the
+// real C library.
+
+#include <sys/time.h>
+#include <time.h>
+
+namespace Host {
+time_t wallNow(time_t *out);
+int wallGet(struct timeval *tv, void *tz);
+int wallSet(const struct timeval *tv, const void *tz);
+int wallAdjust(const struct timeval *delta, struct timeval *pending);
+} // namespace Host
+
+#define time(out) Host::wallNow(out)
+#define gettimeofday(tv, tz) Host::wallGet(tv, tz)
+#define settimeofday(tv, tz) Host::wallSet(tv, tz)
+#define adjtime(delta, pending) Host::wallAdjust(delta, pending)
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef HOSTSIM_H
+#define HOSTSIM_H
+
+#include <stdint.h>
+#include <string>
+#include <sys/time.h>
+#include <time.h>
+#include <vector>
+
+// Controls for the host stand-ins of the Arduino core and the libraries
+// the firmware uses: a virtual clock, scripted pins, sensors, WiFi and
+// SNTP, and counters for what the firmware sent to the LEDC, NVS and
+// flash. Tests and the simulator drive the firmware through this; the
+// firmware itself never includes it.
+namespace Host {
+
+// --- Virtual clock ---
+// Behind millis(), micros(), esp_timer_get_time() and FreeRTOS ticks.
+// Starts at zero and only moves when advanced.
+uint64_t nowUs();
+// Moves the clock forward, then waits until every stand-in task that is
+// due by the new time has run and blocked again, so runs are repeatable.
+void advanceUs(uint64_t us);
+void advanceMs(uint32_t ms);
+
+// --- Wall clock ---
+// Behind time(), gettimeofday(), settimeofday() and adjtime() in firmware
+// code (see HostShims.h). It starts at 0 (1970) like an unset RTC and
+// runs with the virtual clock, faster by driftPpm.
+void setWallTime(time_t t, uint32_t usec = 0);
+void setWallDriftPpm(double ppm);
+struct timeval wallTime();
+// Slew still outstanding from adjtime()
+int64_t wallPendingUs();
+
+// --- Pins and interrupts ---
+// Pins read HIGH (pulled up) until set. Changing a pin runs the handler
+// attached to it, as the GPIO interrupt would.
+void setPin(int pin, int level);
+
+// --- Sensors (AHT21, ENS160) ---
+struct SensorValues {
+    float temp = 22.0f;
+    float hum = 40.0f;
+    uint16_t tvoc = 100;
+    uint16_t eco2 = 600;
+    bool present = true;
+};
+void setSensors(const SensorValues &v);
+SensorValues sensors();
+
+// --- WiFi and SNTP ---
+// With the network available, WiFi.begin() connects after connectMs.
+void setWifiAvailable(bool available);
+void setWifiConnectMs(uint32_t ms);
+int wifiBeginCount();
+bool sntpStarted();
+uint32_t sntpIntervalMs();
+int sntpRestartCount();
+// Answers an SNTP request: hands server time to sntp_sync_time().
+void sntpDeliver(time_t serverTime, uint32_t usec = 0);
+
+// --- LEDC ---
+enum LedcOp : uint8_t { LEDC_SETUP, LEDC_FREQ, LEDC_DUTY, LEDC_ATTACH,
+                        LEDC_DETACH };
+struct LedcEvent {
+    uint32_t ms;
+    LedcOp op;
+    uint8_t channel;
+    uint32_t value; // frequency, duty or pin
+};
+const std::vector<LedcEvent> &ledcLog();
+void clearLedcLog();
+
+// --- NVS (Preferences) ---
+struct NvsStats {
+    uint32_t writes = 0; // put* calls that stored something
+    uint32_t bytes = 0;  // value bytes written
+};
+NvsStats nvsStats();
+// Drops every namespace and zeroes the counters.
+void clearNvs();
+
+// --- Flash file system (LittleFS) ---
+// LittleFS is backed by a host directory, created if missing.
+void setFsRoot(const std::string &dir);
+const std::string &fsRoot();
+uint64_t fsBytesWritten();
+uint64_t fsBytesRead();
+void resetFsCounters();
+
+// --- Serial and system ---
+// Everything printed to Serial. Echoed to stdout unless turned off.
+std::string &serialOutput();
+void setSerialEcho(bool echo);
+bool restartRequested();
+
+} // namespace Host
+
+#endif
@@ -0,0 +1,146 @@
+#include "Arduino.h"
+#include "HostSim.h"
+#include "HostShims.h"
+#include "esp_sntp.h"
+#include "esp_timer.h"
+#include <mutex>
+
+namespace {
+std::mutex lock;
+int64_t wallUs = 0;   // wall clock as of lastMonoUs
+uint64_t lastMonoUs = 0;
+double driftPpm = 0;
+int64_t pendingUs = 0; // adjtime() slew still to apply
+
+bool started = false;
+uint32_t intervalMs = 3600000;
+int restarts = 0;
+sntp_sync_status_t status = SNTP_SYNC_STATUS_RESET;
+
+// Brings the wall clock up to the virtual clock. Slew is applied at 1/64
+// of elapsed time, the rate ESP-IDF's adjtime() uses.
+void catchUp() {
+    uint64_t mono = Host::nowUs();
+    int64_t elapsed = (int64_t)(mono - lastMonoUs);
+    lastMonoUs = mono;
+    wallUs += elapsed + (int64_t)(elapsed * driftPpm / 1e6);
+    int64_t slew = std::min(elapsed >> 6, pendingUs < 0 ? -pendingUs
+                                                        : pendingUs);
+    if (pendingUs < 0)
+        slew = -slew;
+    wallUs += slew;
+    pendingUs -= slew;
+}
+
+struct timeval toTimeval(int64_t us) {
+    struct timeval tv;
+    tv.tv_sec = us / 1000000;
+    tv.tv_usec = us % 1000000;
+    if (tv.tv_usec < 0) {
+        tv.tv_sec--;
+        tv.tv_usec += 1000000;
+    }
+    return tv;
+}
+} // namespace
+
+namespace Host {
+void setWallTime(time_t t, uint32_t usec) {
+    std::lock_guard<std::mutex> lk(lock);
+    catchUp();
+    wallUs = (int64_t)t * 1000000 + usec;
+    pendingUs = 0;
+}
+
+void setWallDriftPpm(double ppm) {
+    std::lock_guard<std::mutex> lk(lock);
+    catchUp();
+    driftPpm = ppm;
+}
+
+struct timeval wallTime() {
+    std::lock_guard<std::mutex> lk(lock);
+    catchUp();
+    return toTimeval(wallUs);
+}
+
+int64_t wallPendingUs() {
+    std::lock_guard<std::mutex> lk(lock);
+    catchUp();
+    return pendingUs;
+}
+
+time_t wallNow(time_t *out) {
+    time_t t = wallTime().tv_sec;
+    if (out)
+        *out = t;
+    return t;
+}
+
+int wallGet(struct timeval *tv, void * /*tz*/) {
+    if (tv)
+        *tv = wallTime();
+    return 0;
+}
+
+int wallSet(const struct timeval *tv, const void * /*tz*/) {
+    if (tv)
+        setWallTime(tv->tv_sec, tv->tv_usec);
+    return 0;
+}
+
+int wallAdjust(const struct timeval *delta, struct timeval *pending) {
+    std::lock_guard<std::mutex> lk(lock);
+    catchUp();
+    if (pending)
+        *pending = toTimeval(pendingUs);
+    if (delta)
+        pendingUs = (int64_t)delta->tv_sec * 1000000 + delta->tv_usec;
+    return 0;
+}
+
+bool sntpStarted() { return started; }
+uint32_t sntpIntervalMs() { return intervalMs; }
+int sntpRestartCount() { return restarts; }
+
+void sntpDeliver(time_t serverTime, uint32_t usec) {
+    struct timeval tv;
+    tv.tv_sec = serverTime;
+    tv.tv_usec = usec;
+    sntp_sync_time(&tv);
+}
+} // namespace Host
+
+// ESP-IDF's weak default steps the clock; the firmware overrides it.
+extern "C" __attribute__((weak)) void sntp_sync_time(struct timeval *tv) {
+    Host::wallSet(tv, nullptr);
+    sntp_set_sync_status(SNTP_SYNC_STATUS_COMPLETED);
+}
+
+int64_t esp_timer_get_time() { return (int64_t)Host::nowUs(); }
+
+void configTime(long /*gmtOffset*/, int /*dstOffset*/, const char * /*server1*/,
+                const char * /*server2*/, const char * /*server3*/) {
+    started = true;
+    status = SNTP_SYNC_STATUS_RESET;
+}
+
+bool getLocalTime(struct tm *info, uint32_t /*ms*/) {
+    time_t now = Host::wallNow(nullptr);
+    localtime_r(&now, info);
+    return info->tm_year > (2016 - 1900);
+}
+
+void sntp_set_sync_interval(uint32_t ms) { intervalMs = ms; }
+uint32_t sntp_get_sync_interval() { return intervalMs; }
+bool sntp_restart() {
+    restarts++;
+    return started;
+}
+void sntp_set_sync_status(sntp_sync_status_t s) { status = s; }
+sntp_sync_status_t sntp_get_sync_status() {
+    sntp_sync_status_t s = status;
+    if (s == SNTP_SYNC_STATUS_COMPLETED)
+        status = SNTP_SYNC_STATUS_RESET;
+    return s;
+}
@@ -0,0 +1,428 @@
+// Host stand-ins for the sensor, storage and network libraries.
+
+#include "Adafruit_AHTX0.h"
+#include "HostSim.h"
+#include "LittleFS.h"
+#include "Preferences.h"
+#include "SPI.h"
+#include "ScioSense_ENS160.h"
+#include "WiFi.h"
+#include "Wire.h"
+#include "esp_rom_crc.h"
+#include <atomic>
+#include <dirent.h>
+#include <map>
+#include <mutex>
+#include <sys/stat.h>
+#include <vector>
+
+SPIClass SPI;
+TwoWire Wire;
+WiFiClass WiFi;
+LittleFSFS LittleFS;
+
+// --- Sensors ---
+
+namespace {
+std::mutex sensorLock;
+Host::SensorValues sensorValues;
+} // namespace
+
+namespace Host {
+void setSensors(const SensorValues &v) {
+    std::lock_guard<std::mutex> lk(sensorLock);
+    sensorValues = v;
+}
+
+SensorValues sensors() {
+    std::lock_guard<std::mutex> lk(sensorLock);
+    return sensorValues;
+}
+} // namespace Host
+
+bool Adafruit_AHTX0::begin() { return Host::sensors().present; }
+
+bool Adafruit_AHTX0::getEvent(sensors_event_t *humidity,
+                              sensors_event_t *temp) {
+    Host::SensorValues v = Host::sensors();
+    if (!v.present)
+        return false;
+    humidity->relative_humidity = v.hum;
+    temp->temperature = v.temp;
+    return true;
+}
+
+bool ScioSense_ENS160::begin() { return Host::sensors().present; }
+
+bool ScioSense_ENS160::setMode(uint8_t m) {
+    mode = m;
+    return true;
+}
+
+bool ScioSense_ENS160::measure(bool /*waitForNew*/) {
+    Host::SensorValues v = Host::sensors();
+    if (!v.present || mode != ENS160_OPMODE_STD)
+        return false;
+    tvoc = v.tvoc;
+    eco2 = v.eco2;
+    return true;
+}
+
+// --- NVS ---
+
+namespace {
+typedef std::map<std::string, std::vector<uint8_t>> Namespace;
+std::mutex nvsLock;
+std::map<std::string, Namespace> nvs;
+Host::NvsStats nvsCounters;
+} // namespace
+
+namespace Host {
+NvsStats nvsStats() {
+    std::lock_guard<std::mutex> lk(nvsLock);
+    return nvsCounters;
+}
+
+void clearNvs() {
+    std::lock_guard<std::mutex> lk(nvsLock);
+    nvs.clear();
+    nvsCounters = NvsStats();
+}
+} // namespace Host
+
+bool Preferences::begin(const char *name, bool ro) {
+    std::lock_guard<std::mutex> lk(nvsLock);
+    // As on the device, a namespace has to exist to be opened read-only
+    if (ro && nvs.find(name) == nvs.end())
+        return false;
+    nvs[name];
+    ns = name;
+    readOnly = ro;
+    open = true;
+    return true;
+}
+
+void Preferences::end() { open = false; }
+
+bool Preferences::isKey(const char *key) {
+    std::lock_guard<std::mutex> lk(nvsLock);
+    return open && nvs[ns].count(key) > 0;
+}
+
+bool Preferences::remove(const char *key) {
+    std::lock_guard<std::mutex> lk(nvsLock);
+    if (!open || readOnly)
+        return false;
+    if (nvs[ns].erase(key) > 0)
+        nvsCounters.writes++;
+    return true;
+}
+
+bool Preferences::clear() {
+    std::lock_guard<std::mutex> lk(nvsLock);
+    if (!open || readOnly)
+        return false;
+    nvs[ns].clear();
+    nvsCounters.writes++;
+    return true;
+}
+
+size_t Preferences::put(const char *key, const void *value, size_t len) {
+    std::lock_guard<std::mutex> lk(nvsLock);
+    if (!open || readOnly)
+        return 0;
+    const uint8_t *p = static_cast<const uint8_t *>(value);
+    nvs[ns][key].assign(p, p + len);
+    nvsCounters.writes++;
+    nvsCounters.bytes += len;
+    return len;
+}
+
+bool Preferences::get(const char *key, void *out, size_t len) {
+    std::lock_guard<std::mutex> lk(nvsLock);
+    if (!open)
+        return false;
+    Namespace &n = nvs[ns];
+    auto it = n.find(key);
+    if (it == n.end() || it->second.size() != len)
+        return false;
+    memcpy(out, it->second.data(), len);
+    return true;
+}
+
+bool Preferences::getBool(const char *key, bool def) {
+    uint8_t v;
+    return get(key, &v, 1) ? v != 0 : def;
+}
+
+int32_t Preferences::getInt(const char *key, int32_t def) {
+    int32_t v;
+    return get(key, &v, sizeof(v)) ? v : def;
+}
+
+uint32_t Preferences::getUInt(const char *key, uint32_t def) {
+    uint32_t v;
+    return get(key, &v, sizeof(v)) ? v : def;
+}
+
+size_t Preferences::getBytesLength(const char *key) {
+    std::lock_guard<std::mutex> lk(nvsLock);
+    if (!open)
+        return 0;
+    Namespace &n = nvs[ns];
+    auto it = n.find(key);
+    return it == n.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen) {
+    size_t len = getBytesLength(key);
+    if (len == 0 || len > maxLen)
+        return 0;
+    return get(key, buf, len) ? len : 0;
+}
+
+size_t Preferences::putBool(const char *key, bool value) {
+    uint8_t v = value;
+    return put(key, &v, 1);
+}
+
+size_t Preferences::putInt(const char *key, int32_t value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putUInt(const char *key, uint32_t value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t len) {
+    return put(key, value, len);
+}
+
+// --- LittleFS ---
+
+namespace fs {
+struct FileImpl {
+    FILE *fp = nullptr;
+    DIR *dir = nullptr;
+    std::string path; // host path
+    std::string name;
+    ~FileImpl() {
+        if (fp)
+            fclose(fp);
+        if (dir)
+            closedir(dir);
+    }
+};
+} // namespace fs
+
+namespace {
+std::string root = std::string(P_tmpdir) + "/cyberclock-littlefs";
+std::atomic<uint64_t> bytesWritten{0};
+std::atomic<uint64_t> bytesRead{0};
+
+std::string hostPath(const char *path) {
+    return root + (path[0] == '/' ? "" : "/") + path;
+}
+
+std::string baseName(const std::string &path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+File openHost(const std::string &path, const char *mode) {
+    struct stat st;
+    bool isDir = stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    std::shared_ptr<fs::FileImpl> impl = std::make_shared<fs::FileImpl>();
+    impl->path = path;
+    impl->name = baseName(path);
+    if (isDir) {
+        impl->dir = opendir(path.c_str());
+        if (!impl->dir)
+            return File();
+    } else {
+        const char *m = mode[0] == 'w' ? "wb" : mode[0] == 'a' ? "ab+" : "rb";
+        impl->fp = fopen(path.c_str(), m);
+        if (!impl->fp)
+            return File();
+    }
+    return File(impl);
+}
+} // namespace
+
+namespace Host {
+void setFsRoot(const std::string &dir) {
+    root = dir;
+    ::mkdir(root.c_str(), 0755);
+}
+
+const std::string &fsRoot() { return root; }
+uint64_t fsBytesWritten() { return bytesWritten; }
+uint64_t fsBytesRead() { return bytesRead; }
+
+void resetFsCounters() {
+    bytesWritten = 0;
+    bytesRead = 0;
+}
+} // namespace Host
+
+namespace fs {
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t *buf, size_t n) {
+    if (!impl || !impl->fp)
+        return 0;
+    size_t done = fwrite(buf, 1, n, impl->fp);
+    bytesWritten += done;
+    return done;
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::read(uint8_t *buf, size_t n) {
+    if (!impl || !impl->fp)
+        return 0;
+    size_t done = fread(buf, 1, n, impl->fp);
+    bytesRead += done;
+    return done;
+}
+
+bool File::seek(uint32_t pos) {
+    return impl && impl->fp && fseek(impl->fp, pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const {
+    return impl && impl->fp ? (size_t)ftell(impl->fp) : 0;
+}
+
+size_t File::size() const {
+    if (!impl || !impl->fp)
+        return 0;
+    fflush(impl->fp);
+    struct stat st;
+    return fstat(fileno(impl->fp), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::close() { impl.reset(); }
+
+const char *File::name() const { return impl ? impl->name.c_str() : ""; }
+
+bool File::isDirectory() const { return impl && impl->dir; }
+
+File File::openNextFile() {
+    if (!impl || !impl->dir)
+        return File();
+    while (struct dirent *e = readdir(impl->dir)) {
+        if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0)
+            continue;
+        return openHost(impl->path + "/" + e->d_name, "r");
+    }
+    return File();
+}
+
+File::operator bool() const { return impl != nullptr; }
+} // namespace fs
+
+bool LittleFSFS::begin(bool /*formatOnFail*/) {
+    ::mkdir(root.c_str(), 0755);
+    struct stat st;
+    return stat(root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool LittleFSFS::exists(const char *path) {
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool LittleFSFS::mkdir(const char *path) {
+    return ::mkdir(hostPath(path).c_str(), 0755) == 0;
+}
+
+bool LittleFSFS::remove(const char *path) {
+    return ::remove(hostPath(path).c_str()) == 0;
+}
+
+File LittleFSFS::open(const char *path, const char *mode) {
+    return openHost(hostPath(path), mode);
+}
+
+// --- WiFi ---
+
+namespace {
+std::mutex wifiLock;
+bool wifiAvailable = true;
+uint32_t wifiConnectMs = 2000;
+int wifiBegins = 0;
+bool wifiJoining = false; // begin() called and the link not lost since
+uint32_t wifiBeginMs = 0;
+} // namespace
+
+namespace Host {
+void setWifiAvailable(bool available) {
+    std::lock_guard<std::mutex> lk(wifiLock);
+    wifiAvailable = available;
+    if (!available)
+        wifiJoining = false;
+}
+
+void setWifiConnectMs(uint32_t ms) {
+    std::lock_guard<std::mutex> lk(wifiLock);
+    wifiConnectMs = ms;
+}
+
+int wifiBeginCount() {
+    std::lock_guard<std::mutex> lk(wifiLock);
+    return wifiBegins;
+}
+} // namespace Host
+
+wl_status_t WiFiClass::begin() {
+    std::lock_guard<std::mutex> lk(wifiLock);
+    wifiBegins++;
+    wifiJoining = wifiAvailable;
+    wifiBeginMs = millis();
+    return WL_DISCONNECTED;
+}
+
+bool WiFiClass::disconnect(bool /*wifiOff*/) {
+    std::lock_guard<std::mutex> lk(wifiLock);
+    wifiJoining = false;
+    return true;
+}
+
+wl_status_t WiFiClass::status() {
+    std::lock_guard<std::mutex> lk(wifiLock);
+    if (wifiJoining && millis() - wifiBeginMs >= wifiConnectMs)
+        return WL_CONNECTED;
+    return WL_DISCONNECTED;
+}
+
+String WiFiClass::SSID() {
+    return status() == WL_CONNECTED ? String("HostNet") : String("");
+}
+
+// --- ROM CRCs ---
+// Both take and return the finished CRC, inverting around the update, so
+// a CRC can be continued across calls.
+
+uint16_t esp_rom_crc16_le(uint16_t crc, const uint8_t *buf, uint32_t len) {
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int b = 0; b < 8; b++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : crc >> 1;
+    }
+    return ~crc;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int b = 0; b < 8; b++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+    return ~crc;
+}
@@ -0,0 +1,20 @@
+#ifndef LITTLEFS_H
+#define LITTLEFS_H
+
+#include "FS.h"
+
+// Host stand-in: paths map onto Host::fsRoot(), and bytes moved are
+// counted in Host::fsBytesWritten() and fsBytesRead().
+class LittleFSFS {
+  public:
+    bool begin(bool formatOnFail = false);
+    bool exists(const char *path);
+    bool mkdir(const char *path);
+    bool remove(const char *path);
+    // Mode "r", "w" or "a"; a directory opens for openNextFile()
+    File open(const char *path, const char *mode = "r");
+};
+
+extern LittleFSFS LittleFS;
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef PREFERENCES_H
+#define PREFERENCES_H
+
+#include "Arduino.h"
+
+// Host stand-in for NVS: namespaces of typed keys kept in memory for the
+// life of the process, so they survive a simulated reboot. Writes are
+// counted in Host::nvsStats().
+class Preferences {
+  public:
+    bool begin(const char *name, bool readOnly = false);
+    void end();
+
+    bool isKey(const char *key);
+    bool remove(const char *key);
+    bool clear();
+
+    bool getBool(const char *key, bool def = false);
+    int32_t getInt(const char *key, int32_t def = 0);
+    uint32_t getUInt(const char *key, uint32_t def = 0);
+    size_t getBytesLength(const char *key);
+    size_t getBytes(const char *key, void *buf, size_t maxLen);
+
+    size_t putBool(const char *key, bool value);
+    size_t putInt(const char *key, int32_t value);
+    size_t putUInt(const char *key, uint32_t value);
+    size_t putBytes(const char *key, const void *value, size_t len);
+
+  private:
+    std::string ns;
+    bool open = false;
+    bool readOnly = true;
+
+    size_t put(const char *key, const void *value, size_t len);
+    bool get(const char *key, void *out, size_t len);
+};
+
+#endif
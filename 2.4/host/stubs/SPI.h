@@ -0,0 +1,12 @@
+#ifndef SPI_H
+#define SPI_H
+
+class SPIClass {
+  public:
+    void begin(int /*sck*/ = -1, int /*miso*/ = -1, int /*mosi*/ = -1,
+               int /*ss*/ = -1) {}
+};
+
+extern SPIClass SPI;
+
+#endif
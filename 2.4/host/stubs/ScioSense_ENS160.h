@@ -0,0 +1,28 @@
+#ifndef SCIOSENSE_ENS160_H
+#define SCIOSENSE_ENS160_H
+
+#include "Arduino.h"
+
+#define ENS160_OPMODE_DEP_SLEEP 0x00
+#define ENS160_OPMODE_IDLE 0x01
+#define ENS160_OPMODE_STD 0x02
+
+// Host stand-in: reads Host::sensors(), and reports 0xFFFF (no data)
+// until put in standard mode, like an idle part.
+class ScioSense_ENS160 {
+  public:
+    explicit ScioSense_ENS160(uint8_t /*address*/) {}
+    bool begin();
+    bool setMode(uint8_t mode);
+    bool set_envdata(float /*temp*/, float /*hum*/) { return true; }
+    bool measure(bool waitForNew = true);
+    uint16_t getTVOC() const { return tvoc; }
+    uint16_t geteCO2() const { return eco2; }
+
+  private:
+    uint8_t mode = ENS160_OPMODE_IDLE;
+    uint16_t tvoc = 0xFFFF;
+    uint16_t eco2 = 0xFFFF;
+};
+
+#endif
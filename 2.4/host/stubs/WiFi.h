@@ -0,0 +1,37 @@
+#ifndef WIFI_H
+#define WIFI_H
+
+#include "Arduino.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3,
+} wifi_mode_t;
+
+// Host stand-in: joins when Host::setWifiAvailable() says the network is
+// there, Host::setWifiConnectMs() after begin(), and loses the link when
+// it goes away.
+class WiFiClass {
+  public:
+    bool mode(wifi_mode_t /*m*/) { return true; }
+    bool setAutoReconnect(bool /*on*/) { return true; }
+    wl_status_t begin();
+    bool disconnect(bool wifiOff = false);
+    wl_status_t status();
+    String SSID();
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef WIFIMANAGER_H
+#define WIFIMANAGER_H
+
+#include "WiFi.h"
+
+// Host stand-in: the portal never receives credentials.
+class WiFiManager {
+  public:
+    void setConfigPortalBlocking(bool /*blocking*/) {}
+    bool startConfigPortal(const char * /*apName*/) { return false; }
+    void stopConfigPortal() {}
+    bool process() { return false; }
+    void resetSettings() {}
+};
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+class TwoWire {
+  public:
+    bool begin(int /*sda*/ = -1, int /*scl*/ = -1, unsigned long /*freq*/ = 0) {
+        return true;
+    }
+    void setClock(unsigned long /*freq*/) {}
+};
+
+extern TwoWire Wire;
+
+#endif
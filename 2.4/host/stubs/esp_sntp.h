@@ -0,0 +1,26 @@
+#ifndef ESP_SNTP_H
+#define ESP_SNTP_H
+
+#include <stdint.h>
+#include <sys/time.h>
+
+// Host stand-in for ESP-IDF's SNTP client. Nothing is sent; tests answer
+// requests with Host::sntpDeliver().
+
+typedef enum {
+    SNTP_SYNC_STATUS_RESET,
+    SNTP_SYNC_STATUS_COMPLETED,
+    SNTP_SYNC_STATUS_IN_PROGRESS,
+} sntp_sync_status_t;
+
+void sntp_set_sync_interval(uint32_t ms);
+uint32_t sntp_get_sync_interval();
+bool sntp_restart();
+void sntp_set_sync_status(sntp_sync_status_t status);
+sntp_sync_status_t sntp_get_sync_status();
+
+// Weak default in HostTime.cpp; the firmware overrides it as on the
+// device
+extern "C" void sntp_sync_time(struct timeval *tv);
+
+#endif
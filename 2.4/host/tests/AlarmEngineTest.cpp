@@ -0,0 +1,197 @@
+// AlarmEngine on a virtual wall clock in the firmware's time zone: local
+// fire times across both DST changes, weekday masks, one-shots, snooze,
+// loop stalls and clock steps.
+
+#include "AlarmEngine.h"
+#include "Check.h"
+#include "Config.h"
+#include "Globals.h"
+#include "TimeService.h"
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+time_t fakeNow = 0;
+time_t fakeClock() { return fakeNow; }
+
+// Midnight UTC on Friday 2025-03-28, two days before spring forward
+const time_t MARCH_28 = 1743120000;
+// Midnight UTC on Friday 2025-10-24, two days before fall back
+const time_t OCTOBER_24 = 1761264000;
+const time_t DAY = 86400;
+
+std::vector<time_t> fired;
+
+void setUp() {
+    static bool once = false;
+    if (!once) {
+        setenv("TZ", Net::TIME_ZONE, 1);
+        tzset();
+        Time.setClock(fakeClock);
+        Time.subscribe(AlarmEngine::onTimeJump, TIME_JUMP);
+        once = true;
+    }
+    for (int i = 0; i < ALARM_COUNT; i++)
+        settings.alarms[i] = AlarmSpec{7, 0, false, 0x7F};
+    Alarms = AlarmEngine();
+    fired.clear();
+}
+
+// One loop pass at the current fake time; a ringing alarm is dismissed
+// straight away unless snoozing is wanted
+void tick(bool snooze = false) {
+    Time.update();
+    Alarms.check();
+    if (Alarms.ringing()) {
+        fired.push_back(fakeNow);
+        if (snooze)
+            Alarms.snooze();
+        else
+            Alarms.dismiss();
+    }
+}
+
+void runUntil(time_t end, int stepS = 1) {
+    for (; fakeNow < end; fakeNow += stepS)
+        tick();
+}
+
+struct tm localOf(time_t t) {
+    struct tm tm;
+    localtime_r(&t, &tm);
+    return tm;
+}
+} // namespace
+
+TEST(dailyAlarmKeepsItsLocalTimeAcrossDst) {
+    for (time_t start : {MARCH_28, OCTOBER_24}) {
+        setUp();
+        settings.alarms[0] = AlarmSpec{7, 0, true, 0x7F};
+        Alarms.changed();
+        fakeNow = start;
+        runUntil(start + 5 * DAY, 5);
+        CHECK_EQ(fired.size(), 5);
+        for (time_t t : fired) {
+            struct tm tm = localOf(t);
+            CHECK_EQ(tm.tm_hour, 7);
+            CHECK_EQ(tm.tm_min, 0);
+            CHECK(tm.tm_sec < 5);
+        }
+        // The day of the change is an hour shorter or longer
+        CHECK_EQ(fired[2] - fired[1],
+                 start == MARCH_28 ? 23 * 3600 : 25 * 3600);
+    }
+}
+
+TEST(alarmInTheSkippedHourRingsOnce) {
+    setUp();
+    // 02:30 does not exist on 2025-03-30
+    settings.alarms[0] = AlarmSpec{2, 30, true, 0x7F};
+    Alarms.changed();
+    fakeNow = MARCH_28;
+    runUntil(MARCH_28 + 4 * DAY, 5);
+    CHECK_EQ(fired.size(), 4);
+    // Rings once that day, in the hour after the change (03:xx CEST)
+    struct tm tm = localOf(fired[2]);
+    CHECK_EQ(tm.tm_mday, 30);
+    CHECK_EQ(tm.tm_hour, 3);
+    CHECK_EQ(localOf(fired[3]).tm_hour, 2);
+}
+
+TEST(alarmInTheRepeatedHourRingsOnce) {
+    setUp();
+    // 02:30 happens twice on 2025-10-26
+    settings.alarms[0] = AlarmSpec{2, 30, true, 0x7F};
+    Alarms.changed();
+    fakeNow = OCTOBER_24;
+    runUntil(OCTOBER_24 + 4 * DAY, 5);
+    CHECK_EQ(fired.size(), 4);
+    int onSunday = 0;
+    for (time_t t : fired)
+        onSunday += localOf(t).tm_mday == 26;
+    CHECK_EQ(onSunday, 1);
+}
+
+TEST(weekdayMaskAndOneShot) {
+    setUp();
+    // Monday to Friday; bit 0 is Sunday
+    settings.alarms[1] = AlarmSpec{6, 45, true, 0x3E};
+    // One-shot
+    settings.alarms[2] = AlarmSpec{12, 0, true, 0};
+    Alarms.changed();
+    fakeNow = MARCH_28;
+    runUntil(MARCH_28 + 14 * DAY, 10);
+    int weekday = 0, noon = 0;
+    for (time_t t : fired) {
+        struct tm tm = localOf(t);
+        if (tm.tm_hour == 6) {
+            weekday++;
+            CHECK(tm.tm_wday >= 1 && tm.tm_wday <= 5);
+        } else {
+            noon++;
+        }
+    }
+    CHECK_EQ(weekday, 10);
+    CHECK_EQ(noon, 1);
+    CHECK(!settings.alarms[2].enabled);
+    CHECK(settings.alarms[1].enabled);
+}
+
+TEST(snoozeRingsAgainLater) {
+    setUp();
+    settings.alarms[0] = AlarmSpec{7, 0, true, 0x7F};
+    Alarms.changed();
+    time_t seven = MARCH_28 + 6 * 3600; // 07:00 CET
+    fakeNow = seven - 3600;
+    runUntil(seven);
+    tick(true);
+    CHECK_EQ(fired.size(), 1);
+    CHECK(!Alarms.ringing());
+    CHECK_EQ(Alarms.nextFire(), fired[0] + (time_t)AlarmEngine::SNOOZE_S);
+    runUntil(seven + 3600);
+    CHECK_EQ(fired.size(), 2);
+    CHECK_EQ(fired[1] - fired[0], AlarmEngine::SNOOZE_S);
+    // Dismissed: back to tomorrow
+    CHECK_EQ(Alarms.nextFire(), fired[0] + DAY);
+}
+
+TEST(stallsRingLateAndStepsSkip) {
+    setUp();
+    settings.alarms[0] = AlarmSpec{7, 0, true, 0x7F};
+    Alarms.changed();
+    time_t seven = MARCH_28 + 6 * 3600; // 07:00 CET
+    fakeNow = seven - 30;
+    tick();
+    // The loop stalls for a minute across 07:00
+    fakeNow = seven + 30;
+    tick();
+    CHECK_EQ(fired.size(), 1);
+
+    // An NTP step over the next day's alarm: not rung, moved on
+    fakeNow = seven + DAY - 3600;
+    tick();
+    fakeNow = seven + DAY + 3 * 3600;
+    tick();
+    CHECK_EQ(fired.size(), 1);
+    // 07:00 on Sunday is already summer time
+    CHECK_EQ(Alarms.nextFire(), seven + 2 * DAY - 3600);
+
+    // Stepped back a day: rescheduled from the new time
+    fakeNow = seven + DAY - 60;
+    tick();
+    CHECK_EQ(Alarms.nextFire(), seven + DAY);
+    runUntil(seven + DAY + 60);
+    CHECK_EQ(fired.size(), 2);
+}
+
+TEST(nothingRingsBeforeTheClockIsSet) {
+    setUp();
+    settings.alarms[0] = AlarmSpec{0, 1, true, 0x7F};
+    Alarms.changed();
+    fakeNow = 1000;
+    runUntil(1000 + DAY, 30);
+    CHECK_EQ(fired.size(), 0);
+    CHECK_EQ(Alarms.nextFire(), 0);
+}
+
+CHECK_MAIN()
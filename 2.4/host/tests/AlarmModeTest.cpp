@@ -0,0 +1,159 @@
+// Editing alarms on the device: the knob walks the alarm, hour, minute,
+// repeat preset, weekday and on/off fields, and each turn changes only the
+// field under the cursor.
+
+#include "AppModes.h"
+#include "Check.h"
+#include "Globals.h"
+#include "SettingsSchema.h"
+
+namespace {
+// Field order in AlarmMode
+enum {
+    F_ALARM = 0,
+    F_HOUR,
+    F_MINUTE,
+    F_PRESET,
+    F_MONDAY,
+    F_SUNDAY = F_MONDAY + 6,
+    F_ENABLED,
+    F_COUNT
+};
+
+int field = F_ALARM;
+
+void turn(int steps, int accel = 0) {
+    InputEvent ev = {(uint32_t)millis(), EV_ROTATE, BTN_NONE, (int16_t)steps,
+                     (int16_t)(accel != 0 ? accel : steps)};
+    Modes::Alarm.onInput(ev);
+}
+
+void click() {
+    InputEvent ev = {(uint32_t)millis(), EV_PRESS, BTN_ENC, 0, 0};
+    Modes::Alarm.onInput(ev);
+    field = (field + 1) % F_COUNT;
+}
+
+void moveTo(int f) {
+    while (field != f)
+        click();
+}
+
+void setUp() {
+    tft.init(Screen::HEIGHT, Screen::WIDTH);
+    tft.setRotation(1);
+    Schema::applyDefaults(settings);
+    State.switchMode(Modes::Clock);
+    State.update();
+    Modes::Alarm.setRinging(false);
+    State.switchMode(Modes::Alarm);
+    State.update();
+    // Back to the first field, wherever the last test left the cursor
+    while (field != F_ALARM)
+        click();
+}
+
+bool sameAlarm(const AlarmSpec &a, const AlarmSpec &b) {
+    return a.hour == b.hour && a.minute == b.minute &&
+           a.enabled == b.enabled && a.days == b.days;
+}
+} // namespace
+
+TEST(hourAndMinuteLeaveTheDaysAlone) {
+    setUp();
+    AlarmSpec before = settings.alarms[0];
+    moveTo(F_HOUR);
+    turn(1, 3);
+    CHECK_EQ(settings.alarms[0].hour, (before.hour + 3) % 24);
+    turn(-1, -5);
+    CHECK_EQ(settings.alarms[0].hour, (before.hour + 22) % 24);
+    CHECK_EQ(settings.alarms[0].days, before.days);
+
+    moveTo(F_MINUTE);
+    turn(-1);
+    CHECK_EQ(settings.alarms[0].minute, 59);
+    turn(2, 10);
+    CHECK_EQ(settings.alarms[0].minute, 9);
+    CHECK_EQ(settings.alarms[0].days, before.days);
+    CHECK_EQ(settings.alarms[0].enabled, before.enabled);
+}
+
+TEST(presetAndWeekdays) {
+    setUp();
+    moveTo(F_PRESET);
+    CHECK_EQ(settings.alarms[0].days, 0x7F);
+    turn(1);
+    CHECK_EQ(settings.alarms[0].days, 0x3E); // weekdays
+    turn(2);
+    CHECK_EQ(settings.alarms[0].days, 0x00); // once
+    turn(1);
+    CHECK_EQ(settings.alarms[0].days, 0x7F); // wraps to daily
+
+    // Monday is bit 1; any turn flips it once, however fast
+    moveTo(F_MONDAY);
+    turn(3, 12);
+    CHECK_EQ(settings.alarms[0].days, 0x7D);
+    turn(-1);
+    CHECK_EQ(settings.alarms[0].days, 0x7F);
+    // The cursor underlines the day being edited
+    int dayX = (Screen::WIDTH - 7 * 30) / 2 + 6;
+    CHECK_EQ(tft.pixel(dayX + 5, 138), Colors::LIGHT);
+    CHECK_EQ(tft.pixel(dayX + 35, 138), Colors::BG);
+
+    // Sunday is bit 0, Saturday bit 6
+    moveTo(F_SUNDAY);
+    turn(1);
+    CHECK_EQ(settings.alarms[0].days, 0x7E);
+    moveTo(F_SUNDAY - 1);
+    turn(1);
+    CHECK_EQ(settings.alarms[0].days, 0x3E);
+}
+
+TEST(enabledTogglesAndOtherAlarmsStayPut) {
+    setUp();
+    AlarmSpec others[ALARM_COUNT];
+    for (int i = 0; i < ALARM_COUNT; i++)
+        others[i] = settings.alarms[i];
+
+    // Pick the third alarm, then edit it
+    turn(2);
+    moveTo(F_HOUR);
+    turn(1);
+    moveTo(F_ENABLED);
+    bool was = settings.alarms[2].enabled;
+    turn(1);
+    CHECK_EQ(settings.alarms[2].enabled, !was);
+    turn(-4);
+    CHECK_EQ(settings.alarms[2].enabled, was);
+    CHECK_EQ(settings.alarms[2].hour, (others[2].hour + 1) % 24);
+    CHECK_EQ(settings.alarms[2].days, others[2].days);
+    for (int i = 0; i < ALARM_COUNT; i++)
+        if (i != 2)
+            CHECK(sameAlarm(settings.alarms[i], others[i]));
+
+    // The next press wraps back to the alarm selector
+    click();
+    CHECK_EQ(field, F_ALARM);
+    turn(-2);
+    moveTo(F_MINUTE);
+    turn(1);
+    CHECK_EQ(settings.alarms[0].minute, (others[0].minute + 1) % 60);
+}
+
+TEST(everyFieldKeepsTheAlarmValid) {
+    setUp();
+    int bad = 0;
+    for (int f = 0; f < 3 * F_COUNT; f++) {
+        for (int steps = -3; steps <= 3; steps++) {
+            turn(steps == 0 ? 1 : steps, steps * 4);
+            for (int i = 0; i < ALARM_COUNT; i++) {
+                const AlarmSpec &a = settings.alarms[i];
+                bad += a.hour > 23 || a.minute > 59 || a.days > 0x7F;
+            }
+        }
+        click();
+    }
+    CHECK_EQ(bad, 0);
+}
+
+CHECK_MAIN()
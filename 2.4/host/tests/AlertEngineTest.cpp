@@ -0,0 +1,232 @@
+// AlertEngine fed synthetic sensor series at the sensor task's rate:
+// hold times, hysteresis against a noisy reading, rise rules over their
+// window, priorities between rules, gaps in the samples and millis()
+// wrapping.
+
+#include "AlertEngine.h"
+#include "Check.h"
+#include "Globals.h"
+#include "SensorTask.h"
+#include "SettingsSchema.h"
+#include <random>
+
+namespace {
+const uint32_t STEP_MS = SensorTask::PERIOD_MS;
+
+uint32_t nowMs = 0;
+int32_t values[HIST_CHANNELS];
+int changes = 0;
+
+// Only the given rules, as the defaults have them; the engine starts fresh
+void setUp(std::initializer_list<int> rules, uint32_t startMs = 100000) {
+    Schema::applyDefaults(settings);
+    for (int i = 0; i < ALERT_RULE_COUNT; i++)
+        settings.alertRules[i].enabled = false;
+    for (int i : rules)
+        settings.alertRules[i].enabled = true;
+    Alerts = AlertEngine();
+    nowMs = startMs;
+    values[HIST_TEMP] = 215;
+    values[HIST_HUM] = 45;
+    values[HIST_TVOC] = 100;
+    values[HIST_CO2] = 600;
+    changes = 0;
+}
+
+// One sample with the current values
+void sample() {
+    AlertLevel before = Alerts.level();
+    Alerts.onSample(values, nowMs);
+    changes += Alerts.level() != before;
+    nowMs += STEP_MS;
+}
+
+void hold(int channel, int32_t v, uint32_t ms) {
+    values[channel] = v;
+    for (uint32_t t = 0; t < ms; t += STEP_MS)
+        sample();
+}
+
+// Straight line from the current value, perMinute units a minute
+void ramp(int channel, int32_t perMinute, uint32_t ms) {
+    int32_t start = values[channel];
+    for (uint32_t t = 0; t < ms; t += STEP_MS) {
+        values[channel] = start + (int32_t)((int64_t)perMinute * t / 60000);
+        sample();
+    }
+}
+} // namespace
+
+TEST(raisedAfterTheHoldClearedPastTheBand) {
+    // eCO2 above 1800 for 30 s, back below 1600
+    setUp({0});
+    hold(HIST_CO2, 900, 60000);
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+    hold(HIST_CO2, 1850, 30000);
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+    sample();
+    CHECK_EQ(Alerts.level(), ALERT_WARNING);
+    CHECK(Alerts.active(0));
+
+    // Within the band it stays raised
+    hold(HIST_CO2, 1700, 120000);
+    CHECK_EQ(Alerts.level(), ALERT_WARNING);
+    hold(HIST_CO2, 1600, 10000);
+    CHECK_EQ(Alerts.level(), ALERT_WARNING);
+    hold(HIST_CO2, 1599, 1000);
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+    CHECK_EQ(changes, 2);
+
+    // A short excursion restarts the hold
+    hold(HIST_CO2, 1900, 20000);
+    hold(HIST_CO2, 1790, 1000);
+    hold(HIST_CO2, 1900, 20000);
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+}
+
+TEST(noisyReadingDoesNotFlap) {
+    setUp({0});
+    std::mt19937 rng(11);
+    std::normal_distribution<double> noise(0, 40);
+    // Hovering at the threshold for two hours, as the old fixed comparison
+    // saw it and as the rule does
+    int naive = 0;
+    bool naiveOn = false;
+    for (int n = 0; n < 7200; n++) {
+        values[HIST_CO2] = 1800 + (int32_t)noise(rng);
+        bool on = values[HIST_CO2] > 1800;
+        naive += on != naiveOn;
+        naiveOn = on;
+        sample();
+    }
+    printf("level changes over 2 h at the threshold: fixed %d, rule %d\n",
+           naive, changes);
+    CHECK(naive > 1000);
+    CHECK_EQ(changes, 0);
+
+    // Once raised, the same noise a little lower keeps it raised
+    hold(HIST_CO2, 2000, 31000);
+    CHECK_EQ(Alerts.level(), ALERT_WARNING);
+    for (int n = 0; n < 7200; n++) {
+        values[HIST_CO2] = 1750 + (int32_t)noise(rng) / 2;
+        sample();
+    }
+    CHECK_EQ(changes, 1);
+    CHECK_EQ(Alerts.level(), ALERT_WARNING);
+}
+
+TEST(riseRuleJudgesTheWindow) {
+    // eCO2 up by more than 200 in 10 min, cleared below 150
+    setUp({1});
+    // Not judged before there are ten minutes of history, however steep
+    ramp(HIST_CO2, 100, 9 * 60000);
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+
+    setUp({1});
+    hold(HIST_CO2, 600, 15 * 60000);
+    // 15 a minute is 150 in the window
+    ramp(HIST_CO2, 15, 20 * 60000);
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+
+    // 25 a minute: over 200 once eight minutes of the window are rising
+    hold(HIST_CO2, 900, 15 * 60000);
+    uint32_t start = nowMs;
+    while (Alerts.level() == ALERT_NONE && nowMs - start < 15 * 60000) {
+        values[HIST_CO2] = 900 + (int32_t)((int64_t)25 * (nowMs - start) /
+                                           60000);
+        sample();
+    }
+    uint32_t took = nowMs - start;
+    CHECK_EQ(Alerts.level(), ALERT_NOTICE);
+    CHECK(took > 8 * 60000 && took < 10 * 60000);
+
+    // Levelling off: the rise leaves the window and the alert clears once
+    // it is under 150
+    int32_t top = values[HIST_CO2];
+    start = nowMs;
+    while (Alerts.level() != ALERT_NONE && nowMs - start < 15 * 60000)
+        hold(HIST_CO2, top, STEP_MS);
+    took = nowMs - start;
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+    CHECK(took > 3 * 60000 && took < 6 * 60000);
+    CHECK_EQ(changes, 2);
+}
+
+TEST(gapInTheSamplesRestartsTheWindow) {
+    setUp({1});
+    hold(HIST_CO2, 600, 15 * 60000);
+    // The sensor is away for twenty minutes and comes back much higher;
+    // the old minutes no longer describe the recent past
+    nowMs += 20 * 60000;
+    hold(HIST_CO2, 1200, 9 * 60000);
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+    // Ten minutes later there is history again, and the level is flat
+    hold(HIST_CO2, 1200, 5 * 60000);
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+    ramp(HIST_CO2, 40, 10 * 60000);
+    CHECK_EQ(Alerts.level(), ALERT_NOTICE);
+}
+
+TEST(highestRaisedLevelWins) {
+    // Dry air (notice after 5 min) and eCO2 (warning after 30 s)
+    setUp({0, 3});
+    hold(HIST_HUM, 20, 301000);
+    CHECK_EQ(Alerts.level(), ALERT_NOTICE);
+    hold(HIST_CO2, 2000, 31000);
+    CHECK_EQ(Alerts.level(), ALERT_WARNING);
+    CHECK(Alerts.active(0) && Alerts.active(3));
+    hold(HIST_CO2, 800, 1000);
+    CHECK_EQ(Alerts.level(), ALERT_NOTICE);
+    // Below rules clear above threshold plus hysteresis
+    hold(HIST_HUM, 28, 60000);
+    CHECK_EQ(Alerts.level(), ALERT_NOTICE);
+    hold(HIST_HUM, 29, 1000);
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+}
+
+TEST(editedRulesStartOver) {
+    setUp({0});
+    hold(HIST_CO2, 2000, 31000);
+    CHECK_EQ(Alerts.level(), ALERT_WARNING);
+
+    // Disabling drops the alert on the next sample
+    settings.alertRules[0].enabled = false;
+    sample();
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+    CHECK(!Alerts.active(0));
+
+    // A new threshold is judged afresh, including the hold
+    settings.alertRules[0].enabled = true;
+    settings.alertRules[0].threshold = 2500;
+    Alerts.changed();
+    hold(HIST_CO2, 2400, 60000);
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+    settings.alertRules[0].threshold = 1500;
+    Alerts.changed();
+    hold(HIST_CO2, 2400, 30000);
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+    sample();
+    CHECK_EQ(Alerts.level(), ALERT_WARNING);
+
+    // A channel out of range is ignored rather than read past the array
+    settings.alertRules[0].channel = HIST_CHANNELS;
+    sample();
+    CHECK_EQ(Alerts.level(), ALERT_NONE);
+}
+
+TEST(holdAndWindowSurviveMillisWrap) {
+    setUp({0, 1}, 0xFFFFFFFFu - 5 * 60000);
+    hold(HIST_CO2, 600, 4 * 60000 + 50000);
+    // The hold runs across the wrap
+    hold(HIST_CO2, 1900, 30000);
+    CHECK(nowMs < 0x80000000u);
+    sample();
+    CHECK(Alerts.active(0));
+    CHECK(!Alerts.active(1));
+    // So does the rise window, which still holds the 600s
+    hold(HIST_CO2, 1500, 6 * 60000);
+    CHECK(Alerts.active(1));
+    CHECK(!Alerts.active(0));
+}
+
+CHECK_MAIN()
@@ -0,0 +1,79 @@
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+// Counts heap allocations made while a AllocCounter::Scope is open. It
+// replaces the global operator new and glibc's malloc family, so include
+// it from exactly one file of a test executable.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <stdint.h>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *p, size_t size);
+void __libc_free(void *p);
+}
+
+namespace AllocCounter {
+inline std::atomic<bool> &armed() {
+    static std::atomic<bool> on(false);
+    return on;
+}
+
+inline std::atomic<uint32_t> &total() {
+    static std::atomic<uint32_t> n(0);
+    return n;
+}
+
+inline void note() {
+    if (armed().load(std::memory_order_relaxed))
+        total().fetch_add(1, std::memory_order_relaxed);
+}
+
+// Counts from construction to destruction; scopes do not nest.
+class Scope {
+  public:
+    Scope() : start(total().load()) { armed() = true; }
+    ~Scope() { armed() = false; }
+    uint32_t allocations() const { return total().load() - start; }
+
+  private:
+    uint32_t start;
+};
+} // namespace AllocCounter
+
+extern "C" {
+void *malloc(size_t size) {
+    AllocCounter::note();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    AllocCounter::note();
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *p, size_t size) {
+    AllocCounter::note();
+    return __libc_realloc(p, size);
+}
+
+void free(void *p) { __libc_free(p); }
+}
+
+void *operator new(size_t size) {
+    AllocCounter::note();
+    void *p = __libc_malloc(size != 0 ? size : 1);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { __libc_free(p); }
+void operator delete[](void *p) noexcept { __libc_free(p); }
+
+#endif
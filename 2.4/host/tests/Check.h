@@ -0,0 +1,81 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+// Just enough of a test framework for the host tests. TEST(name) registers
+// a case; a failed CHECK reports where and lets the case carry on; main()
+// runs every case and exits non-zero if anything failed.
+
+#include <iostream>
+#include <vector>
+
+namespace Check {
+struct Case {
+    const char *name;
+    void (*fn)();
+};
+
+inline std::vector<Case> &cases() {
+    static std::vector<Case> all;
+    return all;
+}
+
+inline int &failures() {
+    static int n = 0;
+    return n;
+}
+
+struct Registrar {
+    Registrar(const char *name, void (*fn)()) { cases().push_back({name, fn}); }
+};
+
+inline void fail(const char *file, int line, const char *what) {
+    std::cerr << file << ":" << line << ": " << what << "\n";
+    failures()++;
+}
+
+inline int runAll() {
+    for (const Case &c : cases()) {
+        int before = failures();
+        c.fn();
+        std::cout << (failures() == before ? "ok   " : "FAIL ") << c.name
+                  << "\n";
+    }
+    return failures() == 0 ? 0 : 1;
+}
+} // namespace Check
+
+#define TEST(name)                                                            \
+    static void name();                                                       \
+    static Check::Registrar name##Registrar(#name, name);                     \
+    static void name()
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond))                                                          \
+            Check::fail(__FILE__, __LINE__, "CHECK(" #cond ") failed");       \
+    } while (0)
+
+// Compares as long long so small integer types print as numbers
+#define CHECK_EQ(a, b)                                                        \
+    do {                                                                      \
+        long long va_ = (long long)(a), vb_ = (long long)(b);                 \
+        if (va_ != vb_) {                                                     \
+            std::cerr << #a " = " << va_ << ", " #b " = " << vb_ << "\n";     \
+            Check::fail(__FILE__, __LINE__,                                   \
+                        "CHECK_EQ(" #a ", " #b ") failed");                   \
+        }                                                                     \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                 \
+    do {                                                                      \
+        double va_ = (a), vb_ = (b);                                          \
+        if (va_ - vb_ > (tol) || vb_ - va_ > (tol)) {                         \
+            std::cerr << #a " = " << va_ << ", " #b " = " << vb_ << "\n";     \
+            Check::fail(__FILE__, __LINE__, "CHECK_NEAR failed");             \
+        }                                                                     \
+    } while (0)
+
+#define CHECK_MAIN()                                                          \
+    int main() { return Check::runAll(); }
+
+#endif
@@ -0,0 +1,225 @@
+// The clock screen through the compositor: what each new history sample
+// and each second costs on the SPI bus, against redrawing the whole graph
+// and the whole time, and that the incremental graph matches a full one.
+// Band rendering against drawing straight to the panel: the same pixels,
+// from a buffer of BAND_H rows and no heap.
+
+#include "AllocCounter.h"
+#include "AppModes.h"
+#include "Check.h"
+#include "Globals.h"
+#include "Graphics.h"
+#include "HostSim.h"
+#include "SettingsSchema.h"
+#include "TimeService.h"
+#include <vector>
+
+// Hardware.cpp, not in its header
+void recordHistory(float t, float h, uint16_t tvoc, uint16_t eco2);
+
+namespace {
+// What drawHistoryGraph() pushed for every sample before the compositor:
+// the whole 16-bit graph canvas
+const uint32_t FULL_GRAPH_BYTES = Layout::GRAPH_W * Layout::GRAPH_H * 2;
+
+uint32_t sampleNo = 0;
+bool steady = false;
+
+// Slow waves with a little jitter, inside the fixed ranges; or, once
+// steady, readings that do not move
+void addSample() {
+    sampleNo++;
+    int k = (int)(sampleNo % 200);
+    int tri = steady ? 50 : k < 100 ? k : 200 - k;
+    recordHistory(20.0f + tri * 0.05f, (float)(40 + tri / 5),
+                  (uint16_t)(200 + (steady ? 0 : (sampleNo * 37) % 60)),
+                  (uint16_t)(700 + tri * 8));
+}
+
+// Mean and worst bytes sent for n new samples
+void scrollCost(int n, uint32_t &mean, uint32_t &most) {
+    uint32_t total = 0;
+    most = 0;
+    for (int i = 0; i < n; i++) {
+        uint32_t before = compositor.bytesSent();
+        addSample();
+        uint32_t sent = compositor.bytesSent() - before;
+        total += sent;
+        most = sent > most ? sent : most;
+    }
+    mean = total / n;
+}
+
+std::vector<uint16_t> graphRows() {
+    const std::vector<uint16_t> &fb = tft.framebuffer();
+    return std::vector<uint16_t>(
+        fb.begin() + Layout::GRAPH_Y * tft.width(),
+        fb.begin() + (Layout::GRAPH_Y + Layout::GRAPH_H) * tft.width());
+}
+
+// Notes the largest address window, the most the band buffer ever held
+class WindowProbe : public Adafruit_ST7789 {
+  public:
+    uint32_t largest = 0;
+
+    WindowProbe() : Adafruit_ST7789(-1, -1, -1) {
+        init(Screen::HEIGHT, Screen::WIDTH);
+        setRotation(1);
+        fillScreen(Colors::BG);
+        largest = 0;
+    }
+    void setAddrWindow(uint16_t x, uint16_t y, uint16_t w,
+                       uint16_t h) override {
+        largest = w * h > largest ? w * h : largest;
+        Adafruit_SPITFT::setAddrWindow(x, y, w, h);
+    }
+};
+
+// A bitmap with something different in every pixel, and odd dimensions so
+// bands and rects end part way
+void pattern(GFXcanvas16 &image, uint16_t seed) {
+    for (int y = 0; y < image.height(); y++)
+        for (int x = 0; x < image.width(); x++)
+            image.drawPixel(x, y, (uint16_t)(seed + x * 31 + y * 2048));
+}
+
+// What drawRGBBitmap() sends
+void blit(Adafruit_ST7789 &panel, GFXcanvas16 &image, int16_t x, int16_t y) {
+    panel.startWrite();
+    panel.setAddrWindow(x, y, image.width(), image.height());
+    panel.writePixels(image.getBuffer(), image.width() * image.height());
+    panel.endWrite();
+}
+
+void setUp() {
+    tft.init(Screen::HEIGHT, Screen::WIDTH);
+    tft.setRotation(1);
+    Schema::applyDefaults(settings);
+    // Shortest range: every sample scrolls the graph by a column
+    settings.graphDuration = Graph::RANGES_MIN[0];
+    settings.graphAutoScale = false;
+    // Monday 2025-10-13 08:00 UTC
+    Host::setWallTime(1760342400);
+    env.history.clear();
+    env.graph.invalidate();
+    for (int i = 0; i < 400; i++)
+        addSample();
+    State.switchMode(Modes::Clock);
+    State.update();
+}
+} // namespace
+
+TEST(graphScrollSendsAFractionOfTheCanvas) {
+    setUp();
+    // A full redraw through the compositor sends about what the canvas did
+    drawHistoryGraph();
+    uint32_t full = compositor.lastFlushBytes();
+    CHECK(full >= FULL_GRAPH_BYTES);
+
+    // Only the rows between the highest and lowest trace are re-sent
+    uint32_t mean, most;
+    scrollCost(300, mean, most);
+    printf("graph, per sample: full canvas %u bytes, compositor %u mean, "
+           "%u worst\n",
+           FULL_GRAPH_BYTES, mean, most);
+    CHECK(most <= full);
+    CHECK(mean < FULL_GRAPH_BYTES * 3 / 4);
+
+    // Steady readings, once the swings have scrolled out, narrow that band
+    uint32_t moving = mean;
+    steady = true;
+    scrollCost(Layout::GRAPH_W, mean, most);
+    scrollCost(100, mean, most);
+    printf("graph, steady readings: %u bytes per sample\n", mean);
+    CHECK(mean < moving);
+    CHECK(mean < FULL_GRAPH_BYTES / 2);
+    steady = false;
+
+    // Scrolled a column at a time, the graph is what a full redraw draws
+    std::vector<uint16_t> scrolled = graphRows();
+    drawHistoryGraph();
+    CHECK(graphRows() == scrolled);
+}
+
+TEST(clockTickSendsOnlyTheChangedDigits) {
+    setUp();
+    // The time as the size-6 GFX text the clock used to print every second
+    tft.resetStats();
+    tft.setTextSize(6);
+    tft.setTextColor(ST77XX_WHITE, Colors::BG);
+    tft.setCursor(0, 10);
+    tft.print(Time.hms());
+    uint64_t printed = tft.stats().bytes;
+    State.switchMode(Modes::Clock);
+    State.update();
+
+    // A minute of ticks, the readings redrawn every fifth second
+    const int TICKS = 60;
+    tft.resetStats();
+    for (int i = 0; i < TICKS; i++) {
+        Host::advanceMs(1000);
+        Time.update();
+        State.update();
+    }
+    uint64_t perTick = tft.stats().bytes / TICKS;
+    printf("clock, per second: GFX text %llu bytes, screen %llu bytes\n",
+           (unsigned long long)printed, (unsigned long long)perTick);
+    CHECK(perTick > 0);
+    CHECK(perTick < printed / 4);
+}
+
+TEST(bandsDrawWhatDirectDrawingDoes) {
+    WindowProbe banded, direct;
+    Compositor bands(banded, Colors::BG);
+    GFXcanvas16 badgeImage(61, 23), logoImage(97, 45);
+    pattern(badgeImage, 7);
+    pattern(logoImage, 1234);
+    SpriteWidget badge(badgeImage), logo(logoImage);
+    const int16_t BADGE_X = 130, BADGE_Y = 100;
+    badge.moveTo(BADGE_X, BADGE_Y);
+    bands.addWidget(badge);
+    bands.addWidget(logo);
+    bands.markDirty(badge.bounds());
+    bands.flush();
+    blit(direct, badgeImage, BADGE_X, BADGE_Y);
+
+    // The logo bounces around the panel, passing over the badge
+    int16_t x = 0, y = 0, dx = 3, dy = 2;
+    int mismatched = 0;
+    uint32_t allocations;
+    {
+        AllocCounter::Scope count;
+        for (int frame = 0; frame < 500; frame++) {
+            DirtyRect old = logo.bounds();
+            if (x + dx < 0 || x + dx + logoImage.width() > Screen::WIDTH)
+                dx = -dx;
+            if (y + dy < 0 || y + dy + logoImage.height() > Screen::HEIGHT)
+                dy = -dy;
+            x += dx;
+            y += dy;
+            logo.moveTo(x, y);
+            bands.markDirty(old);
+            bands.markDirty(logo.bounds());
+            bands.flush();
+
+            // Erase, then redraw everything that was under the old place
+            direct.fillRect(old.x, old.y, old.w, old.h, Colors::BG);
+            blit(direct, badgeImage, BADGE_X, BADGE_Y);
+            blit(direct, logoImage, x, y);
+            mismatched += banded.framebuffer() != direct.framebuffer();
+        }
+        allocations = count.allocations();
+    }
+    CHECK_EQ(mismatched, 0);
+    CHECK_EQ(allocations, 0);
+
+    // Never more than a band in flight, against a whole-screen canvas
+    const uint32_t bandBytes = Screen::WIDTH * Compositor::BAND_H * 2;
+    printf("largest buffer: bands %u bytes (of %u), full screen %u, graph "
+           "canvas %u\n",
+           banded.largest * 2, bandBytes, Screen::WIDTH * Screen::HEIGHT * 2,
+           FULL_GRAPH_BYTES);
+    CHECK(banded.largest * 2 <= bandBytes);
+}
+
+CHECK_MAIN()
@@ -0,0 +1,211 @@
+// ConnectivityManager against the scripted WiFi and SNTP stand-ins: the
+// backoff schedule while the network is away, recovery when it returns and
+// when the link drops, suspend/resume, and SNTP corrections stepping or
+// slewing the clock and learning its drift.
+
+#include "Check.h"
+#include "Connectivity.h"
+#include "HostSim.h"
+#include <WiFi.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+typedef ConnectivityManager CM;
+
+// Real time as the SNTP server sees it
+const time_t SERVER_T0 = 1760000000;
+uint64_t serverBaseUs = 0;
+
+int64_t serverUs() {
+    return (int64_t)SERVER_T0 * 1000000 + (int64_t)(Host::nowUs() -
+                                                    serverBaseUs);
+}
+
+int64_t wallUs() {
+    struct timeval tv = Host::wallTime();
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+// Server time minus the device's clock
+int64_t offsetUs() { return serverUs() - wallUs(); }
+
+void deliver() {
+    int64_t us = serverUs();
+    Host::sntpDeliver(us / 1000000, us % 1000000);
+}
+
+void reset() {
+    Network = ConnectivityManager();
+    Host::setWifiAvailable(true);
+    Host::setWifiConnectMs(2000);
+    Host::setWallDriftPpm(0);
+}
+
+// The scheduler runs update() every 250 ms
+std::vector<uint32_t> attempts;
+void runFor(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += 250) {
+        Host::advanceMs(250);
+        int before = Host::wifiBeginCount();
+        Network.update();
+        if (Host::wifiBeginCount() != before)
+            attempts.push_back(millis());
+    }
+}
+} // namespace
+
+TEST(retriesBackOffExponentially) {
+    reset();
+    Host::setWifiAvailable(false);
+    attempts.clear();
+    uint32_t start = millis();
+    Network.begin();
+    attempts.push_back(start);
+    CHECK_EQ(Network.state(), NET_CONNECTING);
+    runFor(3 * 3600 * 1000UL);
+
+    // Each attempt times out, then waits 5 s, 10 s, 20 s, ... up to 10 min
+    uint32_t expect = start, backoff = CM::BACKOFF_MIN_MS;
+    int bad = 0;
+    for (size_t i = 0; i < attempts.size(); i++) {
+        bad += attempts[i] != expect;
+        expect += CM::CONNECT_TIMEOUT_MS + backoff;
+        backoff = std::min(backoff * 2, CM::BACKOFF_MAX_MS);
+    }
+    CHECK_EQ(bad, 0);
+    // 8 attempts to reach the cap, then one per 10 min 15 s
+    CHECK(attempts.size() >= 20);
+    CHECK(!Network.online());
+    CHECK(!Network.synced());
+}
+
+TEST(comesOnlineWhenTheNetworkReturns) {
+    reset();
+    Host::setWifiAvailable(false);
+    attempts.clear();
+    Network.begin();
+    runFor(5 * 60 * 1000UL);
+    CHECK_EQ(Network.state(), NET_BACKOFF);
+    int failed = (int)attempts.size();
+
+    Host::setWifiAvailable(true);
+    // Picked up by the next attempt, however long the backoff has grown
+    runFor(CM::BACKOFF_MAX_MS + CM::CONNECT_TIMEOUT_MS);
+    CHECK(Network.online());
+    CHECK_EQ((int)attempts.size(), failed + 1);
+    CHECK(Host::sntpStarted());
+    CHECK_EQ(Host::sntpIntervalMs(), CM::SNTP_INTERVAL_MS);
+
+    // The link drops: one immediate retry, then the backoff starts over
+    int restarts = Host::sntpRestartCount();
+    Host::setWifiAvailable(false);
+    attempts.clear();
+    runFor(250);
+    CHECK_EQ(attempts.size(), 1);
+    CHECK_EQ(Network.state(), NET_CONNECTING);
+    runFor(CM::CONNECT_TIMEOUT_MS + CM::BACKOFF_MIN_MS);
+    CHECK_EQ(attempts.size(), 2);
+    CHECK_EQ(attempts[1] - attempts[0],
+             CM::CONNECT_TIMEOUT_MS + CM::BACKOFF_MIN_MS);
+
+    // Back again during the second attempt, which already failed to
+    // join; the third connects. SNTP is asked at once rather than in an
+    // hour.
+    Host::setWifiAvailable(true);
+    runFor(CM::CONNECT_TIMEOUT_MS + 2 * CM::BACKOFF_MIN_MS + 5000);
+    CHECK(Network.online());
+    CHECK_EQ(Host::sntpRestartCount(), restarts + 1);
+}
+
+TEST(suspendLeavesTheRadioAlone) {
+    reset();
+    Network.begin();
+    runFor(3000);
+    CHECK(Network.online());
+    Network.suspend();
+    Host::setWifiAvailable(false);
+    attempts.clear();
+    runFor(CM::BACKOFF_MAX_MS * 2);
+    CHECK_EQ(Network.state(), NET_SUSPENDED);
+    CHECK_EQ(attempts.size(), 0);
+
+    // The portal connected while it had the radio
+    Host::setWifiAvailable(true);
+    Host::setWifiConnectMs(0);
+    WiFi.begin();
+    Network.resume();
+    CHECK(Network.online());
+    // resume() outside suspension is a no-op
+    Network.resume();
+    CHECK(Network.online());
+}
+
+TEST(firstSyncStepsThenCorrectionsSlew) {
+    reset();
+    serverBaseUs = Host::nowUs();
+    // The fallback clock: 2024-01-01 12:00
+    Host::setWallTime(1704110400);
+    Network.begin();
+    runFor(3000);
+    CHECK(!Network.synced());
+    deliver();
+    CHECK(Network.synced());
+    CHECK(offsetUs() == 0);
+    CHECK_EQ(Host::wallPendingUs(), 0);
+
+    // A clock 400 ms behind is slewed, not stepped
+    runFor(60000);
+    int64_t behind = serverUs() - 400000;
+    Host::setWallTime(behind / 1000000, behind % 1000000);
+    int64_t before = offsetUs();
+    CHECK_NEAR(before, 400000, 10);
+    int64_t wallBefore = wallUs();
+    deliver();
+    CHECK(wallUs() - wallBefore < 1000); // no jump
+    CHECK_NEAR(Host::wallPendingUs(), before, 10);
+    // ESP-IDF slews at 1/64, so it is gone after 64 times the offset
+    runFor((uint32_t)(before * 64 / 1000) + 1000);
+    CHECK(offsetUs() < 1000 && offsetUs() > -1000);
+
+    // Offsets past the limit are stepped
+    Host::setWallTime(wallUs() / 1000000 + 5);
+    deliver();
+    CHECK(offsetUs() < 1000 && offsetUs() > -1000);
+}
+
+TEST(driftIsLearnedAndCompensated) {
+    reset();
+    serverBaseUs = Host::nowUs();
+    Host::setWallTime(SERVER_T0 - 86400);
+    // The RTC runs 50 ppm fast: 180 ms an hour
+    Host::setWallDriftPpm(50);
+    Network.begin();
+    runFor(3000);
+    deliver();
+    CHECK_NEAR(Network.driftPpm(), 0, 1e-6);
+
+    // Syncs close together are not used for the estimate
+    runFor(60000);
+    deliver();
+    CHECK_NEAR(Network.driftPpm(), 0, 1e-6);
+
+    std::vector<int64_t> offsets;
+    for (int hour = 0; hour < 8; hour++) {
+        runFor(CM::SNTP_INTERVAL_MS);
+        offsets.push_back(offsetUs());
+        deliver();
+    }
+    printf("offset before each hourly sync (us):");
+    for (int64_t o : offsets)
+        printf(" %lld", (long long)o);
+    printf("\ndrift estimate %.2f ppm\n", Network.driftPpm());
+
+    CHECK_NEAR(offsets[0], -180000, 5000);
+    CHECK_NEAR(Network.driftPpm(), -50, 2);
+    // Compensation between syncs shrinks the error a sync has to fix
+    int64_t last = offsets.back() < 0 ? -offsets.back() : offsets.back();
+    CHECK(last * 10 < 180000);
+}
+
+CHECK_MAIN()
@@ -0,0 +1,185 @@
+// A menu frame drawn through DrawList against the same frame drawn with
+// direct GFX calls: the pixels agree and far fewer address windows and
+// transactions go out. Then a list too long for the screen, scrolled a
+// step at a time.
+
+#include "Check.h"
+#include "Globals.h"
+#include "Graphics.h"
+#include "SettingsSchema.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+const int ITEMS = 5;
+const char *labels[ITEMS] = {"Monitor", "Pomodoro", "Alarm", "DVD",
+                             "Settings"};
+
+// drawListItem() as it was, one GFX call per primitive
+void directItem(int row, bool selected, const char *label) {
+    int y = Layout::LIST_Y + row * Layout::LIST_PITCH;
+    uint16_t box = selected ? Colors::ACCENT : Colors::BG;
+    tft.fillRect(10, y - 14, 300, 28, box);
+    tft.setTextSize(2);
+    tft.setTextColor(selected ? Colors::BG : ST77XX_WHITE, box);
+    tft.setCursor(24, y - 7);
+    tft.print(label);
+}
+
+void directFrame(int selected, int last, bool full) {
+    if (full)
+        UI::clear();
+    for (int i = 0; i < ITEMS; i++)
+        if (full || i == selected || i == last)
+            directItem(i, i == selected, labels[i]);
+}
+
+void listFrame(int selected, int last, bool full) {
+    int top = 0;
+    drawGenericList(labels, ITEMS, selected, last, full, top);
+}
+
+struct Cost {
+    Adafruit_SPITFT::Stats stats;
+    std::vector<uint16_t> pixels;
+};
+
+Cost measure(void (*frame)(int, int, bool), int selected, int last,
+             bool full) {
+    tft.resetStats();
+    frame(selected, last, full);
+    Cost c = {tft.stats(), tft.framebuffer()};
+    return c;
+}
+
+// Scrollbar geometry as drawListScrollbar() lays it out
+const int BAR_X = 313;
+const int BAR_Y = Layout::LIST_Y - 14;
+const int BAR_H = (Layout::LIST_ROWS - 1) * Layout::LIST_PITCH + 28;
+
+int thumbHeight(int count) {
+    return std::max(8, BAR_H * Layout::LIST_ROWS / count);
+}
+
+// Top row of the thumb as it is on the panel
+int thumbOnScreen() {
+    for (int y = BAR_Y; y < BAR_Y + BAR_H; y++)
+        if (tft.pixel(BAR_X + 1, y) == Colors::LIGHT)
+            return y;
+    return -1;
+}
+
+void report(const char *what, const Cost &direct, const Cost &list) {
+    printf("%-14s direct %5u windows %4u transactions, "
+           "DrawList %3u windows %2u transactions\n",
+           what, (unsigned)direct.stats.windows,
+           (unsigned)direct.stats.transactions, (unsigned)list.stats.windows,
+           (unsigned)list.stats.transactions);
+}
+} // namespace
+
+TEST(menuFrameTakesFewerWindows) {
+    tft.init(Screen::HEIGHT, Screen::WIDTH);
+    tft.setRotation(1);
+    Schema::applyDefaults(settings);
+
+    // The whole menu
+    Cost direct = measure(directFrame, 1, -1, true);
+    Cost list = measure(listFrame, 1, -1, true);
+    report("full menu", direct, list);
+    CHECK(list.pixels == direct.pixels);
+    CHECK(list.stats.windows * 10 < direct.stats.windows);
+    CHECK(list.stats.transactions < direct.stats.transactions);
+    // One window per row box and label, plus the clear and the alarm icon
+    CHECK(list.stats.windows <= 2 * ITEMS + 2);
+
+    // The selection moving down a row repaints two rows
+    direct = measure(directFrame, 2, 1, false);
+    list = measure(listFrame, 2, 1, false);
+    report("selection move", direct, list);
+    CHECK(list.pixels == direct.pixels);
+    CHECK_EQ(list.stats.windows, 4);
+    CHECK_EQ(list.stats.transactions, 1);
+    CHECK(list.stats.windows * 10 < direct.stats.windows);
+    CHECK_EQ(drawList.lastFlushWindows(), list.stats.windows);
+}
+
+TEST(longListScrollsAStepAtATime) {
+    tft.init(Screen::HEIGHT, Screen::WIDTH);
+    tft.setRotation(1);
+    const int COUNT = 12;
+    const char *items[COUNT] = {"One",   "Two",   "Three",  "Four",
+                                "Five",  "Six",   "Seven",  "Eight",
+                                "Nine",  "Ten",   "Eleven", "Twelve"};
+    const int ROWS = Layout::LIST_ROWS;
+    const int thumbH = thumbHeight(COUNT);
+    int top = 0;
+    drawGenericList(items, COUNT, 0, -1, true, top);
+    CHECK_EQ(top, 0);
+    CHECK_EQ(thumbOnScreen(), BAR_Y);
+
+    // Down to the end, back up past the top, then wrap to the end
+    std::vector<int> path;
+    for (int i = 1; i < COUNT; i++)
+        path.push_back(i);
+    for (int i = COUNT - 2; i >= 0; i--)
+        path.push_back(i);
+    path.push_back(COUNT - 1);
+
+    // A row's box, then its label over it, at most six size-2 characters
+    const uint64_t boxBytes = 300 * 28 * 2;
+    const uint64_t rowBytes = boxBytes + 6 * 12 * 16 * 2;
+    const uint64_t barBytes = 3 * BAR_H * 2;
+    // Address windows, generously
+    const uint64_t slack = 32 * Adafruit_SPITFT::WINDOW_BYTES;
+    int last = 0, wrongTop = 0, wrongThumb = 0, wrongPixels = 0;
+    uint64_t moveMost = 0, scrollLeast = ~0ULL, scrollMost = 0;
+    int scrolls = 0;
+    for (int sel : path) {
+        int oldTop = top;
+        tft.resetStats();
+        drawGenericList(items, COUNT, sel, last, false, top);
+        uint64_t bytes = tft.stats().bytes;
+
+        // Just far enough to keep the selection on screen
+        int expectTop = oldTop;
+        if (sel < oldTop)
+            expectTop = sel;
+        else if (sel >= oldTop + ROWS)
+            expectTop = sel - ROWS + 1;
+        wrongTop += top != expectTop;
+        int thumbY = BAR_Y + (BAR_H - thumbH) * top / (COUNT - ROWS);
+        wrongThumb += thumbOnScreen() != thumbY;
+
+        if (top == oldTop) {
+            // Two rows: the old selection and the new
+            moveMost = std::max(moveMost, bytes);
+        } else {
+            // Every row, and the bar
+            scrollLeast = std::min(scrollLeast, bytes);
+            scrollMost = std::max(scrollMost, bytes);
+            scrolls++;
+        }
+
+        // The same as drawing the list afresh there
+        std::vector<uint16_t> stepped = tft.framebuffer();
+        int sameTop = top;
+        drawGenericList(items, COUNT, sel, -1, true, sameTop);
+        wrongPixels += tft.framebuffer() != stepped;
+        last = sel;
+    }
+    printf("list of %d, %d rows: selection move %llu bytes at most, "
+           "scroll %llu at least\n",
+           COUNT, ROWS, (unsigned long long)moveMost,
+           (unsigned long long)scrollLeast);
+    CHECK_EQ(wrongTop, 0);
+    CHECK_EQ(wrongThumb, 0);
+    CHECK_EQ(wrongPixels, 0);
+    // Down 7, up 7 and the wrap to the end
+    CHECK_EQ(scrolls, 2 * (COUNT - ROWS) + 1);
+    CHECK(moveMost > 2 * boxBytes && moveMost <= 2 * rowBytes + slack);
+    CHECK(scrollLeast > ROWS * boxBytes + barBytes);
+    CHECK(scrollMost <= ROWS * rowBytes + barBytes + slack);
+}
+
+CHECK_MAIN()
@@ -0,0 +1,187 @@
+// EventQueue hammered from a producer thread standing in for the ISRs,
+// and InputManager fed through the pin interrupt stand-ins.
+
+#include "Check.h"
+#include "EventQueue.h"
+#include "Globals.h"
+#include "HostSim.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Item {
+    uint32_t seq;
+    uint32_t check; // ~seq, to catch torn copies
+};
+
+void pressKey(bool down) { Host::setPin(Pins::KEY0, down ? LOW : HIGH); }
+
+// One detent clockwise from the resting 11 state: 11 01 00 10 11
+void turnClockwise() {
+    Host::setPin(Pins::ENC_A, LOW);
+    Host::setPin(Pins::ENC_B, LOW);
+    Host::setPin(Pins::ENC_A, HIGH);
+    Host::setPin(Pins::ENC_B, HIGH);
+}
+
+void turnCounterClockwise() {
+    Host::setPin(Pins::ENC_B, LOW);
+    Host::setPin(Pins::ENC_A, LOW);
+    Host::setPin(Pins::ENC_B, HIGH);
+    Host::setPin(Pins::ENC_A, HIGH);
+}
+
+std::vector<InputEvent> drain() {
+    Input.update();
+    std::vector<InputEvent> out;
+    InputEvent ev;
+    while (Input.poll(ev))
+        out.push_back(ev);
+    return out;
+}
+
+int countType(const std::vector<InputEvent> &evs, InputEventType t) {
+    int n = 0;
+    for (const InputEvent &e : evs)
+        n += e.type == t;
+    return n;
+}
+} // namespace
+
+TEST(fullQueueDropsAndCounts) {
+    EventQueue<Item, 8> q;
+    for (uint32_t i = 0; i < 8; i++)
+        CHECK(q.push({i, ~i}));
+    CHECK(!q.push({8, ~8u}));
+    CHECK_EQ(q.droppedCount(), 1);
+    Item it;
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK(q.pop(it));
+        CHECK_EQ(it.seq, i);
+    }
+    CHECK(!q.pop(it));
+    CHECK(q.empty());
+}
+
+TEST(producerThreadHammersConsumer) {
+    const uint32_t TOTAL = 2000000;
+    static EventQueue<Item, 64> q;
+    std::atomic<bool> done{false};
+    uint32_t accepted = 0;
+
+    std::thread isr([&] {
+        for (uint32_t i = 0; i < TOTAL; i++)
+            if (q.push({i, ~i}))
+                accepted++;
+        done = true;
+    });
+
+    uint32_t popped = 0;
+    int64_t last = -1;
+    bool ordered = true, intact = true;
+    Item it;
+    for (;;) {
+        bool finished = done.load();
+        while (q.pop(it)) {
+            ordered &= (int64_t)it.seq > last;
+            intact &= it.check == ~it.seq;
+            last = it.seq;
+            popped++;
+        }
+        if (finished && q.empty())
+            break;
+    }
+    isr.join();
+
+    CHECK(ordered);
+    CHECK(intact);
+    CHECK_EQ(popped, accepted);
+    // The drop counter is 16 bits wide
+    CHECK_EQ((uint16_t)(accepted + q.droppedCount()), (uint16_t)TOTAL);
+    // The indices wrapped many times
+    CHECK(popped > 256);
+}
+
+TEST(encoderDetentsBecomeRotation) {
+    Input.begin();
+    drain();
+    turnClockwise();
+    Host::advanceMs(200);
+    turnClockwise();
+    std::vector<InputEvent> evs = drain();
+    CHECK_EQ(evs.size(), 1); // coalesced into one event per update
+    CHECK_EQ(evs[0].type, EV_ROTATE);
+    CHECK_EQ(evs[0].steps, 2);
+    CHECK_EQ(evs[0].accel, 2); // too slow to accelerate
+
+    Host::advanceMs(200);
+    for (int i = 0; i < 4; i++) {
+        turnCounterClockwise();
+        Host::advanceMs(10);
+    }
+    evs = drain();
+    CHECK_EQ(evs.size(), 1);
+    CHECK_EQ(evs[0].steps, -4);
+    CHECK(evs[0].accel < -4);
+}
+
+TEST(buttonEdgesAreDebounced) {
+    Input.begin();
+    Host::advanceMs(1000);
+    drain();
+    pressKey(true);
+    Host::advanceMs(5);
+    pressKey(false); // bounce, inside the debounce window
+    pressKey(true);
+    std::vector<InputEvent> evs = drain();
+    CHECK_EQ(countType(evs, EV_PRESS), 1);
+    CHECK_EQ(countType(evs, EV_RELEASE), 0);
+    Host::advanceMs(100);
+    pressKey(false);
+    evs = drain();
+    CHECK_EQ(countType(evs, EV_RELEASE), 1);
+}
+
+TEST(twoPressesBetweenFramesAreNotMerged) {
+    Input.begin();
+    Host::advanceMs(1000);
+    drain();
+    for (int i = 0; i < 2; i++) {
+        pressKey(true);
+        Host::advanceMs(50);
+        pressKey(false);
+        Host::advanceMs(50);
+    }
+    std::vector<InputEvent> evs = drain();
+    CHECK_EQ(countType(evs, EV_PRESS), 2);
+    CHECK_EQ(countType(evs, EV_RELEASE), 2);
+    CHECK_EQ(countType(evs, EV_DOUBLE_CLICK), 1);
+    for (const InputEvent &e : evs)
+        CHECK_EQ(e.button, BTN_BACK);
+}
+
+TEST(holdingReportsOneLongPress) {
+    Input.begin();
+    Host::advanceMs(1000);
+    drain();
+    pressKey(true);
+    int longPresses = 0;
+    for (int t = 0; t < 1500; t += 10) {
+        longPresses += countType(drain(), EV_LONG_PRESS);
+        Host::advanceMs(10);
+    }
+    pressKey(false);
+    std::vector<InputEvent> evs = drain();
+    CHECK_EQ(longPresses, 1);
+    CHECK_EQ(countType(evs, EV_RELEASE), 1);
+    // A long press does not arm a double click
+    Host::advanceMs(100);
+    pressKey(true);
+    CHECK_EQ(countType(drain(), EV_DOUBLE_CLICK), 0);
+    Host::advanceMs(100);
+    pressKey(false);
+    drain();
+}
+
+CHECK_MAIN()
@@ -0,0 +1,99 @@
+// The big clock digits from the glyph atlas against GFX text at size 6:
+// the same pixels for every character and every second, and what a
+// second-tick costs in SPI bytes, address windows and CPU time.
+
+#include "Check.h"
+#include "Globals.h"
+#include "GlyphAtlas.h"
+#include <chrono>
+#include <cstdio>
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+const uint16_t FG = ST77XX_WHITE;
+
+void setUpPanel(Adafruit_ST7789 &panel) {
+    panel.init(Screen::HEIGHT, Screen::WIDTH);
+    panel.setRotation(1);
+    panel.fillScreen(Colors::BG);
+    panel.resetStats();
+}
+
+// HH:MM:SS for a second of the day
+void hms(char *buf, size_t size, uint32_t s) {
+    s %= 86400;
+    snprintf(buf, size, "%02u:%02u:%02u", (unsigned)(s / 3600),
+             (unsigned)(s / 60 % 60), (unsigned)(s % 60));
+}
+} // namespace
+
+TEST(glyphsMatchGfxText) {
+    Adafruit_ST7789 gfx(-1, -1, -1);
+    setUpPanel(tft);
+    setUpPanel(gfx);
+    const char chars[] = "0123456789:- ";
+    for (int i = 0; chars[i] != '\0'; i++) {
+        int16_t x = (i % 8) * GlyphAtlas::CELL_W;
+        int16_t y = (i / 8) * GlyphAtlas::CELL_H;
+        // Alternate colours, so background pixels are checked too
+        uint16_t fg = i % 2 ? FG : Colors::ACCENT;
+        uint16_t bg = i % 2 ? Colors::BG : Colors::DARK;
+        GlyphAtlas::drawChar(tft, x, y, chars[i], fg, bg);
+        gfx.drawChar(x, y, chars[i], fg, bg, GlyphAtlas::SCALE);
+    }
+    CHECK(tft.framebuffer() == gfx.framebuffer());
+
+    // Anything not in the atlas is a blank cell
+    GlyphAtlas::drawChar(tft, 0, 150, 'A', FG, Colors::BG);
+    gfx.fillRect(0, 150, GlyphAtlas::CELL_W, GlyphAtlas::CELL_H, Colors::BG);
+    CHECK(tft.framebuffer() == gfx.framebuffer());
+}
+
+TEST(secondTicksMatchAndCostLess) {
+    Adafruit_ST7789 gfx(-1, -1, -1);
+    setUpPanel(tft);
+    setUpPanel(gfx);
+    BigText clock;
+    const int16_t Y = 10;
+    // From a minute before midnight, so every digit rolls over
+    const uint32_t START = 86400 - 60;
+    const int TICKS = 3600;
+
+    typedef std::chrono::duration<double, std::micro> Us;
+    Us atlasTime(0), gfxTime(0);
+    int mismatched = 0;
+    char buf[12];
+    for (int i = 0; i < TICKS; i++) {
+        hms(buf, sizeof(buf), START + i);
+        Clock::time_point t0 = Clock::now();
+        clock.drawCentered(buf, Y, FG, Colors::BG);
+        Clock::time_point t1 = Clock::now();
+        // What drawClockTime() did before the atlas
+        gfx.setTextSize(6);
+        gfx.setTextColor(FG, Colors::BG);
+        gfx.setCursor((Screen::WIDTH - 8 * GlyphAtlas::CELL_W) / 2, Y);
+        gfx.print(buf);
+        Clock::time_point t2 = Clock::now();
+        atlasTime += t1 - t0;
+        gfxTime += t2 - t1;
+        mismatched += tft.framebuffer() != gfx.framebuffer();
+    }
+    CHECK_EQ(mismatched, 0);
+
+    const Adafruit_SPITFT::Stats &a = tft.stats();
+    const Adafruit_SPITFT::Stats &g = gfx.stats();
+    printf("per second-tick over %d ticks:\n", TICKS);
+    printf("  %-12s %8.1f us %8.1f windows %8llu bytes\n", "GFX size 6",
+           gfxTime.count() / TICKS, (double)g.windows / TICKS,
+           (unsigned long long)(g.bytes / TICKS));
+    printf("  %-12s %8.1f us %8.1f windows %8llu bytes\n", "glyph atlas",
+           atlasTime.count() / TICKS, (double)a.windows / TICKS,
+           (unsigned long long)(a.bytes / TICKS));
+    // Mostly one changed digit a second, sent as one window
+    CHECK(a.windows < 2 * TICKS);
+    CHECK(a.bytes * 4 < g.bytes);
+    CHECK(a.windows * 100 < g.windows);
+}
+
+CHECK_MAIN()
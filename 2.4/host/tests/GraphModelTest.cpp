@@ -0,0 +1,272 @@
+// GraphModel scaling against the map()/constrain() it replaced, the
+// incremental model against a full reload, autoscaling, a golden image of
+// the rendered graph and the per-redraw cost.
+
+#include "Check.h"
+#include "Globals.h"
+#include "Graphics.h"
+#include "GraphModel.h"
+#include "HostSim.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+const uint16_t FIXED_LO[HIST_CHANNELS] = {100, 0, 0, 400};
+const uint16_t FIXED_HI[HIST_CHANNELS] = {400, 100, 1500, 2000};
+
+// 0..amp..0 over period samples
+int triangle(uint32_t n, int period, int amp) {
+    int k = (int)(n % period);
+    return 2 * amp * (k < period / 2 ? k : period - k) / period;
+}
+
+// Deterministic integer traces (so the golden image does not depend on
+// libm) that cross the fixed ranges, so clamping shows too
+void sampleAt(uint32_t n, uint16_t values[HIST_CHANNELS]) {
+    values[HIST_TEMP] = (uint16_t)(20 + triangle(n, 480, 420));
+    values[HIST_HUM] = (uint16_t)(15 + triangle(n + 100, 300, 60));
+    values[HIST_TVOC] = (uint16_t)(n % 97 == 0 ? 1800 : 150 + (n * 7) % 300);
+    values[HIST_CO2] = (uint16_t)(300 + triangle(n, 1250, 1200));
+}
+
+uint8_t feed(HistoryPyramid &hist, uint32_t n) {
+    uint16_t values[HIST_CHANNELS];
+    sampleAt(n, values);
+    return hist.add(values);
+}
+
+bool samePoints(const GraphModel &a, const GraphModel &b) {
+    for (int i = 0; i < GraphModel::LEN; i++)
+        for (int c = 0; c < HIST_CHANNELS; c++)
+            if (a.at(i).mean[c] != b.at(i).mean[c] ||
+                a.at(i).top[c] != b.at(i).top[c] ||
+                a.at(i).bot[c] != b.at(i).bot[c])
+                return false;
+    return true;
+}
+
+uint32_t fnv1a(const std::vector<uint16_t> &fb, int width, int y0, int h) {
+    uint32_t hash = 2166136261u;
+    for (int y = y0; y < y0 + h; y++)
+        for (int x = 0; x < width; x++) {
+            uint16_t c = fb[(size_t)y * width + x];
+            hash = (hash ^ (c & 0xFF)) * 16777619u;
+            hash = (hash ^ (c >> 8)) * 16777619u;
+        }
+    return hash;
+}
+
+// The graph as drawn before GraphModel: map(constrain()) per point on
+// every redraw and a Bresenham line per segment.
+void legacyRedraw(const HistoryPyramid &hist, int level) {
+    const uint16_t colors[HIST_CHANNELS] = {Colors::TEMP, Colors::HUM,
+                                            Colors::TVOC, Colors::CO2};
+    tft.fillRect(Layout::GRAPH_X, Layout::GRAPH_Y, Layout::GRAPH_W,
+                 Layout::GRAPH_H, Colors::BG);
+    for (int c = 0; c < HIST_CHANNELS; c++) {
+        int prevY = 0;
+        for (int i = 0; i < GraphModel::LEN; i++) {
+            long v = constrain((long)hist.at(level, c, i).mean, FIXED_LO[c],
+                               FIXED_HI[c]);
+            int y = Layout::GRAPH_Y +
+                    map(v, FIXED_LO[c], FIXED_HI[c], GraphModel::Y_BOT,
+                        GraphModel::Y_TOP);
+            if (i > 0)
+                tft.drawLine(Layout::GRAPH_X + i - 1, prevY,
+                             Layout::GRAPH_X + i, y, colors[c]);
+            prevY = y;
+        }
+    }
+}
+
+// Hash of the graph area for the traces above after GOLDEN_SAMPLES at the
+// 5 minute range with fixed scales. If the rendering changes on purpose,
+// look at the graph-actual.ppm the test writes and update the value.
+const uint32_t GOLDEN_SAMPLES = 1000;
+const uint32_t GOLDEN_HASH = 0x4810a9e4;
+} // namespace
+
+TEST(fixedScaleMatchesMap) {
+    static HistoryPyramid hist;
+    static GraphModel model;
+    hist.clear();
+    for (uint32_t n = 0; n < 2 * GraphModel::LEN; n++)
+        feed(hist, n);
+    model.select(hist, 0, false);
+    for (int c = 0; c < HIST_CHANNELS; c++) {
+        CHECK_EQ(model.rangeLo(c), FIXED_LO[c]);
+        CHECK_EQ(model.rangeHi(c), FIXED_HI[c]);
+    }
+    int worst = 0;
+    for (int i = 0; i < GraphModel::LEN; i++)
+        for (int c = 0; c < HIST_CHANNELS; c++) {
+            HistBucket b = hist.at(0, c, i);
+            long v = constrain((long)b.mean, FIXED_LO[c], FIXED_HI[c]);
+            long ref = map(v, FIXED_LO[c], FIXED_HI[c], GraphModel::Y_BOT,
+                           GraphModel::Y_TOP);
+            int got = model.at(i).mean[c];
+            worst = std::max(worst, (int)std::labs(got - ref));
+            CHECK(got >= GraphModel::Y_TOP && got <= GraphModel::Y_BOT);
+            CHECK(model.at(i).top[c] <= got && got <= model.at(i).bot[c]);
+        }
+    // The truncated 16.16 factor can land a row below map()'s
+    CHECK(worst <= 1);
+}
+
+TEST(incrementalMatchesFullReload) {
+    static HistoryPyramid hist;
+    static GraphModel live, fresh;
+    for (int autoScale = 0; autoScale < 2; autoScale++) {
+        for (int level = 0; level < 3; level++) {
+            hist.clear();
+            live.invalidate();
+            live.select(hist, level, autoScale);
+            int shifted = 0, rescaled = 0, mismatches = 0;
+            for (uint32_t n = 0; n < 3000; n++) {
+                GraphChange change = live.onAdd(hist, feed(hist, n));
+                shifted += change == GRAPH_SHIFTED;
+                rescaled += change == GRAPH_RESCALED;
+                if (change == GRAPH_UNCHANGED || n % 7 != 0)
+                    continue;
+                fresh.invalidate();
+                fresh.select(hist, level, autoScale);
+                mismatches += !samePoints(live, fresh);
+            }
+            fresh.invalidate();
+            fresh.select(hist, level, autoScale);
+            CHECK_EQ(mismatches, 0);
+            CHECK(samePoints(live, fresh));
+            // Level 0 closes a bucket per sample, level 1 every third,
+            // level 2 every sixth
+            const int every[] = {1, 3, 6};
+            CHECK_EQ(shifted + rescaled, 3000 / every[level]);
+            if (!autoScale)
+                CHECK_EQ(rescaled, 0);
+        }
+    }
+}
+
+TEST(onlyTheShownLevelMovesTheGraph) {
+    static HistoryPyramid hist;
+    static GraphModel model;
+    hist.clear();
+    model.invalidate();
+    // Nothing is shown yet
+    CHECK_EQ(model.onAdd(hist, feed(hist, 0)), GRAPH_UNCHANGED);
+    model.select(hist, 1, false);
+    CHECK_EQ(model.level(), 1);
+    CHECK_EQ(model.onAdd(hist, feed(hist, 1)), GRAPH_UNCHANGED);
+    CHECK_EQ(model.onAdd(hist, feed(hist, 2)), GRAPH_SHIFTED);
+    GraphPoint newest = model.at(GraphModel::LEN - 1);
+    for (uint32_t n = 3; n < 6; n++)
+        model.onAdd(hist, feed(hist, n));
+    CHECK_EQ(model.at(GraphModel::LEN - 2).mean[HIST_CO2],
+             newest.mean[HIST_CO2]);
+}
+
+TEST(autoscaleFollowsTheVisibleWindow) {
+    static HistoryPyramid hist;
+    static GraphModel model;
+    hist.clear();
+    model.invalidate();
+    model.select(hist, 0, true);
+    uint16_t values[HIST_CHANNELS] = {215, 40, 120, 800};
+    for (int i = 0; i < 10; i++)
+        model.onAdd(hist, hist.add(values));
+    // A flat trace gets the minimum span, centred and on the step grid
+    CHECK_EQ(model.rangeLo(HIST_CO2), 700);
+    CHECK_EQ(model.rangeHi(HIST_CO2), 900);
+    CHECK_EQ(model.rangeLo(HIST_TEMP), 200);
+    CHECK_EQ(model.rangeHi(HIST_TEMP), 230);
+    CHECK_NEAR(model.at(GraphModel::LEN - 1).mean[HIST_CO2],
+               (GraphModel::Y_TOP + GraphModel::Y_BOT) / 2, 1);
+
+    values[HIST_CO2] = 1510;
+    CHECK_EQ(model.onAdd(hist, hist.add(values)), GRAPH_RESCALED);
+    CHECK_EQ(model.rangeHi(HIST_CO2), 1550);
+    // 1510 sits 810 of the 850 ppm span above the 700 ppm floor
+    CHECK_NEAR(model.at(GraphModel::LEN - 1).top[HIST_CO2],
+               GraphModel::Y_BOT -
+                   (GraphModel::Y_BOT - GraphModel::Y_TOP) * 810 / 850,
+               1);
+
+    // The spike scrolls out after LEN buckets and the range closes again
+    values[HIST_CO2] = 800;
+    int rescales = 0;
+    for (int i = 0; i < GraphModel::LEN; i++)
+        rescales += model.onAdd(hist, hist.add(values)) == GRAPH_RESCALED;
+    CHECK_EQ(rescales, 1);
+    CHECK_EQ(model.rangeHi(HIST_CO2), 900);
+
+    // Locking the ranges switches back to the fixed scales
+    model.select(hist, 0, false);
+    CHECK_EQ(model.rangeLo(HIST_CO2), 400);
+    CHECK_EQ(model.rangeHi(HIST_CO2), 2000);
+}
+
+TEST(renderedGraphMatchesGolden) {
+    tft.init(Screen::HEIGHT, Screen::WIDTH);
+    tft.setRotation(1);
+    tft.fillScreen(Colors::BG);
+    env.history.clear();
+    for (uint32_t n = 0; n < GOLDEN_SAMPLES; n++)
+        feed(env.history, n);
+    settings.graphDuration = Graph::RANGES_MIN[0];
+    settings.graphAutoScale = false;
+    env.graph.invalidate();
+    compositor.clearWidgets();
+    drawHistoryGraph();
+
+    uint32_t hash = fnv1a(tft.framebuffer(), tft.width(), Layout::GRAPH_Y,
+                          Layout::GRAPH_H);
+    if (hash != GOLDEN_HASH) {
+        printf("graph hash 0x%08x, expected 0x%08x; see graph-actual.ppm\n",
+               hash, GOLDEN_HASH);
+        tft.writePpm("graph-actual.ppm");
+    }
+    CHECK_EQ(hash, GOLDEN_HASH);
+}
+
+TEST(redrawCost) {
+    const int REDRAWS = 200;
+    tft.init(Screen::HEIGHT, Screen::WIDTH);
+    tft.setRotation(1);
+    env.history.clear();
+    for (uint32_t n = 0; n < GOLDEN_SAMPLES; n++)
+        feed(env.history, n);
+    settings.graphDuration = Graph::RANGES_MIN[0];
+    settings.graphAutoScale = false;
+    compositor.clearWidgets();
+
+    Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < REDRAWS; i++)
+        legacyRedraw(env.history, 0);
+    Clock::time_point t1 = Clock::now();
+    for (int i = 0; i < REDRAWS; i++) {
+        env.graph.invalidate(); // include the full rescale
+        drawHistoryGraph();
+    }
+    Clock::time_point t2 = Clock::now();
+    tft.resetStats();
+    legacyRedraw(env.history, 0);
+    Adafruit_SPITFT::Stats legacy = tft.stats();
+    tft.resetStats();
+    drawHistoryGraph();
+    Adafruit_SPITFT::Stats model = tft.stats();
+
+    typedef std::chrono::duration<double, std::micro> Us;
+    printf("graph redraw, %d samples per trace\n", GraphModel::LEN);
+    printf("  %-22s %8.1f us %6u windows %7llu bytes\n", "map() + drawLine",
+           Us(t1 - t0).count() / REDRAWS, (unsigned)legacy.windows,
+           (unsigned long long)legacy.bytes);
+    printf("  %-22s %8.1f us %6u windows %7llu bytes\n",
+           "GraphModel + compositor", Us(t2 - t1).count() / REDRAWS,
+           (unsigned)model.windows, (unsigned long long)model.bytes);
+    // The compositor streams bands rather than a window per line segment
+    CHECK(model.windows < legacy.windows);
+}
+
+CHECK_MAIN()
@@ -0,0 +1,143 @@
+// HistoryPyramid fed synthetic streams: every bucket on every level against
+// the raw samples it covers, a one-sample spike and dip kept as the
+// extremes all the way up, and which levels report a closed bucket.
+
+#include "Check.h"
+#include "HistoryPyramid.h"
+#include <vector>
+
+namespace {
+HistoryPyramid hist;
+std::vector<uint16_t> raw[HIST_CHANNELS];
+
+// Samples per bucket on each level: 1, 3, 6, 12, 36, ...
+int perBucket(int level) {
+    return Graph::RANGES_MIN[level] / Graph::RANGES_MIN[0];
+}
+
+void add(uint16_t temp, uint16_t hum, uint16_t tvoc, uint16_t co2) {
+    const uint16_t values[HIST_CHANNELS] = {temp, hum, tvoc, co2};
+    for (int c = 0; c < HIST_CHANNELS; c++)
+        raw[c].push_back(values[c]);
+    hist.add(values);
+}
+
+void setUp() {
+    hist.clear();
+    for (int c = 0; c < HIST_CHANNELS; c++)
+        raw[c].clear();
+}
+
+// Ordinary readings with no two neighbours alike
+void feed(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t k = (uint32_t)raw[0].size();
+        add((uint16_t)(200 + k % 50), (uint16_t)(40 + (k * 7) % 20),
+            (uint16_t)((k * 37) % 500), (uint16_t)(600 + (k * k) % 400));
+    }
+}
+
+// Raw sample number where the bucket shown at i on level starts (wrapping
+// arithmetic, valid for filled buckets)
+uint32_t firstSample(int level, int i) {
+    uint32_t closed = raw[0].size() / perBucket(level);
+    return (closed - HistoryPyramid::LEN + i) * perBucket(level);
+}
+
+// Each level's mean is the mean of the level below, rounded down, so it
+// drifts from the raw mean by under one unit a level
+bool bucketMatches(int level, int c, int i) {
+    HistBucket b = hist.at(level, c, i);
+    uint32_t from = firstSample(level, i);
+    uint16_t lo = 0xFFFF, hi = 0;
+    uint32_t sum = 0;
+    for (int k = 0; k < perBucket(level); k++) {
+        uint16_t v = raw[c][from + k];
+        lo = v < lo ? v : lo;
+        hi = v > hi ? v : hi;
+        sum += v;
+    }
+    double mean = (double)sum / perBucket(level);
+    return b.lo == lo && b.hi == hi && b.mean <= mean &&
+           b.mean > mean - level - 1;
+}
+} // namespace
+
+TEST(everyBucketSummarisesItsSamples) {
+    setUp();
+    // A full screen of the coarsest level
+    const int TOP = HistoryPyramid::LEVELS - 1;
+    feed(HistoryPyramid::LEN * perBucket(TOP));
+    int wrong = 0;
+    for (int l = 0; l < HistoryPyramid::LEVELS; l++) {
+        CHECK_EQ(hist.count(l), HistoryPyramid::LEN);
+        for (int c = 0; c < HIST_CHANNELS; c++)
+            for (int i = 0; i < HistoryPyramid::LEN; i++)
+                wrong += !bucketMatches(l, c, i);
+    }
+    CHECK_EQ(wrong, 0);
+
+    // Means of means, exactly: level 1 folds 3 samples, level 2 two of
+    // those
+    setUp();
+    const uint16_t temps[] = {200, 201, 203, 210, 211, 212};
+    for (uint16_t t : temps)
+        add(t, 50, 100, 800);
+    CHECK_EQ(hist.at(1, HIST_TEMP, HistoryPyramid::LEN - 2).mean, 201);
+    CHECK_EQ(hist.at(1, HIST_TEMP, HistoryPyramid::LEN - 1).mean, 211);
+    CHECK_EQ(hist.at(2, HIST_TEMP, HistoryPyramid::LEN - 1).mean, 206);
+    CHECK_EQ(hist.at(2, HIST_TEMP, HistoryPyramid::LEN - 1).lo, 200);
+    CHECK_EQ(hist.at(2, HIST_TEMP, HistoryPyramid::LEN - 1).hi, 212);
+}
+
+TEST(oneSampleSpikeSurvivesEveryLevel) {
+    setUp();
+    const int TOP = HistoryPyramid::LEVELS - 1;
+    const uint32_t N = 20 * perBucket(TOP);
+    // Within the finest level's window at the end of the run
+    const uint32_t SPIKE = N - 100;
+    feed(SPIKE);
+    add(205, 45, 250, 5000); // eCO2 spike
+    add(0, 45, 250, 800);    // temperature dip
+    feed(N - SPIKE - 2);
+
+    for (int l = 0; l < HistoryPyramid::LEVELS; l++) {
+        int highs = 0, lows = 0, where = -1;
+        for (int i = 0; i < HistoryPyramid::LEN; i++) {
+            if (i < HistoryPyramid::LEN - hist.count(l))
+                continue; // not filled yet
+            if (hist.at(l, HIST_CO2, i).hi == 5000) {
+                highs++;
+                where = i;
+            }
+            lows += hist.at(l, HIST_TEMP, i).lo == 0;
+        }
+        // In exactly one bucket, the one holding the spike's sample
+        CHECK_EQ(highs, 1);
+        CHECK_EQ(lows, 1);
+        uint32_t from = firstSample(l, where);
+        CHECK(from <= SPIKE && SPIKE < from + perBucket(l));
+        // The spike lifts that bucket's mean by its share only
+        uint16_t mean = hist.at(l, HIST_CO2, where).mean;
+        CHECK(mean <= 600 + 400 + 4400 / perBucket(l));
+    }
+}
+
+TEST(closedLevelsAreReported) {
+    hist.clear();
+    const uint16_t values[HIST_CHANNELS] = {200, 40, 100, 600};
+    int wrong = 0;
+    const int TOP = HistoryPyramid::LEVELS - 1;
+    for (int n = 1; n <= 3 * perBucket(TOP); n++) {
+        uint8_t closed = hist.add(values);
+        for (int l = 0; l < HistoryPyramid::LEVELS; l++)
+            wrong += ((closed >> l) & 1) != (n % perBucket(l) == 0);
+    }
+    CHECK_EQ(wrong, 0);
+    CHECK_EQ(hist.count(TOP), 3);
+    // Buckets not yet filled read as zero
+    CHECK_EQ(hist.at(TOP, HIST_CO2, 0).hi, 0);
+    CHECK_EQ(hist.at(TOP, HIST_CO2, HistoryPyramid::LEN - 1).mean, 600);
+}
+
+CHECK_MAIN()
@@ -0,0 +1,196 @@
+// Moving between the modes with scripted knob and button input: the
+// Pomodoro timer keeps time and signals its phases while other modes are
+// shown, and a long navigation session does no heap allocation.
+
+#include "AllocCounter.h"
+#include "AppModes.h"
+#include "Check.h"
+#include "Globals.h"
+#include "HostSim.h"
+#include "SettingsSchema.h"
+#include <vector>
+
+namespace {
+const uint32_t STEP_MS = 10;
+
+// Times the LED was flashed for a phase end
+std::vector<uint32_t> flashes;
+unsigned long lastHold = 0;
+bool pomodoroTask = true;
+
+// The loop at a 10 ms step: input, the Pomodoro task, then the UI
+void run(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += STEP_MS) {
+        Host::advanceMs(STEP_MS);
+        Input.update();
+        if (pomodoroTask)
+            Modes::Pomodoro.tick();
+        State.update();
+        if (ui.ledHoldUntilMs != lastHold) {
+            lastHold = ui.ledHoldUntilMs;
+            flashes.push_back(millis());
+        }
+    }
+}
+
+void press(InputButton b, uint32_t holdMs = 80) {
+    Input.inject({(uint32_t)millis(), EV_PRESS, b, 0, 0});
+    run(holdMs);
+    Input.inject({(uint32_t)millis(), EV_RELEASE, b, 0, 0});
+    // Past the double-click window
+    run(400);
+}
+
+void rotate(int detents) {
+    int16_t dir = detents < 0 ? -1 : 1;
+    for (int i = 0; i < detents * dir; i++) {
+        Input.inject({(uint32_t)millis(), EV_ROTATE, BTN_NONE, dir, dir});
+        run(150); // slow enough to stay unaccelerated
+    }
+}
+
+// MenuMode keeps its cursor between visits
+int menuIndex = 0;
+enum { ITEM_CLOCK, ITEM_POMODORO, ITEM_ALARM, ITEM_DVD, ITEM_SETTINGS };
+
+void openFromMenu(int item) {
+    rotate(item - menuIndex);
+    menuIndex = item;
+    press(BTN_ENC);
+}
+
+void setUp() {
+    tft.init(Screen::HEIGHT, Screen::WIDTH);
+    tft.setRotation(1);
+    Schema::applyDefaults(settings);
+    State.switchMode(Modes::Menu);
+    run(STEP_MS);
+}
+
+// One pass through every mode reachable from the menu
+void tour() {
+    openFromMenu(ITEM_CLOCK);
+    run(2000);
+    press(BTN_BACK);
+    CHECK_EQ(ui.currentMode, MODE_MENU);
+
+    openFromMenu(ITEM_POMODORO);
+    run(1000);
+    press(BTN_BACK);
+
+    openFromMenu(ITEM_ALARM);
+    press(BTN_ENC);
+    rotate(1);
+    rotate(-1);
+    press(BTN_BACK);
+
+    openFromMenu(ITEM_DVD);
+    run(1500);
+    rotate(2);
+    run(1500);
+    rotate(-2);
+    press(BTN_BACK);
+
+    openFromMenu(ITEM_SETTINGS);
+    CHECK_EQ(ui.currentMode, MODE_SETTINGS);
+    rotate(1);
+    press(BTN_ENC);
+    CHECK_EQ(ui.currentMode, MODE_SETTINGS_EDIT);
+    rotate(1);
+    rotate(-1);
+    press(BTN_ENC);
+    // WiFi is the last entry
+    rotate(-2);
+    press(BTN_ENC);
+    CHECK_EQ(ui.currentMode, MODE_WIFI_MENU);
+    rotate(1);
+    press(BTN_BACK);
+    rotate(1);
+    press(BTN_BACK);
+    CHECK_EQ(ui.currentMode, MODE_MENU);
+}
+} // namespace
+
+TEST(pomodoroSignalsPhasesInTheBackground) {
+    setUp();
+    settings.pomoWorkMin = 1;
+    settings.pomoShortMin = 1;
+    settings.pomoLongMin = 2;
+    settings.pomoCycles = 2;
+    openFromMenu(ITEM_POMODORO);
+    CHECK_EQ(ui.currentMode, MODE_POMODORO);
+    // Work, short break, long break, cycles; the last press starts it
+    for (int i = 0; i < 3; i++)
+        press(BTN_ENC);
+    Input.inject({(uint32_t)millis(), EV_PRESS, BTN_ENC, 0, 0});
+    run(STEP_MS);
+    uint32_t start = millis();
+    Input.inject({(uint32_t)millis(), EV_RELEASE, BTN_ENC, 0, 0});
+
+    // Away on the clock for the whole of both cycles
+    press(BTN_BACK);
+    openFromMenu(ITEM_CLOCK);
+    CHECK_EQ(ui.currentMode, MODE_CLOCK);
+    flashes.clear();
+    run(5 * 60000 + 500 - (millis() - start));
+
+    // Work, short, work, long: each ends on time, with its flash and tone
+    const uint32_t ends[] = {60000, 120000, 180000, 300000};
+    CHECK_EQ(flashes.size(), 4);
+    for (size_t i = 0; i < flashes.size() && i < 4; i++)
+        CHECK_NEAR(flashes[i] - start, ends[i], STEP_MS);
+    CHECK(Buzzer.busy());
+    CHECK_EQ(Buzzer.priority(), TONE_NOTIFY);
+}
+
+TEST(lateTicksDoNotLoseTime) {
+    // Carries on the timer from the test above: back in cycle 1 of work,
+    // started at the last flash
+    uint32_t start = flashes.back();
+    flashes.clear();
+    // Nothing ticks the timer for 150 s: one signal, late, and the phases
+    // due meanwhile are skipped without moving the schedule
+    pomodoroTask = false;
+    run(150000 - (millis() - start));
+    CHECK_EQ(flashes.size(), 0);
+    pomodoroTask = true;
+    run(STEP_MS);
+    CHECK_EQ(flashes.size(), 1);
+    // Work ended at 60 s and the short break at 120 s, so the next work
+    // phase ends at 180 s
+    run(180000 + 500 - (millis() - start));
+    CHECK_EQ(flashes.size(), 2);
+    CHECK_NEAR((int32_t)(flashes.back() - start), 180000, STEP_MS);
+}
+
+TEST(navigationDoesNotAllocate) {
+    setUp();
+    menuIndex = 0;
+    press(BTN_BACK); // from wherever the last test left off to the clock
+    press(BTN_BACK);
+    CHECK_EQ(ui.currentMode, MODE_MENU);
+    // The first visits build caches (glyph atlas, DVD sprite)
+    tour();
+
+    // The counter does see allocations
+    {
+        AllocCounter::Scope probe;
+        int *volatile p = new int(1);
+        delete p;
+        CHECK_EQ(probe.allocations(), 1);
+    }
+
+    const int TOURS = 20;
+    uint32_t allocations;
+    {
+        AllocCounter::Scope count;
+        for (int i = 0; i < TOURS; i++)
+            tour();
+        allocations = count.allocations();
+    }
+    printf("%d tours through every mode: %u heap allocations\n", TOURS,
+           allocations);
+    CHECK_EQ(allocations, 0);
+}
+
+CHECK_MAIN()
@@ -0,0 +1,137 @@
+// Steady-state rendering without the heap: every mode is drawn for a run
+// of frames with the clock ticking, readings and history changing and the
+// knob turning, while every allocation is counted.
+
+#include "AllocCounter.h"
+#include "AppModes.h"
+#include "Check.h"
+#include "Globals.h"
+#include "HostSim.h"
+#include "SettingsSchema.h"
+#include "TimeService.h"
+
+// Hardware.cpp, not in its header
+void recordHistory(float t, float h, uint16_t tvoc, uint16_t eco2);
+
+namespace {
+const int FRAMES = 300;
+const uint32_t FRAME_MS = 33;
+
+uint32_t frameNo = 0;
+
+// One pass of the loop with everything a frame can see change
+void frame(bool turn) {
+    Host::advanceMs(FRAME_MS);
+    frameNo++;
+    env.temp = 21.5f + (frameNo % 40) * 0.1f;
+    env.hum = 40 + frameNo % 7;
+    env.tvoc = (uint16_t)(100 + frameNo % 300);
+    env.eco2 = (uint16_t)(600 + (frameNo * 13) % 1500);
+    if (frameNo % 3 == 0)
+        recordHistory(env.temp, env.hum, env.tvoc, env.eco2);
+    if (turn && frameNo % 4 == 0) {
+        int16_t dir = frameNo % 8 == 0 ? 1 : -1;
+        Input.inject({(uint32_t)millis(), EV_ROTATE, BTN_NONE, dir, dir});
+    }
+    Input.update();
+    Time.update();
+    Modes::Pomodoro.tick();
+    State.update();
+}
+
+struct Case {
+    const char *name;
+    Mode *mode;
+    bool turn; // the knob moves during the run
+    void (*prepare)();
+};
+
+void press() {
+    Input.inject({(uint32_t)millis(), EV_PRESS, BTN_ENC, 0, 0});
+    frame(false);
+    Input.inject({(uint32_t)millis(), EV_RELEASE, BTN_ENC, 0, 0});
+    frame(false);
+}
+
+void startPomodoro() {
+    // Set work, short, long and cycles; the fourth press starts the timer
+    for (int i = 0; i < 4; i++) {
+        press();
+        for (int k = 0; k < 12; k++)
+            frame(false);
+    }
+}
+
+void ringAlarm() { Modes::Alarm.setRinging(true); }
+void editAlarm() { Modes::Alarm.setRinging(false); }
+void editBrightness() { Modes::SettingsEdit.setField(SET_LED_BRIGHTNESS); }
+void editRange() { Modes::SettingsEdit.setField(SET_GRAPH_RANGE); }
+} // namespace
+
+TEST(everyModeRendersWithoutAllocating) {
+    tft.init(Screen::HEIGHT, Screen::WIDTH);
+    tft.setRotation(1);
+    Schema::applyDefaults(settings);
+    env.history.clear();
+    // Monday 2025-10-13, so the clock shows real digits
+    Host::setWallTime(1760356800);
+    settings.pomoWorkMin = 1;
+
+    const Case cases[] = {
+        {"clock", &Modes::Clock, false, nullptr},
+        {"menu", &Modes::Menu, true, nullptr},
+        {"pomodoro", &Modes::Pomodoro, false, nullptr},
+        {"alarm edit", &Modes::Alarm, true, editAlarm},
+        {"alarm ringing", &Modes::Alarm, false, ringAlarm},
+        {"dvd", &Modes::Dvd, true, nullptr},
+        {"settings", &Modes::Settings, true, nullptr},
+        {"edit brightness", &Modes::SettingsEdit, true, editBrightness},
+        {"edit range", &Modes::SettingsEdit, true, editRange},
+        {"wifi menu", &Modes::WiFiMenu, true, nullptr},
+        {"wifi setup", &Modes::WiFiSetup, false, nullptr},
+    };
+
+    // Run every case first, so what is built on first use (glyph atlas,
+    // sprites, the time zone when SNTP first starts) is not counted. That
+    // takes two passes: WiFi joins when the first one leaves WiFi setup,
+    // and SNTP starts when the second does. The stand-in's LEDC log is
+    // cleared before each run and keeps the capacity the run needed here.
+    for (int pass = 0; pass < 2; pass++) {
+        for (const Case &c : cases) {
+            if (c.prepare)
+                c.prepare();
+            Host::clearLedcLog();
+            State.switchMode(*c.mode);
+            for (int i = 0; i < FRAMES; i++)
+                frame(c.turn);
+            if (pass == 0 && c.mode == &Modes::Pomodoro)
+                startPomodoro();
+        }
+    }
+
+    printf("%-16s %6s %12s %10s\n", "mode", "frames", "allocations",
+           "spi bytes");
+    for (const Case &c : cases) {
+        if (c.prepare)
+            c.prepare();
+        Host::clearLedcLog();
+        tft.resetStats();
+        uint32_t allocations;
+        {
+            AllocCounter::Scope count;
+            State.switchMode(*c.mode);
+            for (int i = 0; i < FRAMES; i++)
+                frame(c.turn);
+            allocations = count.allocations();
+        }
+        printf("%-16s %6d %12u %10llu\n", c.name, FRAMES, allocations,
+               (unsigned long long)tft.stats().bytes);
+        CHECK_EQ(allocations, 0);
+        // Every mode did draw something
+        CHECK(tft.stats().bytes > 0);
+    }
+    // The Pomodoro timer ran through its first work minute meanwhile
+    CHECK(ui.ledHoldUntilMs != 0);
+}
+
+CHECK_MAIN()
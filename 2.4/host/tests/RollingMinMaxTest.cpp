@@ -0,0 +1,140 @@
+// RollingMinMax against a brute-force scan of the same window, on random,
+// monotonic and sawtooth inputs, across sequence-number wrap and clear().
+
+#include "Check.h"
+#include "RollingMinMax.h"
+#include <algorithm>
+#include <deque>
+#include <random>
+
+namespace {
+// Keeps every range in the window and rescans it on each query
+template <uint16_t N> struct BruteForce {
+    std::deque<std::pair<uint16_t, uint16_t>> window;
+
+    void push(uint16_t lo, uint16_t hi) {
+        window.push_back(std::make_pair(lo, hi));
+        if (window.size() > N)
+            window.pop_front();
+    }
+    uint16_t min() const {
+        uint16_t m = 0xFFFF;
+        for (const auto &r : window)
+            m = std::min(m, r.first);
+        return m;
+    }
+    uint16_t max() const {
+        uint16_t m = 0;
+        for (const auto &r : window)
+            m = std::max(m, r.second);
+        return m;
+    }
+};
+
+// Feeds both with next(i) for count pushes; returns the number of pushes
+// after which they disagreed.
+template <uint16_t N, typename Next>
+int compare(RollingMinMax<N> &fast, BruteForce<N> &ref, int count,
+            Next next) {
+    int mismatches = 0;
+    for (int i = 0; i < count; i++) {
+        uint16_t lo, hi;
+        next(i, lo, hi);
+        fast.push(lo, hi);
+        ref.push(lo, hi);
+        mismatches += fast.empty() || fast.min() != ref.min() ||
+                      fast.max() != ref.max();
+    }
+    return mismatches;
+}
+} // namespace
+
+TEST(startsEmpty) {
+    RollingMinMax<4> r;
+    CHECK(r.empty());
+    r.push(5, 9);
+    CHECK(!r.empty());
+    CHECK_EQ(r.min(), 5);
+    CHECK_EQ(r.max(), 9);
+    r.clear();
+    CHECK(r.empty());
+}
+
+TEST(randomRangesMatchBruteForce) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> value(0, 2000), width(0, 50);
+    static RollingMinMax<320> fast;
+    BruteForce<320> ref;
+    int bad = compare(fast, ref, 20000, [&](int, uint16_t &lo, uint16_t &hi) {
+        lo = (uint16_t)value(rng);
+        hi = (uint16_t)(lo + width(rng));
+    });
+    CHECK_EQ(bad, 0);
+}
+
+TEST(monotonicAndSawtoothInputs) {
+    // Rising input keeps a single low and LEN highs queued, falling the
+    // reverse: the queues' worst cases
+    RollingMinMax<64> fast;
+    BruteForce<64> ref;
+    CHECK_EQ(compare(fast, ref, 500,
+                     [](int i, uint16_t &lo, uint16_t &hi) {
+                         lo = hi = (uint16_t)i;
+                     }),
+             0);
+    CHECK_EQ(compare(fast, ref, 500,
+                     [](int i, uint16_t &lo, uint16_t &hi) {
+                         lo = hi = (uint16_t)(1000 - i);
+                     }),
+             0);
+    CHECK_EQ(compare(fast, ref, 1000,
+                     [](int i, uint16_t &lo, uint16_t &hi) {
+                         lo = (uint16_t)(i % 97);
+                         hi = (uint16_t)(lo + i % 13);
+                     }),
+             0);
+    // Long runs of equal values
+    CHECK_EQ(compare(fast, ref, 1000,
+                     [](int i, uint16_t &lo, uint16_t &hi) {
+                         lo = hi = (uint16_t)(i / 100 % 3 * 10);
+                     }),
+             0);
+}
+
+TEST(sequenceWrapAndTinyWindows) {
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int> value(0, 0xFFFF);
+    // 70000 pushes wrap the 16-bit sequence number
+    RollingMinMax<7> fast;
+    BruteForce<7> ref;
+    CHECK_EQ(compare(fast, ref, 70000,
+                     [&](int, uint16_t &lo, uint16_t &hi) {
+                         lo = (uint16_t)value(rng);
+                         hi = std::max<uint16_t>(lo, (uint16_t)value(rng));
+                     }),
+             0);
+
+    RollingMinMax<1> one;
+    BruteForce<1> refOne;
+    CHECK_EQ(compare(one, refOne, 1000,
+                     [&](int, uint16_t &lo, uint16_t &hi) {
+                         lo = hi = (uint16_t)value(rng);
+                     }),
+             0);
+}
+
+TEST(clearForgetsTheWindow) {
+    RollingMinMax<16> fast;
+    for (int i = 0; i < 40; i++)
+        fast.push(0, 5000);
+    fast.clear();
+    BruteForce<16> ref;
+    CHECK_EQ(compare(fast, ref, 100,
+                     [](int i, uint16_t &lo, uint16_t &hi) {
+                         lo = (uint16_t)(100 + i % 10);
+                         hi = (uint16_t)(200 + i % 10);
+                     }),
+             0);
+}
+
+CHECK_MAIN()
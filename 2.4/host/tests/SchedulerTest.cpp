@@ -0,0 +1,163 @@
+// Scheduler timing on a fake clock: period grid, catch-up, jitter and
+// deadline accounting, one-shots, run order and 32-bit wrap.
+
+#include "Check.h"
+#include "Scheduler.h"
+#include <string>
+
+namespace {
+uint32_t fakeUs = 0;
+uint32_t fakeClock() { return fakeUs; }
+
+int runsA = 0, runsB = 0;
+std::string order;
+uint32_t workUs = 0; // how long taskA "runs"
+
+void taskA() {
+    runsA++;
+    order += 'A';
+    fakeUs += workUs;
+}
+void taskB() {
+    runsB++;
+    order += 'B';
+}
+
+void reset(uint32_t startUs = 0) {
+    fakeUs = startUs;
+    runsA = runsB = 0;
+    order.clear();
+    workUs = 0;
+}
+
+// Ticks every stepUs for durationUs, like a loop() with nothing else to do
+void runFor(Scheduler &s, uint32_t durationUs, uint32_t stepUs) {
+    uint32_t end = fakeUs + durationUs;
+    while ((int32_t)(fakeUs - end) < 0) {
+        s.tick();
+        fakeUs += stepUs;
+    }
+}
+} // namespace
+
+TEST(periodicTaskStaysOnGrid) {
+    reset();
+    Scheduler s;
+    s.setClock(fakeClock);
+    int id = s.every("a", 10, taskA);
+    runFor(s, 100000, 1000);
+    // Due at 0, 10, ..., 90 ms
+    CHECK_EQ(runsA, 10);
+    CHECK_EQ(s.stats(id)->maxJitterUs, 0);
+}
+
+TEST(lateStartsKeepTheGridAndRecordJitter) {
+    reset();
+    Scheduler s;
+    s.setClock(fakeClock);
+    int id = s.every("a", 10, taskA, 2);
+    s.tick(); // 0 ms
+    fakeUs = 13000;
+    s.tick(); // due at 10 ms: 3 ms late, past the 2 ms deadline
+    fakeUs = 20500;
+    s.tick(); // due at 20 ms, still on the original grid
+    CHECK_EQ(runsA, 3);
+    CHECK_EQ(s.stats(id)->maxJitterUs, 3000);
+    CHECK_EQ(s.stats(id)->missed, 1);
+}
+
+TEST(fallingAPeriodBehindDoesNotBurst) {
+    reset();
+    Scheduler s;
+    s.setClock(fakeClock);
+    s.every("a", 10, taskA);
+    s.tick();
+    fakeUs = 55000; // five periods missed
+    s.tick();
+    s.tick();
+    CHECK_EQ(runsA, 2);
+    fakeUs = 64999;
+    s.tick();
+    CHECK_EQ(runsA, 2);
+    fakeUs = 65000; // rescheduled from the late start
+    s.tick();
+    CHECK_EQ(runsA, 3);
+}
+
+TEST(runtimeIsAccumulated) {
+    reset();
+    Scheduler s;
+    s.setClock(fakeClock);
+    int id = s.every("a", 0, taskA);
+    workUs = 250;
+    for (int i = 0; i < 4; i++)
+        s.tick();
+    workUs = 900;
+    s.tick();
+    CHECK_EQ(s.stats(id)->runs, 5);
+    CHECK_EQ(s.stats(id)->totalUs, 4 * 250 + 900);
+    CHECK_EQ(s.stats(id)->maxUs, 900);
+    s.resetStats();
+    CHECK_EQ(s.stats(id)->runs, 0);
+}
+
+TEST(oneShotRunsOnceAndFreesItsSlot) {
+    reset();
+    Scheduler s;
+    s.setClock(fakeClock);
+    int shot = s.after(5, taskB);
+    fakeUs = 4999;
+    s.tick();
+    CHECK_EQ(runsB, 0);
+    fakeUs = 5000;
+    s.tick();
+    s.tick();
+    fakeUs = 100000;
+    s.tick();
+    CHECK_EQ(runsB, 1);
+    // The freed slot is the first one handed out next
+    CHECK_EQ(s.every("a", 0, taskA), shot);
+}
+
+TEST(tasksRunInSlotOrder) {
+    reset();
+    Scheduler s;
+    s.setClock(fakeClock);
+    s.every("a", 0, taskA);
+    s.every("b", 0, taskB);
+    s.tick();
+    CHECK(order == "AB");
+
+    // A task registered after a cancel takes the earlier slot
+    order.clear();
+    Scheduler t;
+    t.setClock(fakeClock);
+    int first = t.every("b", 0, taskB);
+    t.every("a", 0, taskA);
+    t.cancel(first);
+    t.every("b", 0, taskB);
+    t.tick();
+    CHECK(order == "BA");
+}
+
+TEST(periodsSurviveMicrosWrap) {
+    reset(0xFFFFFFFFu - 25000);
+    Scheduler s;
+    s.setClock(fakeClock);
+    int id = s.every("a", 10, taskA);
+    runFor(s, 100000, 1000);
+    CHECK_EQ(runsA, 10);
+    CHECK_EQ(s.stats(id)->maxJitterUs, 0);
+}
+
+TEST(fullSchedulerRejectsTasks) {
+    reset();
+    Scheduler s;
+    s.setClock(fakeClock);
+    for (int i = 0; i < Scheduler::MAX_TASKS; i++)
+        CHECK_EQ(s.every("a", 10, taskA), i);
+    CHECK_EQ(s.every("a", 10, taskA), -1);
+    CHECK(s.stats(-1) == nullptr);
+}
+
+CHECK_MAIN()
@@ -0,0 +1,225 @@
+// Seqlock under a writer thread, SensorTask on the FreeRTOS stand-in, and
+// the UI frame jitter with the sensor read inline versus on its own thread.
+
+#include "Check.h"
+#include "Globals.h"
+#include "Graphics.h"
+#include "HostSim.h"
+#include "SensorTask.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+EnvSample sampleOf(uint32_t i) {
+    EnvSample s;
+    s.temp = (float)i;
+    s.hum = (float)i;
+    s.tvoc = (uint16_t)i;
+    s.eco2 = (uint16_t)(i >> 3);
+    s.timeMs = i;
+    return s;
+}
+
+bool consistent(const EnvSample &s) {
+    uint32_t i = s.timeMs;
+    return s.temp == (float)i && s.hum == (float)i &&
+           s.tvoc == (uint16_t)i && s.eco2 == (uint16_t)(i >> 3);
+}
+
+// --- Jitter measurement ---
+// A simulated sensor read that takes as long as the bus does; the real
+// ENS160 measure() plus AHT21 read is ~300 ms, scaled down here.
+const int READ_MS = 60;
+const int READ_EVERY_MS = 250;
+const int FRAME_MS = 10;
+const int RUN_MS = 1500;
+
+EnvSample simulatedRead(uint32_t n) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(READ_MS));
+    EnvSample s;
+    s.temp = 20.0f + n % 5;
+    s.hum = 40.0f + n % 7;
+    s.tvoc = (uint16_t)(100 + n);
+    s.eco2 = (uint16_t)(600 + n);
+    return s;
+}
+
+void renderFrame(const EnvSample &s) {
+    env.temp = s.temp;
+    env.hum = s.hum;
+    env.tvoc = s.tvoc;
+    env.eco2 = s.eco2;
+    drawEnvDynamic();
+}
+
+struct Jitter {
+    int frames = 0;
+    int reads = 0;
+    long p99Us = 0;
+    long maxUs = 0;
+};
+
+// Runs the UI at FRAME_MS and records how late each frame starts. With
+// onThread false the read happens in the frame that comes due, as before
+// the sensor task; otherwise a thread reads and publishes through a
+// Seqlock and the frame only polls.
+Jitter measure(bool onThread) {
+    Seqlock<EnvSample> latest;
+    std::atomic<bool> stop{false};
+    std::atomic<int> reads{0};
+    std::thread sensor;
+    if (onThread) {
+        sensor = std::thread([&] {
+            Clock::time_point next = Clock::now();
+            for (uint32_t n = 0; !stop; n++) {
+                latest.write(simulatedRead(n));
+                reads++;
+                next += std::chrono::milliseconds(READ_EVERY_MS);
+                std::this_thread::sleep_until(next);
+            }
+        });
+    }
+
+    std::vector<long> lateUs;
+    EnvSample shown;
+    uint32_t seen = 0;
+    Clock::time_point start = Clock::now();
+    Clock::time_point due = start;
+    Clock::time_point nextRead = start;
+    while (due - start < std::chrono::milliseconds(RUN_MS)) {
+        std::this_thread::sleep_until(due);
+        Clock::time_point now = Clock::now();
+        lateUs.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - due)
+                .count());
+        if (onThread) {
+            uint32_t v;
+            EnvSample s;
+            if (latest.version() != seen && latest.read(s, v)) {
+                seen = v;
+                shown = s;
+            }
+        } else if (now >= nextRead) {
+            shown = simulatedRead(reads++);
+            nextRead += std::chrono::milliseconds(READ_EVERY_MS);
+        }
+        renderFrame(shown);
+        // Keep the frame grid; a late frame does not shift the ones after
+        due += std::chrono::milliseconds(FRAME_MS);
+    }
+
+    stop = true;
+    if (sensor.joinable())
+        sensor.join();
+
+    Jitter j;
+    j.frames = (int)lateUs.size();
+    j.reads = reads;
+    std::sort(lateUs.begin(), lateUs.end());
+    j.p99Us = lateUs[lateUs.size() * 99 / 100];
+    j.maxUs = lateUs.back();
+    return j;
+}
+} // namespace
+
+TEST(seqlockNeverHandsOutATornSample) {
+    const uint32_t WRITES = 500000;
+    static Seqlock<EnvSample> lock;
+    lock.write(sampleOf(0));
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (uint32_t i = 1; i <= WRITES; i++)
+            lock.write(sampleOf(i));
+        done = true;
+    });
+
+    uint32_t reads = 0, torn = 0, backwards = 0;
+    uint32_t lastVersion = 0, lastTime = 0;
+    while (!done) {
+        EnvSample s;
+        uint32_t v;
+        if (!lock.read(s, v))
+            continue; // gave up under contention, as designed
+        reads++;
+        torn += !consistent(s);
+        backwards += v < lastVersion || s.timeMs < lastTime;
+        lastVersion = v;
+        lastTime = s.timeMs;
+    }
+    writer.join();
+
+    CHECK(reads > 0);
+    CHECK_EQ(torn, 0);
+    CHECK_EQ(backwards, 0);
+    EnvSample s;
+    uint32_t v;
+    CHECK(lock.read(s, v));
+    CHECK_EQ(s.timeMs, WRITES);
+    CHECK_EQ(v, lock.version());
+    CHECK_EQ(v, 2 * (WRITES + 1));
+}
+
+TEST(sensorTaskPublishesOncePerPeriod) {
+    Host::SensorValues values;
+    values.temp = 23.5f;
+    values.hum = 51.0f;
+    values.tvoc = 210;
+    values.eco2 = 845;
+    Host::setSensors(values);
+
+    EnvSample s;
+    CHECK(!Sensors.poll(s));
+    Sensors.begin();
+    // The task reads once at start-up, then every PERIOD_MS
+    CHECK(Sensors.poll(s));
+    CHECK_NEAR(s.temp, 23.5, 1e-6);
+    CHECK_NEAR(s.hum, 51.0, 1e-6);
+    CHECK_EQ(s.tvoc, 210);
+    CHECK_EQ(s.eco2, 845);
+    CHECK(!Sensors.poll(s)); // nothing new
+
+    int samples = 0;
+    for (int ms = 0; ms < 5005; ms += 10) {
+        Host::advanceMs(10);
+        samples += Sensors.poll(s);
+    }
+    CHECK_EQ(samples, 5);
+
+    values.eco2 = 1400;
+    Host::setSensors(values);
+    Host::advanceMs(SensorTask::PERIOD_MS);
+    CHECK(Sensors.poll(s));
+    CHECK_EQ(s.eco2, 1400);
+    CHECK_EQ(s.timeMs % SensorTask::PERIOD_MS, 0);
+}
+
+TEST(frameJitterWithAndWithoutSensorThread) {
+    tft.init(Screen::HEIGHT, Screen::WIDTH);
+    tft.setRotation(1);
+    initClockStaticUI();
+
+    Jitter inlineRead = measure(false);
+    Jitter threaded = measure(true);
+    printf("frame jitter over %d ms at %d ms frames, %d ms reads every "
+           "%d ms\n",
+           RUN_MS, FRAME_MS, READ_MS, READ_EVERY_MS);
+    printf("  %-14s frames %4d reads %2d p99 %6ld us max %6ld us\n",
+           "read in frame", inlineRead.frames, inlineRead.reads,
+           inlineRead.p99Us, inlineRead.maxUs);
+    printf("  %-14s frames %4d reads %2d p99 %6ld us max %6ld us\n",
+           "sensor thread", threaded.frames, threaded.reads, threaded.p99Us,
+           threaded.maxUs);
+
+    CHECK(inlineRead.reads > 0 && threaded.reads > 0);
+    // A read in the frame makes the next one late by the rest of the read
+    CHECK(inlineRead.maxUs >= (READ_MS - FRAME_MS) * 1000 * 8 / 10);
+    // On its own thread it never shows up in frame timing
+    CHECK(threaded.maxUs < READ_MS * 1000 / 3);
+}
+
+CHECK_MAIN()
@@ -0,0 +1,157 @@
+// The settings table: every field round-trips through get/set and the
+// stored blob, out-of-range values are forced into bounds, and encoder
+// adjustment steps, wraps and snaps as each field declares.
+
+#include "Check.h"
+#include "Globals.h"
+#include "HostSim.h"
+#include "SettingsSchema.h"
+#include "SettingsStore.h"
+#include <random>
+
+namespace {
+bool allowed(const SettingDef &f, int v) {
+    if (f.choices == nullptr)
+        return v >= f.min && v <= f.max;
+    for (int i = 0; i < f.choiceCount; i++)
+        if (f.choices[i] == v)
+            return true;
+    return false;
+}
+
+// A random setting that is valid for every field
+AppSettings randomSettings(std::mt19937 &rng) {
+    AppSettings s;
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        const SettingDef &f = Schema::FIELDS[i];
+        int v;
+        if (f.choices != nullptr)
+            v = f.choices[rng() % f.choiceCount];
+        else
+            v = f.min + (int)(rng() % (f.max - f.min + 1));
+        Schema::set(s, (SettingId)i, v);
+    }
+    return s;
+}
+} // namespace
+
+TEST(everyValueRoundTrips) {
+    AppSettings s;
+    Schema::applyDefaults(s);
+    int bad = 0;
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        SettingId id = (SettingId)i;
+        const SettingDef &f = Schema::field(id);
+        for (int v = f.min; v <= f.max; v++) {
+            if (!allowed(f, v))
+                continue;
+            Schema::set(s, id, v);
+            bad += Schema::get(s, id) != v;
+        }
+        // Setting one field leaves the others alone
+        AppSettings before = s;
+        Schema::set(s, id, f.def);
+        for (int j = 0; j < SETTING_COUNT; j++)
+            if (j != i)
+                bad += Schema::get(s, (SettingId)j) !=
+                       Schema::get(before, (SettingId)j);
+    }
+    CHECK_EQ(bad, 0);
+}
+
+TEST(defaultsMatchTheTable) {
+    AppSettings s;
+    Schema::applyDefaults(s);
+    for (int i = 0; i < SETTING_COUNT; i++)
+        CHECK_EQ(Schema::get(s, (SettingId)i), Schema::FIELDS[i].def);
+    CHECK_EQ(s.alarms[3].days, Schema::ALARM_DAYS_ALL);
+    CHECK_EQ(s.alertRules[0].threshold, 1800);
+}
+
+TEST(boundsAreEnforced) {
+    AppSettings s;
+    Schema::applyDefaults(s);
+    int bad = 0;
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        SettingId id = (SettingId)i;
+        const SettingDef &f = Schema::field(id);
+        const int probes[] = {-100000, f.min - 1, f.max + 1, 100000,
+                              f.min + 1, f.max - 1, (f.min + f.max) / 2};
+        for (int v : probes) {
+            Schema::set(s, id, v);
+            int got = Schema::get(s, id);
+            bad += !allowed(f, got);
+            bad += got != Schema::clamp(id, v);
+        }
+    }
+    CHECK_EQ(bad, 0);
+
+    CHECK_EQ(Schema::clamp(SET_LED_BRIGHTNESS, 140), 100);
+    CHECK_EQ(Schema::clamp(SET_POMO_WORK, 0), 1);
+    CHECK_EQ(Schema::clamp(SET_ALARM1_HOUR, 24), 23);
+    // Choice fields snap to the nearest allowed value
+    CHECK_EQ(Schema::clamp(SET_GRAPH_RANGE, 50), 60);
+    CHECK_EQ(Schema::clamp(SET_GRAPH_RANGE, 20), 15);
+    CHECK_EQ(Schema::clamp(SET_GRAPH_RANGE, 100000), 1440);
+}
+
+TEST(adjustStepsWrapsAndSnaps) {
+    AppSettings s;
+    Schema::applyDefaults(s);
+    // Stepped and clamped
+    CHECK_EQ(Schema::adjust(s, SET_LED_BRIGHTNESS, -3), 85);
+    CHECK_EQ(Schema::adjust(s, SET_LED_BRIGHTNESS, 10), 100);
+    // Clock fields wrap
+    CHECK_EQ(Schema::adjust(s, SET_ALARM1_HOUR, 17), 0);
+    CHECK_EQ(Schema::adjust(s, SET_ALARM1_HOUR, -1), 23);
+    CHECK_EQ(Schema::adjust(s, SET_ALARM1_MINUTE, -61), 59);
+    // Booleans toggle whatever the direction
+    CHECK_EQ(Schema::adjust(s, SET_ALARM1_ENABLED, -1), 1);
+    CHECK_EQ(Schema::adjust(s, SET_ALARM1_ENABLED, 5), 0);
+    // Choices move through the list and stop at the ends
+    CHECK_EQ(Schema::adjust(s, SET_GRAPH_RANGE, 2), 30);
+    CHECK_EQ(Schema::adjust(s, SET_GRAPH_RANGE, 20), 1440);
+    CHECK_EQ(Schema::adjust(s, SET_GRAPH_RANGE, -1), 720);
+    // No movement, no change
+    CHECK_EQ(Schema::adjust(s, SET_POMO_WORK, 0), 25);
+
+    // Whatever the detents, the value stays valid
+    std::mt19937 rng(7);
+    int bad = 0;
+    for (int n = 0; n < 20000; n++) {
+        SettingId id = (SettingId)(rng() % SETTING_COUNT);
+        int delta = (int)(rng() % 41) - 20;
+        bad += !allowed(Schema::field(id), Schema::adjust(s, id, delta));
+    }
+    CHECK_EQ(bad, 0);
+}
+
+TEST(equalComparesEveryField) {
+    AppSettings a, b;
+    Schema::applyDefaults(a);
+    Schema::applyDefaults(b);
+    CHECK(Schema::equal(a, b));
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        AppSettings c = a;
+        Schema::adjust(c, (SettingId)i, 1);
+        if (Schema::get(c, (SettingId)i) != Schema::get(a, (SettingId)i))
+            CHECK(!Schema::equal(a, c));
+    }
+}
+
+TEST(randomSettingsRoundTripThroughTheBlob) {
+    std::mt19937 rng(2024);
+    Host::clearNvs();
+    Store.load(settings);
+    int bad = 0;
+    for (int n = 0; n < 50; n++) {
+        settings = randomSettings(rng);
+        Store.flush();
+        AppSettings loaded;
+        Store.load(loaded);
+        bad += !Schema::equal(loaded, settings);
+    }
+    CHECK_EQ(bad, 0);
+}
+
+CHECK_MAIN()
@@ -0,0 +1,245 @@
+// SettingsStore against the counting Preferences stand-in: one blob write
+// per settled change, none for no-op saves, flush(), and loading the
+// per-key layout, v1 blobs, shorter and longer v2 blobs and damaged ones.
+
+#include "Check.h"
+#include "Globals.h"
+#include "HostSim.h"
+#include "SettingsStore.h"
+#include <esp_rom_crc.h>
+#include <vector>
+
+namespace {
+// Blob layout as in SettingsStore
+struct Header {
+    uint16_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint16_t reserved;
+    uint32_t crc;
+};
+const uint16_t MAGIC = 0x5E77;
+
+// Frozen v1 payload, as SettingsStore.cpp decodes it
+struct AppSettingsV1 {
+    int ledBrightness;
+    int speakerVol;
+    int graphDuration;
+    bool graphAutoScale;
+    uint8_t alarmHour;
+    uint8_t alarmMinute;
+    bool alarmEnabled;
+    int pomoWorkMin;
+    int pomoShortMin;
+    int pomoLongMin;
+    int pomoCycles;
+};
+
+void putBlob(uint16_t version, const void *payload, size_t size,
+             bool damage = false) {
+    std::vector<uint8_t> buf(sizeof(Header) + size);
+    memcpy(buf.data() + sizeof(Header), payload, size);
+    Header h = {MAGIC, version, (uint16_t)size, 0,
+                esp_rom_crc32_le(0, buf.data() + sizeof(Header), size)};
+    memcpy(buf.data(), &h, sizeof(h));
+    if (damage)
+        buf.back() ^= 1;
+    prefs.begin("cyber", false);
+    prefs.putBytes("cfg", buf.data(), buf.size());
+    prefs.end();
+}
+
+uint32_t nvsWrites() { return Host::nvsStats().writes; }
+
+// Boots with whatever NVS holds and lets the writer settle
+void boot() {
+    Store.load(settings);
+    Host::advanceMs(SettingsStore::DEBOUNCE_MS * 2);
+    Store.update();
+    Host::advanceMs(10);
+}
+
+// The scheduler ticks update() every 100 ms
+void runFor(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += 100) {
+        Store.update();
+        Host::advanceMs(100);
+    }
+}
+} // namespace
+
+TEST(perKeySettingsBecomeOneBlob) {
+    Host::clearNvs();
+    prefs.begin("cyber", false);
+    prefs.putInt("led_b", 40);
+    prefs.putBool("gr_auto", false);
+    prefs.putInt("p_work", 50);
+    prefs.putInt("p_cycl", 99); // out of range, clamped on load
+    prefs.end();
+
+    uint32_t before = nvsWrites();
+    Store.load(settings);
+    CHECK_EQ(settings.ledBrightness, 40);
+    CHECK_EQ(settings.graphAutoScale, false);
+    CHECK_EQ(settings.pomoWorkMin, 50);
+    CHECK_EQ(settings.pomoCycles, 10);
+    CHECK_EQ(settings.speakerVol, 100); // absent: default
+    // One blob, then the four old keys removed
+    CHECK_EQ(nvsWrites() - before, 1 + 4);
+    prefs.begin("cyber", true);
+    CHECK(!prefs.isKey("led_b"));
+    CHECK(prefs.isKey("cfg"));
+    prefs.end();
+
+    // The next boot reads the blob and writes nothing
+    settings = AppSettings();
+    before = nvsWrites();
+    Store.load(settings);
+    CHECK_EQ(settings.pomoWorkMin, 50);
+    CHECK_EQ(nvsWrites(), before);
+}
+
+TEST(editsSettleIntoOneWrite) {
+    Host::clearNvs();
+    boot();
+    uint32_t before = nvsWrites(), stores = Store.writes();
+    // Scrolling the volume down ten detents, one every 200 ms
+    for (int i = 0; i < 10; i++) {
+        Schema::adjust(settings, SET_SPEAKER_VOL, -1);
+        Store.requestSave();
+        runFor(200);
+    }
+    CHECK_EQ(nvsWrites(), before);
+    runFor(SettingsStore::DEBOUNCE_MS - 200);
+    CHECK_EQ(nvsWrites(), before);
+    runFor(400);
+    CHECK_EQ(nvsWrites(), before + 1);
+    CHECK_EQ(Store.writes(), stores + 1);
+
+    AppSettings loaded;
+    Store.load(loaded);
+    CHECK_EQ(loaded.speakerVol, 50);
+}
+
+TEST(unchangedSavesWriteNothing) {
+    Host::clearNvs();
+    boot();
+    uint32_t before = nvsWrites();
+    // Back out of three screens without touching anything
+    for (int i = 0; i < 3; i++) {
+        Store.requestSave();
+        runFor(1000);
+    }
+    runFor(SettingsStore::DEBOUNCE_MS * 2);
+    CHECK_EQ(nvsWrites(), before);
+
+    // Changed and changed back before it settled
+    Schema::adjust(settings, SET_LED_BRIGHTNESS, -1);
+    Store.requestSave();
+    runFor(500);
+    Schema::adjust(settings, SET_LED_BRIGHTNESS, 1);
+    Store.requestSave();
+    runFor(SettingsStore::DEBOUNCE_MS * 2);
+    CHECK_EQ(nvsWrites(), before);
+}
+
+TEST(flushWritesAtOnceAndOnlyOnce) {
+    Host::clearNvs();
+    boot();
+    uint32_t before = nvsWrites();
+    settings.alarms[2].hour = 6;
+    Store.requestSave();
+    Store.flush();
+    CHECK_EQ(nvsWrites(), before + 1);
+    runFor(SettingsStore::DEBOUNCE_MS * 2);
+    CHECK_EQ(nvsWrites(), before + 1);
+    Store.flush();
+    CHECK_EQ(nvsWrites(), before + 1);
+}
+
+TEST(versionOneBlobMigrates) {
+    Host::clearNvs();
+    AppSettingsV1 v1 = {};
+    v1.ledBrightness = 30;
+    v1.speakerVol = 70;
+    v1.graphDuration = 60;
+    v1.graphAutoScale = false;
+    v1.alarmHour = 6;
+    v1.alarmMinute = 45;
+    v1.alarmEnabled = true;
+    v1.pomoWorkMin = 40;
+    v1.pomoShortMin = 7;
+    v1.pomoLongMin = 20;
+    v1.pomoCycles = 3;
+    putBlob(1, &v1, sizeof(v1));
+
+    settings = AppSettings();
+    Store.load(settings);
+    CHECK_EQ(settings.ledBrightness, 30);
+    CHECK_EQ(settings.speakerVol, 70);
+    CHECK_EQ(settings.graphDuration, 60);
+    CHECK_EQ(settings.graphAutoScale, false);
+    CHECK_EQ(settings.alarms[0].hour, 6);
+    CHECK_EQ(settings.alarms[0].minute, 45);
+    CHECK_EQ(settings.alarms[0].enabled, true);
+    CHECK_EQ(settings.pomoCycles, 3);
+    // Fields v1 did not have take their defaults
+    CHECK_EQ(settings.alarms[0].days, Schema::ALARM_DAYS_ALL);
+    CHECK_EQ(settings.alarms[1].hour, Schema::field(SET_ALARM2_HOUR).def);
+
+    // A v1 blob of the wrong size is rejected; defaults load instead
+    Host::clearNvs();
+    putBlob(1, &v1, sizeof(v1) - 4);
+    Store.load(settings);
+    CHECK_EQ(settings.ledBrightness, Schema::field(SET_LED_BRIGHTNESS).def);
+}
+
+TEST(shorterAndLongerBlobsLoadTheirKnownPrefix) {
+    // An older firmware's blob: the first 11 fields, one out of range
+    Host::clearNvs();
+    int32_t older[SET_POMO_CYCLES + 1];
+    for (int i = 0; i <= SET_POMO_CYCLES; i++)
+        older[i] = Schema::field((SettingId)i).def;
+    older[SET_LED_BRIGHTNESS] = 250;
+    older[SET_POMO_SHORT] = 12;
+    putBlob(2, older, sizeof(older));
+    settings = AppSettings();
+    Store.load(settings);
+    CHECK_EQ(settings.ledBrightness, 100);
+    CHECK_EQ(settings.pomoShortMin, 12);
+    // The alert rules came later and keep their defaults
+    CHECK_EQ(settings.alertRules[0].threshold,
+             Schema::field((SettingId)(SET_ALERT1_FIRST + 4)).def);
+
+    // A newer firmware's blob with fields this one does not know
+    Host::clearNvs();
+    std::vector<int32_t> newer(SETTING_COUNT + 5, 1);
+    for (int i = 0; i < SETTING_COUNT; i++)
+        newer[i] = Schema::get(settings, (SettingId)i);
+    newer[SET_POMO_WORK] = 33;
+    putBlob(3, newer.data(), newer.size() * sizeof(int32_t));
+    AppSettings loaded;
+    Store.load(loaded);
+    CHECK_EQ(loaded.pomoWorkMin, 33);
+    CHECK_EQ(loaded.pomoShortMin, 12);
+}
+
+TEST(damagedBlobFallsBackToDefaults) {
+    Host::clearNvs();
+    int32_t values[SETTING_COUNT];
+    for (int i = 0; i < SETTING_COUNT; i++)
+        values[i] = Schema::field((SettingId)i).def;
+    values[SET_SPEAKER_VOL] = 10;
+    putBlob(2, values, sizeof(values), true);
+    settings = AppSettings();
+    uint32_t before = nvsWrites();
+    Store.load(settings);
+    CHECK_EQ(settings.speakerVol, 100);
+    // and rewrites a good blob
+    CHECK_EQ(nvsWrites(), before + 1);
+    AppSettings again;
+    Store.load(again);
+    CHECK(Schema::equal(again, settings));
+}
+
+CHECK_MAIN()
@@ -0,0 +1,184 @@
+// TimeService in the firmware's time zone: second-by-second agreement with
+// localtime_r across both DST changes and New Year, the events it raises,
+// and clock steps.
+
+#include "Check.h"
+#include "Config.h"
+#include "TimeService.h"
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+time_t fakeNow = 0;
+time_t fakeClock() { return fakeNow; }
+
+// 2025-03-30 01:00 UTC: CET 02:00 becomes CEST 03:00
+const time_t SPRING_FORWARD = 1743296400;
+// 2025-10-26 01:00 UTC: CEST 03:00 becomes CET 02:00
+const time_t FALL_BACK = 1761440400;
+// 2025-12-31 23:00 UTC: midnight in CET
+const time_t NEW_YEAR = 1767222000;
+
+uint8_t seen = 0;
+int minutes = 0, days = 0, jumps = 0;
+void onTime(uint8_t events) {
+    seen |= events;
+    minutes += (events & TIME_MINUTE) != 0;
+    days += (events & TIME_DAY) != 0;
+    jumps += (events & TIME_JUMP) != 0;
+}
+
+void useFirmwareZone() {
+    setenv("TZ", Net::TIME_ZONE, 1);
+    tzset();
+}
+
+struct Sweep {
+    int mismatches = 0;
+    int minutes = 0;
+    int days = 0;
+    int jumps = 0;
+};
+
+// Ticks t once per second from start to end and compares the cached time
+// and text with a fresh localtime_r every second
+Sweep sweep(TimeService &t, time_t start, time_t end) {
+    fakeNow = start;
+    t.update();
+    minutes = days = jumps = 0;
+    Sweep s;
+    for (fakeNow = start + 1; fakeNow <= end; fakeNow++) {
+        t.update();
+        struct tm ref;
+        localtime_r(&fakeNow, &ref);
+        char text[9];
+        strftime(text, sizeof(text), "%H:%M:%S", &ref);
+        const struct tm &got = t.local();
+        s.mismatches += got.tm_sec != ref.tm_sec || got.tm_min != ref.tm_min ||
+                        got.tm_hour != ref.tm_hour ||
+                        got.tm_yday != ref.tm_yday ||
+                        got.tm_isdst != ref.tm_isdst ||
+                        strcmp(t.hms(), text) != 0;
+    }
+    s.minutes = minutes;
+    s.days = days;
+    s.jumps = jumps;
+    return s;
+}
+} // namespace
+
+TEST(springForwardSkipsAnHour) {
+    useFirmwareZone();
+    TimeService t;
+    t.setClock(fakeClock);
+    t.subscribe(onTime, TIME_MINUTE | TIME_DAY | TIME_JUMP);
+
+    fakeNow = SPRING_FORWARD - 1;
+    t.update();
+    CHECK(strcmp(t.hms(), "01:59:59") == 0);
+    CHECK_EQ(t.local().tm_isdst, 0);
+    fakeNow++;
+    t.update();
+    CHECK(strcmp(t.hms(), "03:00:00") == 0);
+    CHECK_EQ(t.local().tm_isdst, 1);
+
+    Sweep s = sweep(t, SPRING_FORWARD - 7200, SPRING_FORWARD + 7200);
+    CHECK_EQ(s.mismatches, 0);
+    CHECK_EQ(s.minutes, 240); // one per minute of real time
+    CHECK_EQ(s.days, 0);
+    CHECK_EQ(s.jumps, 0); // DST is not a clock step
+}
+
+TEST(fallBackRepeatsAnHour) {
+    useFirmwareZone();
+    TimeService t;
+    t.setClock(fakeClock);
+    t.subscribe(onTime, TIME_MINUTE | TIME_DAY | TIME_JUMP);
+
+    fakeNow = FALL_BACK - 1;
+    t.update();
+    CHECK(strcmp(t.hms(), "02:59:59") == 0);
+    CHECK_EQ(t.local().tm_isdst, 1);
+    fakeNow++;
+    t.update();
+    CHECK(strcmp(t.hms(), "02:00:00") == 0);
+    CHECK_EQ(t.local().tm_isdst, 0);
+
+    Sweep s = sweep(t, FALL_BACK - 7200, FALL_BACK + 7200);
+    CHECK_EQ(s.mismatches, 0);
+    CHECK_EQ(s.minutes, 240);
+    CHECK_EQ(s.days, 0);
+    CHECK_EQ(s.jumps, 0);
+}
+
+TEST(midnightRaisesOneDayEvent) {
+    useFirmwareZone();
+    TimeService t;
+    t.setClock(fakeClock);
+    t.subscribe(onTime, TIME_MINUTE | TIME_DAY | TIME_JUMP);
+    Sweep s = sweep(t, NEW_YEAR - 600, NEW_YEAR + 600);
+    CHECK_EQ(s.mismatches, 0);
+    CHECK_EQ(s.days, 1);
+    CHECK_EQ(s.minutes, 20);
+    CHECK_EQ(t.local().tm_year, 126);
+    CHECK_EQ(t.local().tm_yday, 0);
+}
+
+TEST(stepsAreJumpsButStallsAreNot) {
+    useFirmwareZone();
+    TimeService t;
+    t.setClock(fakeClock);
+    t.subscribe(onTime, TIME_SECOND | TIME_MINUTE | TIME_DAY | TIME_JUMP);
+    CHECK(!t.valid());
+    CHECK(strcmp(t.hms(), "--:--:--") == 0);
+
+    // Unset clock: still counts seconds, shows no time
+    fakeNow = 5;
+    t.update();
+    CHECK(!t.valid());
+    CHECK(strcmp(t.hms(), "--:--:--") == 0);
+
+    // Set by SNTP
+    seen = 0;
+    fakeNow = FALL_BACK + 3600 * 10 + 30;
+    t.update();
+    CHECK(t.valid());
+    CHECK_EQ(seen, TIME_SECOND | TIME_MINUTE | TIME_DAY | TIME_JUMP);
+    CHECK(strcmp(t.hms(), "12:00:30") == 0);
+
+    // A loop stalled for two seconds is not a jump
+    seen = 0;
+    fakeNow += 2;
+    t.update();
+    CHECK_EQ(seen, TIME_SECOND);
+    CHECK(strcmp(t.hms(), "12:00:32") == 0);
+
+    // Nothing happens within the same second
+    seen = 0;
+    t.update();
+    CHECK_EQ(seen, 0);
+
+    // Stepping back, even by a second, is
+    seen = 0;
+    fakeNow -= 1;
+    t.update();
+    CHECK(seen & TIME_JUMP);
+    CHECK(strcmp(t.hms(), "12:00:31") == 0);
+
+    // A time zone change forces a full conversion
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    t.invalidate();
+    t.update();
+    CHECK(strcmp(t.hms(), "11:00:31") == 0);
+    useFirmwareZone();
+}
+
+TEST(listenersAreBounded) {
+    TimeService t;
+    for (int i = 0; i < TimeService::MAX_LISTENERS; i++)
+        CHECK(t.subscribe(onTime, TIME_SECOND));
+    CHECK(!t.subscribe(onTime, TIME_SECOND));
+}
+
+CHECK_MAIN()
@@ -0,0 +1,115 @@
+// ToneSequencer against the recording LEDC stand-in: the note timeline,
+// frequency changes only when needed, and priority preemption.
+
+#include "Check.h"
+#include "Globals.h"
+#include "HostSim.h"
+#include "ToneSequencer.h"
+#include <vector>
+
+namespace {
+// Ticks the sequencer every 5 ms like the scheduler task does
+void runFor(ToneSequencer &t, uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i += 5) {
+        t.update();
+        Host::advanceMs(5);
+    }
+}
+
+std::vector<Host::LedcEvent> events(Host::LedcOp op) {
+    std::vector<Host::LedcEvent> out;
+    for (const Host::LedcEvent &e : Host::ledcLog())
+        if (e.op == op && e.channel == PWM::CH_BUZZ)
+            out.push_back(e);
+    return out;
+}
+
+ToneSequencer &fresh() {
+    static ToneSequencer t;
+    t.stop();
+    settings.speakerVol = 100;
+    Host::clearLedcLog();
+    return t;
+}
+} // namespace
+
+TEST(beginConfiguresTheChannelOnce) {
+    Host::clearLedcLog();
+    ToneSequencer t;
+    t.begin();
+    CHECK_EQ(events(Host::LEDC_SETUP).size(), 1);
+    CHECK_EQ(Host::ledcLog().size(), 3); // setup, attach, silence
+    t.play(2000, 50);
+    runFor(t, 100);
+    CHECK_EQ(events(Host::LEDC_SETUP).size(), 1);
+    CHECK_EQ(events(Host::LEDC_FREQ).size(), 0); // already at 2000 Hz
+}
+
+TEST(melodyTimeline) {
+    ToneSequencer &t = fresh();
+    uint32_t start = millis();
+    const Note melody[] = {{1000, 100, 100}, {0, 50, 100}, {1000, 100, 100},
+                           {1500, 40, 50}};
+    CHECK(t.play(melody, 4, TONE_NOTIFY));
+    runFor(t, 400);
+    CHECK(!t.busy());
+
+    // One retune to 1000 Hz, none for the repeat, one to 1500 Hz
+    std::vector<Host::LedcEvent> freq = events(Host::LEDC_FREQ);
+    CHECK_EQ(freq.size(), 2);
+    CHECK_EQ(freq[0].value, 1000);
+    CHECK_EQ(freq[1].value, 1500);
+
+    std::vector<Host::LedcEvent> duty = events(Host::LEDC_DUTY);
+    CHECK_EQ(duty.size(), 5);
+    const uint32_t at[] = {0, 100, 150, 250, 290};
+    const uint32_t value[] = {128, 0, 128, 64, 0};
+    for (size_t i = 0; i < duty.size() && i < 5; i++) {
+        CHECK_EQ(duty[i].ms - start, at[i]);
+        CHECK_EQ(duty[i].value, value[i]);
+    }
+}
+
+TEST(volumeScalesDuty) {
+    ToneSequencer &t = fresh();
+    settings.speakerVol = 50;
+    t.play(3000, 20);
+    runFor(t, 50);
+    std::vector<Host::LedcEvent> duty = events(Host::LEDC_DUTY);
+    CHECK(duty.size() >= 1);
+    CHECK_EQ(duty[0].value, 64);
+    settings.speakerVol = 0;
+    t.play(3000, 20);
+    CHECK_EQ(events(Host::LEDC_DUTY).back().value, 0);
+}
+
+TEST(higherPriorityPreempts) {
+    ToneSequencer &t = fresh();
+    t.play(4000, 80, TONE_ALERT);
+    runFor(t, 20);
+    // Less important sounds are dropped while the alert plays
+    CHECK(!t.play(1000, 500, TONE_UI));
+    CHECK_EQ(t.priority(), TONE_ALERT);
+    // The alarm replaces the rest of the alert at once
+    CHECK(t.play(2500, 0, TONE_ALARM));
+    CHECK_EQ(events(Host::LEDC_FREQ).back().value, 2500);
+    runFor(t, 1000);
+    CHECK(t.busy()); // held until stopped
+    t.stop();
+    CHECK(!t.busy());
+    CHECK_EQ(events(Host::LEDC_DUTY).back().value, 0);
+}
+
+TEST(samePriorityQueuesBehind) {
+    ToneSequencer &t = fresh();
+    uint32_t start = millis();
+    t.play(1000, 50, TONE_NOTIFY);
+    t.play(2000, 50, TONE_NOTIFY);
+    runFor(t, 200);
+    std::vector<Host::LedcEvent> freq = events(Host::LEDC_FREQ);
+    CHECK_EQ(freq.size(), 2);
+    CHECK_EQ(freq[1].value, 2000);
+    CHECK_EQ(freq[1].ms - start, 50);
+}
+
+CHECK_MAIN()